@@ -1,7 +1,7 @@
 // JSON filterkey example with SAX-style API.
 
 // This example parses JSON text from stdin with validation.
-// During parsing, specified key will be filtered using a SAX handler.
+// During parsing, the value of specified key is skipped by the reader on request of a SAX handler.
 // It re-output the JSON content to stdout without whitespace.
 
 #include "rapidjson/reader.h"
@@ -13,95 +13,57 @@
 
 using namespace rapidjson;
 
-// This handler forwards event into an output handler, with filtering the descendent events of specified key.
+// This handler forwards event into an output handler, and has the reader skip the value of the specified key.
 template <typename OutputHandler>
 class FilterKeyHandler {
 public:
     typedef char Ch;
 
     FilterKeyHandler(OutputHandler& outputHandler, const Ch* keyString, SizeType keyLength) : 
-        outputHandler_(outputHandler), keyString_(keyString), keyLength_(keyLength), filterValueDepth_(), filteredKeyCount_()
+        outputHandler_(outputHandler), keyString_(keyString), keyLength_(keyLength), filteredKeyCount_()
     {}
 
-    bool Null()             { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.Null()    && EndValue(); }
-    bool Bool(bool b)       { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.Bool(b)   && EndValue(); }
-    bool Int(int i)         { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.Int(i)    && EndValue(); }
-    bool Uint(unsigned u)   { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.Uint(u)   && EndValue(); }
-    bool Int64(int64_t i)   { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.Int64(i)  && EndValue(); }
-    bool Uint64(uint64_t u) { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.Uint64(u) && EndValue(); }
-    bool Double(double d)   { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.Double(d) && EndValue(); }
-    bool RawNumber(const Ch* str, SizeType len, bool copy) { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.RawNumber(str, len, copy) && EndValue(); }
-    bool String   (const Ch* str, SizeType len, bool copy) { return filterValueDepth_ > 0 ? EndValue() : outputHandler_.String   (str, len, copy) && EndValue(); }
+    bool Null()             { return outputHandler_.Null(); }
+    bool Bool(bool b)       { return outputHandler_.Bool(b); }
+    bool Int(int i)         { return outputHandler_.Int(i); }
+    bool Uint(unsigned u)   { return outputHandler_.Uint(u); }
+    bool Int64(int64_t i)   { return outputHandler_.Int64(i); }
+    bool Uint64(uint64_t u) { return outputHandler_.Uint64(u); }
+    bool Double(double d)   { return outputHandler_.Double(d); }
+    bool RawNumber(const Ch* str, SizeType len, bool copy) { return outputHandler_.RawNumber(str, len, copy); }
+    bool String   (const Ch* str, SizeType len, bool copy) { return outputHandler_.String   (str, len, copy); }
     
     bool StartObject() { 
-        if (filterValueDepth_ > 0) {
-            filterValueDepth_++;
-            return true;
-        }
-        else {
-            filteredKeyCount_.push(0);
-            return outputHandler_.StartObject();
-        }
+        filteredKeyCount_.push(0);
+        return outputHandler_.StartObject();
     }
     
-    bool Key(const Ch* str, SizeType len, bool copy) { 
-        if (filterValueDepth_ > 0) 
-            return true;
-        else if (len == keyLength_ && std::memcmp(str, keyString_, len) == 0) {
-            filterValueDepth_ = 1;
-            return true;
-        }
-        else {
-            ++filteredKeyCount_.top();
-            return outputHandler_.Key(str, len, copy);
-        }
-    }
+    HandlerResult Key(const Ch* str, SizeType len, bool copy) { 
+        // The reader skips the value without generating any event
+        if (len == keyLength_ && std::memcmp(str, keyString_, len) == 0)
+            return kHandlerSkipValue;
 
-    bool EndObject(SizeType) {
-        if (filterValueDepth_ > 0) {
-            filterValueDepth_--;
-            return EndValue();
-        }
-        else {
-            // Use our own filtered memberCount
-            SizeType memberCount = filteredKeyCount_.top();
-            filteredKeyCount_.pop();
-            return outputHandler_.EndObject(memberCount) && EndValue();
-        }
+        ++filteredKeyCount_.top();
+        return outputHandler_.Key(str, len, copy) ? kHandlerContinue : kHandlerAbort;
     }
 
-    bool StartArray() {
-        if (filterValueDepth_ > 0) {
-            filterValueDepth_++;
-            return true;
-        }
-        else
-            return outputHandler_.StartArray();
+    bool EndObject(SizeType) {
+        // Use our own filtered memberCount
+        SizeType memberCount = filteredKeyCount_.top();
+        filteredKeyCount_.pop();
+        return outputHandler_.EndObject(memberCount);
     }
 
-    bool EndArray(SizeType elementCount) {
-        if (filterValueDepth_ > 0) {
-            filterValueDepth_--;
-            return EndValue();
-        }
-        else
-            return outputHandler_.EndArray(elementCount) && EndValue();
-    }
+    bool StartArray()                    { return outputHandler_.StartArray(); }
+    bool EndArray(SizeType elementCount) { return outputHandler_.EndArray(elementCount); }
 
 private:
     FilterKeyHandler(const FilterKeyHandler&);
     FilterKeyHandler& operator=(const FilterKeyHandler&);
 
-    bool EndValue() {
-        if (filterValueDepth_ == 1) // Just at the end of value after filtered key
-            filterValueDepth_ = 0;
-        return true;
-    }
-    
     OutputHandler& outputHandler_;
     const char* keyString_;
     const SizeType keyLength_;
-    unsigned filterValueDepth_;
     std::stack<SizeType> filteredKeyCount_;
 };
 
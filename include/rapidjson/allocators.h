@@ -92,6 +92,42 @@ public:
     static void Free(void *ptr) { std::free(ptr); }
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// AllocatorStats
+
+//! Statistics of the memory allocated by an allocator.
+/*! MemoryPoolAllocator::GetStats() fills the usage and chunk fields, at no
+    cost for the allocations. InstrumentedAllocator counts each call too.
+    The fields which an allocator does not know are zero.
+*/
+struct AllocatorStats {
+    static const size_t kBucketCount = 16;  //!< Number of buckets of sizeHistogram.
+
+    size_t mallocCount;         //!< Number of calls of Malloc().
+    size_t reallocCount;        //!< Number of calls of Realloc() which resized a block.
+    size_t freeCount;           //!< Number of blocks freed.
+    size_t requestedBytes;      //!< Bytes requested in total, by Malloc() and by the growth of Realloc().
+    size_t usedBytes;           //!< Bytes of the blocks in use.
+    size_t peakUsedBytes;       //!< Maximum of usedBytes.
+    size_t reallocWasteBytes;   //!< Bytes of the blocks left behind by Realloc() when it moved them, and never freed.
+    size_t chunkCount;          //!< Number of chunks held, excluding a user buffer.
+    size_t chunkAllocations;    //!< Number of chunks allocated by the base allocator in total.
+    size_t reservedBytes;       //!< Capacity of the chunks held, including a user buffer.
+
+    //! Number of Malloc() and Realloc() calls by requested size.
+    /*! Bucket \c i counts the sizes up to <tt>8 << i</tt> bytes, and the last bucket the larger ones.
+    */
+    size_t sizeHistogram[kBucketCount];
+
+    //! Bucket of sizeHistogram for a size.
+    static size_t Bucket(size_t size) {
+        size_t bucket = 0;
+        while (bucket + 1 < kBucketCount && size > (static_cast<size_t>(8) << bucket))
+            bucket++;
+        return bucket;
+    }
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // MemoryPoolAllocator
 
@@ -121,7 +157,8 @@ public:
         \param baseAllocator The allocator for allocating memory chunks.
     */
     MemoryPoolAllocator(size_t chunkSize = kDefaultChunkCapacity, BaseAllocator* baseAllocator = 0) : 
-        chunkHead_(0), chunk_capacity_(chunkSize), userBuffer_(0), baseAllocator_(baseAllocator), ownBaseAllocator_(0)
+        chunkHead_(0), chunk_capacity_(chunkSize), userBuffer_(0), spareChunks_(0), baseAllocator_(baseAllocator), ownBaseAllocator_(0),
+        sizeAfterHead_(0), peakSize_(0), chunkCount_(0), chunkAllocations_(0), reservedBytes_(0), reallocWaste_(0)
     {
     }
 
@@ -136,7 +173,8 @@ public:
         \param baseAllocator The allocator for allocating memory chunks.
     */
     MemoryPoolAllocator(void *buffer, size_t size, size_t chunkSize = kDefaultChunkCapacity, BaseAllocator* baseAllocator = 0) :
-        chunkHead_(0), chunk_capacity_(chunkSize), userBuffer_(buffer), baseAllocator_(baseAllocator), ownBaseAllocator_(0)
+        chunkHead_(0), chunk_capacity_(chunkSize), userBuffer_(buffer), spareChunks_(0), baseAllocator_(baseAllocator), ownBaseAllocator_(0),
+        sizeAfterHead_(0), peakSize_(0), chunkCount_(0), chunkAllocations_(0), reservedBytes_(0), reallocWaste_(0)
     {
         RAPIDJSON_ASSERT(buffer != 0);
         RAPIDJSON_ASSERT(size > sizeof(ChunkHeader));
@@ -156,6 +194,7 @@ public:
 
     //! Deallocates all memory chunks, excluding the user-supplied buffer.
     void Clear() {
+        RecordPeak();
         while (chunkHead_ && chunkHead_ != userBuffer_) {
             ChunkHeader* next = chunkHead_->next;
             baseAllocator_->Free(chunkHead_);
@@ -163,26 +202,78 @@ public:
         }
         if (chunkHead_ && chunkHead_ == userBuffer_)
             chunkHead_->size = 0; // Clear user buffer
+        while (spareChunks_) {
+            ChunkHeader* next = spareChunks_->next;
+            baseAllocator_->Free(spareChunks_);
+            spareChunks_ = next;
+        }
+        sizeAfterHead_ = 0;
+        chunkCount_ = 0;
+        reservedBytes_ = 0;
+    }
+
+    //! Deallocates all memory blocks, but keeps the memory chunks for later allocations.
+    /*! Unlike Clear(), allocating again the same amount of memory, e.g. for
+        parsing the next document of similar size, does not allocate chunks
+        from the base allocator.
+        \param maxCapacity Total capacity in bytes of the chunks kept, excluding the user buffer.
+            The other chunks are deallocated.
+    */
+    void Reset(size_t maxCapacity = ~static_cast<size_t>(0)) {
+        RecordPeak();
+        while (chunkHead_ && chunkHead_ != userBuffer_) {
+            ChunkHeader* next = chunkHead_->next;
+            chunkHead_->next = spareChunks_;
+            spareChunks_ = chunkHead_;
+            chunkHead_ = next;
+        }
+        if (chunkHead_ && chunkHead_ == userBuffer_)
+            chunkHead_->size = 0; // Clear user buffer
+        sizeAfterHead_ = 0;
+
+        size_t capacity = 0;
+        for (ChunkHeader** c = &spareChunks_; *c != 0; ) {
+            if ((*c)->capacity <= maxCapacity - capacity) {
+                capacity += (*c)->capacity;
+                c = &(*c)->next;
+            }
+            else {
+                ChunkHeader* chunk = *c;
+                *c = chunk->next;
+                chunkCount_--;
+                reservedBytes_ -= chunk->capacity;
+                baseAllocator_->Free(chunk);
+            }
+        }
     }
 
     //! Computes the total capacity of allocated memory chunks.
     /*! \return total capacity in bytes.
     */
     size_t Capacity() const {
-        size_t capacity = 0;
-        for (ChunkHeader* c = chunkHead_; c != 0; c = c->next)
-            capacity += c->capacity;
-        return capacity;
+        return reservedBytes_ + (userBuffer_ ? reinterpret_cast<ChunkHeader*>(userBuffer_)->capacity : 0);
     }
 
     //! Computes the memory blocks allocated.
     /*! \return total used bytes.
     */
     size_t Size() const {
-        size_t size = 0;
-        for (ChunkHeader* c = chunkHead_; c != 0; c = c->next)
-            size += c->size;
-        return size;
+        return chunkHead_ ? sizeAfterHead_ + chunkHead_->size : 0;
+    }
+
+    //! Gets the statistics of the memory chunks.
+    /*! The call counts, requested bytes and size histogram are zero; see InstrumentedAllocator.
+        The peak usage is the maximum of Size(), and the waste of Realloc() is aligned.
+    */
+    AllocatorStats GetStats() const {
+        AllocatorStats stats = AllocatorStats();
+        stats.usedBytes = Size();
+        stats.peakUsedBytes = peakSize_ > stats.usedBytes ? peakSize_ : stats.usedBytes;
+        stats.reallocWasteBytes = reallocWaste_;
+        stats.chunkCount = chunkCount_;
+        stats.chunkAllocations = chunkAllocations_;
+        stats.reservedBytes = Capacity();
+        return stats;
     }
 
     //! Allocates a memory block. (concept Allocator)
@@ -228,6 +319,7 @@ public:
         if (void* newBuffer = Malloc(newSize)) {
             if (originalSize)
                 std::memcpy(newBuffer, originalPtr, originalSize);
+            reallocWaste_ += originalSize;
             return newBuffer;
         }
         else
@@ -237,6 +329,47 @@ public:
     //! Frees a memory block (concept Allocator)
     static void Free(void *ptr) { (void)ptr; } // Do nothing
 
+    //! Takes over the memory chunks of another allocator.
+    /*! The blocks allocated by \c rhs stay valid, and are freed with this
+        allocator. The chunks are freed by this base allocator, so the base
+        allocators must be interchangeable, e.g. CrtAllocator.
+        \param rhs Allocator without user buffer, which is left empty.
+    */
+    void AdoptChunks(MemoryPoolAllocator& rhs) {
+        RAPIDJSON_ASSERT(rhs.userBuffer_ == 0);
+        if (!rhs.chunkHead_)
+            return;
+        if (!baseAllocator_)
+            ownBaseAllocator_ = baseAllocator_ = RAPIDJSON_NEW(BaseAllocator)();
+
+        size_t count = 1, capacity = rhs.chunkHead_->capacity;
+        ChunkHeader* tail = rhs.chunkHead_;
+        while (tail->next) {
+            tail = tail->next;
+            count++;
+            capacity += tail->capacity;
+        }
+        rhs.RecordPeak();
+        chunkCount_ += count;
+        rhs.chunkCount_ -= count;
+        reservedBytes_ += capacity;
+        rhs.reservedBytes_ -= capacity;
+
+        // Keep allocating from the head chunk, and the user buffer last.
+        if (chunkHead_ && chunkHead_ != userBuffer_) {
+            tail->next = chunkHead_->next;
+            chunkHead_->next = rhs.chunkHead_;
+            sizeAfterHead_ += rhs.Size();
+        }
+        else {
+            tail->next = chunkHead_;
+            sizeAfterHead_ += rhs.sizeAfterHead_ + (chunkHead_ ? chunkHead_->size : 0);
+            chunkHead_ = rhs.chunkHead_;
+        }
+        rhs.chunkHead_ = 0;
+        rhs.sizeAfterHead_ = 0;
+    }
+
 private:
     //! Copy constructor is not permitted.
     MemoryPoolAllocator(const MemoryPoolAllocator& rhs) /* = delete */;
@@ -248,9 +381,26 @@ private:
         \return true if success.
     */
     bool AddChunk(size_t capacity) {
+        // Reuse a chunk kept by Reset(), if it is large enough.
+        for (ChunkHeader** c = &spareChunks_; *c != 0; c = &(*c)->next) {
+            if ((*c)->capacity >= capacity) {
+                ChunkHeader* chunk = *c;
+                *c = chunk->next;
+                sizeAfterHead_ += chunkHead_ ? chunkHead_->size : 0;
+                chunk->size = 0;
+                chunk->next = chunkHead_;
+                chunkHead_ = chunk;
+                return true;
+            }
+        }
+
         if (!baseAllocator_)
             ownBaseAllocator_ = baseAllocator_ = RAPIDJSON_NEW(BaseAllocator)();
         if (ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(baseAllocator_->Malloc(RAPIDJSON_ALIGN(sizeof(ChunkHeader)) + capacity))) {
+            sizeAfterHead_ += chunkHead_ ? chunkHead_->size : 0;
+            chunkCount_++;
+            chunkAllocations_++;
+            reservedBytes_ += capacity;
             chunk->capacity = capacity;
             chunk->size = 0;
             chunk->next = chunkHead_;
@@ -261,6 +411,13 @@ private:
             return false;
     }
 
+    //! Keeps the peak of Size() before the blocks are deallocated.
+    void RecordPeak() {
+        const size_t size = Size();
+        if (size > peakSize_)
+            peakSize_ = size;
+    }
+
     static const int kDefaultChunkCapacity = RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY; //!< Default chunk capacity.
 
     //! Chunk header for perpending to each chunk.
@@ -275,10 +432,472 @@ private:
     ChunkHeader *chunkHead_;    //!< Head of the chunk linked-list. Only the head chunk serves allocation.
     size_t chunk_capacity_;     //!< The minimum capacity of chunk when they are allocated.
     void *userBuffer_;          //!< User supplied buffer.
+    ChunkHeader *spareChunks_;  //!< Chunks kept by Reset() for reuse.
+    BaseAllocator* baseAllocator_;  //!< base allocator for allocating memory chunks.
+    BaseAllocator* ownBaseAllocator_;   //!< base allocator created by this object.
+    size_t sizeAfterHead_;      //!< Total size of the chunks after the head.
+    size_t peakSize_;           //!< Maximum of Size() before the last Reset() or Clear().
+    size_t chunkCount_;         //!< Number of chunks from the base allocator, in use or spare.
+    size_t chunkAllocations_;   //!< Number of chunks allocated by the base allocator in total.
+    size_t reservedBytes_;      //!< Total capacity of the chunks from the base allocator.
+    size_t reallocWaste_;       //!< Bytes left behind by Realloc().
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FreeListAllocator
+
+//! Memory allocator which reuses the freed memory blocks.
+/*! Like MemoryPoolAllocator, this allocator allocates memory blocks from
+    pre-allocated memory chunks. But a freed block is kept in the free list of
+    its size class, and reused by the next allocations of that class, so a DOM
+    which is modified again and again does not grow without bound.
+
+    Sizes are rounded up to a size class: 16, 24, 32, 48, 64, 96 bytes, and so
+    on up to kMaxClassSize. Larger blocks are allocated by BaseAllocator
+    directly, and freed when they are freed. Each block has a header with its
+    size class, as Free() is static.
+
+    \code
+    typedef GenericDocument<UTF8<>, FreeListAllocator<> > MutableDocument;
+    \endcode
+
+    The chunks are only deallocated by Clear() or the destructor.
+
+    \tparam BaseAllocator the allocator type for allocating memory chunks. Default is CrtAllocator.
+    \note implements Allocator concept
+*/
+template <typename BaseAllocator = CrtAllocator>
+class FreeListAllocator {
+public:
+    static const bool kNeedFree = true;     //!< Tell users that they should call Free() with this allocator. (concept Allocator)
+    static const size_t kMaxClassSize = 16384;  //!< Size of the largest size class, in bytes.
+
+    //! Constructor with chunkSize.
+    /*! \param chunkSize The size of memory chunk. The default is kDefaultChunkSize.
+        \param baseAllocator The allocator for allocating memory chunks.
+    */
+    FreeListAllocator(size_t chunkSize = kDefaultChunkCapacity, BaseAllocator* baseAllocator = 0) :
+        chunkHead_(0), chunk_capacity_(chunkSize), classes_(), large_(), baseAllocator_(baseAllocator), ownBaseAllocator_(0)
+    {
+        for (size_t i = 0; i < kClassCount; i++) {
+            classes_[i].head = 0;
+            classes_[i].size = ClassSize(i);
+            classes_[i].used = 0;
+        }
+        large_.prev = large_.next = &large_;
+        large_.size = 0;
+    }
+
+    //! Destructor.
+    /*! This deallocates all memory chunks and large blocks.
+    */
+    ~FreeListAllocator() {
+        Clear();
+        RAPIDJSON_DELETE(ownBaseAllocator_);
+    }
+
+    //! Deallocates all memory chunks and large blocks, including the blocks in use.
+    void Clear() {
+        while (chunkHead_) {
+            ChunkHeader* next = chunkHead_->next;
+            baseAllocator_->Free(chunkHead_);
+            chunkHead_ = next;
+        }
+        while (large_.next != &large_) {
+            LargeHeader* next = large_.next->next;
+            baseAllocator_->Free(large_.next);
+            large_.next = next;
+        }
+        large_.prev = &large_;
+        for (size_t i = 0; i < kClassCount; i++) {
+            classes_[i].head = 0;
+            classes_[i].used = 0;
+        }
+    }
+
+    //! Computes the total capacity of allocated memory chunks and large blocks.
+    /*! \return total capacity in bytes.
+    */
+    size_t Capacity() const {
+        size_t capacity = 0;
+        for (ChunkHeader* c = chunkHead_; c != 0; c = c->next)
+            capacity += c->capacity;
+        for (LargeHeader* l = large_.next; l != &large_; l = l->next)
+            capacity += l->size;
+        return capacity;
+    }
+
+    //! Computes the memory blocks in use, rounded up to their size classes.
+    /*! \return total used bytes, excluding the headers and the free blocks.
+    */
+    size_t Size() const {
+        size_t size = 0;
+        for (size_t i = 0; i < kClassCount; i++)
+            size += classes_[i].used * classes_[i].size;
+        for (LargeHeader* l = large_.next; l != &large_; l = l->next)
+            size += l->size;
+        return size;
+    }
+
+    //! Allocates a memory block. (concept Allocator)
+    void* Malloc(size_t size) {
+        if (!size)
+            return NULL;
+        if (size > kMaxClassSize)
+            return LargeMalloc(size);
+
+        SizeClass& c = classes_[ClassIndex(size)];
+        void* buffer;
+        if (c.head) {
+            buffer = c.head;
+            c.head = c.head->next;
+        }
+        else if (!(buffer = Carve(c)))
+            return NULL;
+        c.used++;
+        return buffer;
+    }
+
+    //! Resizes a memory block (concept Allocator)
+    void* Realloc(void* originalPtr, size_t originalSize, size_t newSize) {
+        if (originalPtr == 0)
+            return Malloc(newSize);
+
+        if (newSize == 0) {
+            Free(originalPtr);
+            return NULL;
+        }
+
+        // Keep the block if the new size is of the same size class
+        if (SizeClass* c = GetSizeClass(originalPtr)) {
+            if (newSize <= kMaxClassSize && c == &classes_[ClassIndex(newSize)])
+                return originalPtr;
+        }
+        else if (newSize > kMaxClassSize)
+            return LargeRealloc(originalPtr, newSize);
+
+        if (void* newBuffer = Malloc(newSize)) {
+            std::memcpy(newBuffer, originalPtr, originalSize < newSize ? originalSize : newSize);
+            Free(originalPtr);
+            return newBuffer;
+        }
+        else
+            return NULL;
+    }
+
+    //! Frees a memory block (concept Allocator)
+    static void Free(void *ptr) {
+        if (!ptr)
+            return;
+        if (SizeClass* c = GetSizeClass(ptr)) {
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->next = c->head;
+            c->head = block;
+            c->used--;
+        }
+        else {
+            LargeHeader* l = GetLargeHeader(ptr);
+            l->prev->next = l->next;
+            l->next->prev = l->prev;
+            BaseAllocator::Free(l);
+        }
+    }
+
+private:
+    //! Copy constructor is not permitted.
+    FreeListAllocator(const FreeListAllocator& rhs) /* = delete */;
+    //! Copy assignment operator is not permitted.
+    FreeListAllocator& operator=(const FreeListAllocator& rhs) /* = delete */;
+
+    static const int kDefaultChunkCapacity = RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY; //!< Default chunk capacity.
+    static const size_t kMinClassSize = 16;
+    static const size_t kClassCount = 21;   //!< Two size classes per power of two, from kMinClassSize to kMaxClassSize.
+    static const size_t kHeaderSize = RAPIDJSON_ALIGN(sizeof(void*));
+
+    struct ChunkHeader {
+        size_t capacity;    //!< Capacity of the chunk in bytes (excluding the header itself).
+        size_t size;        //!< Current size of carved memory in bytes.
+        ChunkHeader *next;  //!< Next chunk in the linked list.
+    };
+
+    //! A freed block, linked in the free list of its size class.
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct SizeClass {
+        FreeBlock* head;    //!< Free list.
+        size_t size;        //!< Size of the blocks in bytes (excluding the header).
+        size_t used;        //!< Number of blocks in use.
+    };
+
+    //! Header of a block larger than kMaxClassSize, in a doubly linked list.
+    struct LargeHeader {
+        LargeHeader* prev;
+        LargeHeader* next;
+        size_t size;
+    };
+
+    static size_t ClassSize(size_t index) {
+        // Classes are 2^k and 1.5 * 2^k
+        return (index & 1) ? (static_cast<size_t>(3) << (3 + index / 2)) : (kMinClassSize << (index / 2));
+    }
+
+    static size_t ClassIndex(size_t size) {
+        if (size <= kMinClassSize)
+            return 0;
+        const size_t n = size - 1;
+        size_t k = 4;
+        while (n >> (k + 1))
+            k++;
+        // 2^k <= n < 2^(k+1), in the class of 1.5 * 2^k or of 2^(k+1)
+        return (k - 4) * 2 + 1 + ((n >> (k - 1)) & 1);
+    }
+
+    //! The size class in the header of a block, or null for a large block.
+    static SizeClass* GetSizeClass(void* ptr) {
+        return *reinterpret_cast<SizeClass**>(static_cast<char*>(ptr) - kHeaderSize);
+    }
+
+    static LargeHeader* GetLargeHeader(void* ptr) {
+        return reinterpret_cast<LargeHeader*>(static_cast<char*>(ptr) - kHeaderSize - RAPIDJSON_ALIGN(sizeof(LargeHeader)));
+    }
+
+    //! Carves a new block of a size class from the head chunk.
+    void* Carve(SizeClass& c) {
+        const size_t blockSize = kHeaderSize + c.size;
+        if (chunkHead_ == 0 || chunkHead_->size + blockSize > chunkHead_->capacity) {
+            if (chunkHead_)
+                FreeRest();
+            if (!AddChunk(chunk_capacity_ > blockSize ? chunk_capacity_ : blockSize))
+                return NULL;
+        }
+        char* block = reinterpret_cast<char*>(chunkHead_) + RAPIDJSON_ALIGN(sizeof(ChunkHeader)) + chunkHead_->size;
+        chunkHead_->size += blockSize;
+        *reinterpret_cast<SizeClass**>(block) = &c;
+        return block + kHeaderSize;
+    }
+
+    //! Splits the rest of the head chunk into free blocks, before adding a chunk.
+    void FreeRest() {
+        while (chunkHead_->capacity - chunkHead_->size >= kHeaderSize + kMinClassSize) {
+            const size_t rest = chunkHead_->capacity - chunkHead_->size - kHeaderSize;
+            size_t index = rest < kMaxClassSize ? ClassIndex(rest) : kClassCount - 1;
+            if (classes_[index].size > rest)
+                index--;
+            SizeClass& c = classes_[index];
+            void* block = Carve(c);
+            c.used++;
+            Free(block);
+        }
+    }
+
+    //! Creates a new chunk.
+    /*! \param capacity Capacity of the chunk in bytes.
+        \return true if success.
+    */
+    bool AddChunk(size_t capacity) {
+        if (!baseAllocator_)
+            ownBaseAllocator_ = baseAllocator_ = RAPIDJSON_NEW(BaseAllocator)();
+        if (ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(baseAllocator_->Malloc(RAPIDJSON_ALIGN(sizeof(ChunkHeader)) + capacity))) {
+            chunk->capacity = capacity;
+            chunk->size = 0;
+            chunk->next = chunkHead_;
+            chunkHead_ = chunk;
+            return true;
+        }
+        else
+            return false;
+    }
+
+    void* LargeMalloc(size_t size) {
+        if (!baseAllocator_)
+            ownBaseAllocator_ = baseAllocator_ = RAPIDJSON_NEW(BaseAllocator)();
+        char* p = static_cast<char*>(baseAllocator_->Malloc(RAPIDJSON_ALIGN(sizeof(LargeHeader)) + kHeaderSize + size));
+        if (!p)
+            return NULL;
+        LargeHeader* l = reinterpret_cast<LargeHeader*>(p);
+        l->size = size;
+        l->prev = &large_;
+        l->next = large_.next;
+        large_.next->prev = l;
+        large_.next = l;
+        p += RAPIDJSON_ALIGN(sizeof(LargeHeader));
+        *reinterpret_cast<SizeClass**>(p) = 0;
+        return p + kHeaderSize;
+    }
+
+    void* LargeRealloc(void* ptr, size_t size) {
+        LargeHeader* l = GetLargeHeader(ptr);
+        const size_t headerSize = RAPIDJSON_ALIGN(sizeof(LargeHeader)) + kHeaderSize;
+        char* p = static_cast<char*>(baseAllocator_->Realloc(l, headerSize + l->size, headerSize + size));
+        if (!p)
+            return NULL;
+        l = reinterpret_cast<LargeHeader*>(p);
+        l->size = size;
+        l->prev->next = l;
+        l->next->prev = l;
+        return p + headerSize;
+    }
+
+    ChunkHeader *chunkHead_;    //!< Head of the chunk linked-list. Only the head chunk serves new blocks.
+    size_t chunk_capacity_;     //!< The minimum capacity of chunk when they are allocated.
+    SizeClass classes_[kClassCount];
+    LargeHeader large_;         //!< Sentinel of the large blocks.
     BaseAllocator* baseAllocator_;  //!< base allocator for allocating memory chunks.
     BaseAllocator* ownBaseAllocator_;   //!< base allocator created by this object.
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// InstrumentedAllocator
+
+//! Allocator which records the statistics of the calls to another allocator.
+/*! It forwards the calls to BaseAllocator, and counts the calls, the bytes
+    requested and in use, the waste of Realloc(), and the sizes requested:
+
+    \code
+    GenericDocument<UTF8<>, InstrumentedAllocator<> > d;
+    d.Parse(json);
+    AllocatorStats stats = d.GetAllocator().GetStats();
+    \endcode
+
+    The usage is in requested bytes. The chunk fields are those of a
+    MemoryPoolAllocator base. When BaseAllocator needs Free(), each block has
+    a header with its size.
+
+    \tparam BaseAllocator the allocator to instrument. Default is MemoryPoolAllocator<>.
+    \note implements Allocator concept
+*/
+template <typename BaseAllocator = MemoryPoolAllocator<> >
+class InstrumentedAllocator {
+public:
+    static const bool kNeedFree = BaseAllocator::kNeedFree;   //!< Same as the base allocator. (concept Allocator)
+
+    //! Constructor.
+    /*! \param baseAllocator The allocator to instrument. A new one is created by default.
+    */
+    InstrumentedAllocator(BaseAllocator* baseAllocator = 0) : baseAllocator_(baseAllocator), ownBaseAllocator_(0), stats_() {
+        if (!baseAllocator_)
+            ownBaseAllocator_ = baseAllocator_ = RAPIDJSON_NEW(BaseAllocator)();
+    }
+
+    //! Destructor.
+    ~InstrumentedAllocator() {
+        RAPIDJSON_DELETE(ownBaseAllocator_);
+    }
+
+    //! Gets the statistics since construction or ResetStats().
+    AllocatorStats GetStats() const {
+        AllocatorStats stats = stats_;
+        AddBaseStats(stats, *baseAllocator_);
+        return stats;
+    }
+
+    //! Resets the counters, and the peak usage to the current usage.
+    void ResetStats() {
+        const size_t used = stats_.usedBytes;
+        stats_ = AllocatorStats();
+        stats_.usedBytes = stats_.peakUsedBytes = used;
+    }
+
+    //! Gets the instrumented allocator.
+    BaseAllocator& GetBaseAllocator() const { return *baseAllocator_; }
+
+    //! Allocates a memory block. (concept Allocator)
+    void* Malloc(size_t size) {
+        if (!size)
+            return NULL;
+        char* p = static_cast<char*>(baseAllocator_->Malloc(kHeaderSize + size));
+        if (!p)
+            return NULL;
+        stats_.mallocCount++;
+        Request(size, size);
+        Use(size);
+        return Attach(p, size);
+    }
+
+    //! Resizes a memory block (concept Allocator)
+    void* Realloc(void* originalPtr, size_t originalSize, size_t newSize) {
+        if (originalPtr == 0)
+            return Malloc(newSize);
+
+        if (newSize == 0) {
+            Free(originalPtr);
+            return NULL;
+        }
+
+        char* p = static_cast<char*>(baseAllocator_->Realloc(static_cast<char*>(originalPtr) - kHeaderSize, kHeaderSize + originalSize, kHeaderSize + newSize));
+        if (!p)
+            return NULL;
+        stats_.reallocCount++;
+        Request(newSize, newSize > originalSize ? newSize - originalSize : 0);
+        if (!kNeedFree && p + kHeaderSize != originalPtr)
+            stats_.reallocWasteBytes += originalSize;
+        stats_.usedBytes -= originalSize;
+        Use(newSize);
+        return Attach(p, newSize);
+    }
+
+    //! Frees a memory block (concept Allocator)
+    static void Free(void *ptr) {
+        if (!ptr || !kNeedFree)
+            return;
+        Header* header = reinterpret_cast<Header*>(static_cast<char*>(ptr) - kHeaderSize);
+        AllocatorStats& stats = header->allocator->stats_;
+        stats.freeCount++;
+        stats.usedBytes -= header->size;
+        BaseAllocator::Free(header);
+    }
+
+private:
+    //! Copy constructor is not permitted.
+    InstrumentedAllocator(const InstrumentedAllocator& rhs) /* = delete */;
+    //! Copy assignment operator is not permitted.
+    InstrumentedAllocator& operator=(const InstrumentedAllocator& rhs) /* = delete */;
+
+    struct Header {
+        InstrumentedAllocator* allocator;
+        size_t size;
+    };
+
+    static const size_t kHeaderSize = kNeedFree ? RAPIDJSON_ALIGN(sizeof(Header)) : 0;
+
+    void Request(size_t size, size_t growth) {
+        stats_.requestedBytes += growth;
+        stats_.sizeHistogram[AllocatorStats::Bucket(size)]++;
+    }
+
+    void Use(size_t size) {
+        stats_.usedBytes += size;
+        if (stats_.usedBytes > stats_.peakUsedBytes)
+            stats_.peakUsedBytes = stats_.usedBytes;
+    }
+
+    void* Attach(char* p, size_t size) {
+        if (kNeedFree) {
+            Header* header = reinterpret_cast<Header*>(p);
+            header->allocator = this;
+            header->size = size;
+        }
+        return p + kHeaderSize;
+    }
+
+    template <typename Allocator>
+    static void AddBaseStats(AllocatorStats&, const Allocator&) {}
+
+    template <typename Allocator>
+    static void AddBaseStats(AllocatorStats& stats, const MemoryPoolAllocator<Allocator>& base) {
+        const AllocatorStats baseStats = base.GetStats();
+        stats.chunkCount = baseStats.chunkCount;
+        stats.chunkAllocations = baseStats.chunkAllocations;
+        stats.reservedBytes = baseStats.reservedBytes;
+    }
+
+    BaseAllocator* baseAllocator_;      //!< The instrumented allocator.
+    BaseAllocator* ownBaseAllocator_;   //!< base allocator created by this object.
+    AllocatorStats stats_;
+};
+
 RAPIDJSON_NAMESPACE_END
 
 #endif // RAPIDJSON_ENCODINGS_H_
@@ -0,0 +1,272 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_CHUNKPOOL_H_
+#define RAPIDJSON_CHUNKPOOL_H_
+
+/*! \file chunkpool.h */
+
+#include "allocators.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+//! Statistics of a ChunkPool.
+struct ChunkPoolStats {
+    size_t hits;        //!< Blocks taken from the pool.
+    size_t misses;      //!< Blocks of the pooled size allocated with malloc(), as the pool was empty.
+    size_t returns;     //!< Blocks given back to the pool.
+    size_t releases;    //!< Blocks of the pooled size freed with free(), as the pool was full.
+    size_t cached;      //!< Blocks in the pool now.
+};
+
+//! Thread-safe pool of memory blocks of one size, shared by allocators on many threads.
+/*! The pool keeps freed blocks of up to \c blockSize bytes (and more than
+    half of it) for the next allocations, such as the chunks of
+    MemoryPoolAllocator. It is split in shards, each with its own lock, and a
+    thread uses the shard of its id, so threads rarely wait for each other.
+    When its shard is empty, a thread takes a block from another shard which is
+    not locked, before falling back to malloc().
+
+    Use it through ChunkPoolAllocator.
+*/
+class ChunkPool {
+public:
+    static const size_t kDefaultBlockSize = RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY + 64;   //!< A chunk of MemoryPoolAllocator with its header.
+    static const size_t kDefaultMaxBlocks = 1024;
+
+    //! Constructor.
+    /*! \param blockSize Size of the blocks, in bytes.
+        \param maxBlocks Maximum number of blocks kept in the pool.
+        \param shardCount Number of shards. 0 for one per hardware thread.
+    */
+    explicit ChunkPool(size_t blockSize = kDefaultBlockSize, size_t maxBlocks = kDefaultMaxBlocks, unsigned shardCount = 0) :
+        shards_(shardCount ? shardCount : (std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1)),
+        blockSize_(blockSize), maxBlocksPerShard_(0), hits_(0), misses_(0), returns_(0), releases_(0)
+    {
+        maxBlocksPerShard_ = maxBlocks / shards_.size() ? maxBlocks / shards_.size() : 1;
+    }
+
+    //! Destructor. Blocks still in use must not be freed after it.
+    ~ChunkPool() { Trim(); }
+
+    //! Size of the pooled blocks, in bytes.
+    size_t GetBlockSize() const { return blockSize_; }
+
+    //! Frees all the blocks kept in the pool.
+    void Trim() {
+        for (size_t i = 0; i < shards_.size(); i++) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            while (Block* block = shards_[i].head) {
+                shards_[i].head = block->next;
+                std::free(block);
+            }
+            shards_[i].count = 0;
+        }
+    }
+
+    //! Get the statistics since construction.
+    ChunkPoolStats GetStats() const {
+        ChunkPoolStats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.returns = returns_.load(std::memory_order_relaxed);
+        stats.releases = releases_.load(std::memory_order_relaxed);
+        stats.cached = 0;
+        for (size_t i = 0; i < shards_.size(); i++) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            stats.cached += shards_[i].count;
+        }
+        return stats;
+    }
+
+    //! The pool used by default by ChunkPoolAllocator.
+    /*! It is never destroyed, so that static documents can still free their blocks at exit.
+    */
+    static ChunkPool& Global() {
+        static ChunkPool* pool = new ChunkPool;
+        return *pool;
+    }
+
+    //! Allocates a memory block, with the pool address in front of it.
+    void* Malloc(size_t size) {
+        if (size > blockSize_ || size <= blockSize_ / 2)
+            return Attach(std::malloc(kHeaderSize + size), 0);
+
+        const size_t index = ShardIndex();
+        for (size_t i = 0; i < shards_.size(); i++) {
+            Shard& shard = shards_[(index + i) % shards_.size()];
+            std::unique_lock<std::mutex> lock(shard.mutex, std::defer_lock);
+            if (i == 0)
+                lock.lock();
+            else if (!lock.try_lock())
+                continue;
+            if (Block* block = shard.head) {
+                shard.head = block->next;
+                shard.count--;
+                lock.unlock();
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return Attach(block, this);
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return Attach(std::malloc(kHeaderSize + blockSize_), this);
+    }
+
+    //! Frees a memory block allocated by Malloc() of any pool.
+    static void Free(void* ptr) {
+        if (!ptr)
+            return;
+        void* block = static_cast<char*>(ptr) - kHeaderSize;
+        ChunkPool* pool = *static_cast<ChunkPool**>(block);
+        if (pool)
+            pool->Put(block);
+        else
+            std::free(block);
+    }
+
+    //! Whether a memory block allocated by Malloc() is pooled, with room for size bytes.
+    static bool Fits(const void* ptr, size_t size) {
+        const ChunkPool* pool = *static_cast<ChunkPool* const*>(static_cast<const void*>(static_cast<const char*>(ptr) - kHeaderSize));
+        return pool && size <= pool->blockSize_;
+    }
+
+private:
+    // Prohibit copy constructor & assignment operator.
+    ChunkPool(const ChunkPool&);
+    ChunkPool& operator=(const ChunkPool&);
+
+    struct Block {
+        Block* next;
+    };
+
+    struct Shard {
+        Shard() : mutex(), head(0), count(0) {}
+        mutable std::mutex mutex;
+        Block* head;
+        size_t count;
+        char padding[64];   //!< Keeps the shards on separate cache lines.
+    };
+
+    size_t ShardIndex() const {
+        return std::hash<std::thread::id>()(std::this_thread::get_id()) % shards_.size();
+    }
+
+    static void* Attach(void* block, ChunkPool* pool) {
+        if (!block)
+            return 0;
+        *static_cast<ChunkPool**>(block) = pool;
+        return static_cast<char*>(block) + kHeaderSize;
+    }
+
+    void Put(void* block) {
+        Shard& shard = shards_[ShardIndex()];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.count < maxBlocksPerShard_) {
+                Block* b = static_cast<Block*>(block);
+                b->next = shard.head;
+                shard.head = b;
+                shard.count++;
+                returns_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        releases_.fetch_add(1, std::memory_order_relaxed);
+        std::free(block);
+    }
+
+    static const size_t kHeaderSize = RAPIDJSON_ALIGN(sizeof(ChunkPool*));
+
+    std::vector<Shard> shards_;
+    size_t blockSize_;
+    size_t maxBlocksPerShard_;
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+    std::atomic<size_t> returns_;
+    std::atomic<size_t> releases_;
+};
+
+//! Allocator which takes blocks from a ChunkPool, shared by many threads.
+/*! Intended as the base allocator of MemoryPoolAllocator, so that documents
+    created and destroyed on many threads reuse the chunks of each other,
+    instead of all calling malloc() and free():
+
+    \code
+    typedef GenericDocument<UTF8<>, MemoryPoolAllocator<ChunkPoolAllocator> > PooledDocument;
+    \endcode
+
+    Blocks which are not about the pool's block size are allocated by malloc().
+    \note implements Allocator concept
+*/
+class ChunkPoolAllocator {
+public:
+    static const bool kNeedFree = true;
+
+    //! Constructor.
+    /*! \param pool Pool of the blocks, which must outlive them. The global pool by default.
+    */
+    ChunkPoolAllocator(ChunkPool* pool = 0) : pool_(pool ? pool : &ChunkPool::Global()) {}
+
+    void* Malloc(size_t size) {
+        if (size) //  behavior of malloc(0) is implementation defined.
+            return pool_->Malloc(size);
+        else
+            return NULL; // standardize to returning NULL.
+    }
+    void* Realloc(void* originalPtr, size_t originalSize, size_t newSize) {
+        if (newSize == 0) {
+            Free(originalPtr);
+            return NULL;
+        }
+        if (originalPtr && ChunkPool::Fits(originalPtr, newSize))
+            return originalPtr;
+        void* newPtr = Malloc(newSize);
+        if (!newPtr)
+            return NULL;    // The original block is kept, as by realloc().
+        if (originalPtr)
+            std::memcpy(newPtr, originalPtr, originalSize < newSize ? originalSize : newSize);
+        Free(originalPtr);
+        return newPtr;
+    }
+    static void Free(void *ptr) { ChunkPool::Free(ptr); }
+
+    //! Get the pool of the blocks.
+    ChunkPool& GetPool() const { return *pool_; }
+
+private:
+    ChunkPool* pool_;
+};
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // RAPIDJSON_CHUNKPOOL_H_
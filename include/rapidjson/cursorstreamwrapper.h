@@ -16,6 +16,8 @@
 #define RAPIDJSON_CURSORSTREAMWRAPPER_H_
 
 #include "stream.h"
+#include "memorystream.h"
+#include <cstring>
 
 #if defined(__GNUC__)
 RAPIDJSON_DIAG_PUSH
@@ -65,6 +67,96 @@ private:
     size_t col_;    //!< Current Column
 };
 
+namespace internal {
+
+// Start of the text read by an in-memory stream, where Tell() is 0.
+template <typename Encoding>
+inline const typename Encoding::Ch* CursorText(const GenericStringStream<Encoding>& is) { return is.head_; }
+
+inline const char* CursorText(const MemoryStream& is) { return is.begin_; }
+
+// Finds the first new line in [p, end), or returns end.
+template <typename Ch>
+inline const Ch* FindNewLine(const Ch* p, const Ch* end) {
+    while (p != end && *p != '\n')
+        ++p;
+    return p;
+}
+
+inline const char* FindNewLine(const char* p, const char* end) {
+    const void* q = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return q ? static_cast<const char*>(q) : end;
+}
+
+} // namespace internal
+
+//! Cursor stream wrapper which finds the line and column number only when asked.
+/*!
+    Unlike CursorStreamWrapper, nothing is counted while parsing: the reader
+    parses the wrapped stream itself, with all its optimizations. GetLine() and
+    GetColumn() count the new lines of the text before Tell(), which is the
+    error offset after a parse error, with memchr() for bytes. The count goes on
+    from the previous call, so asking repeatedly while parsing forward does not
+    scan the text again.
+
+    \code
+    StringStream ss(json);
+    LazyCursorStreamWrapper<StringStream> csw(ss);
+    Document d;
+    if (d.ParseStream(csw).HasParseError())
+        printf("Error at line %u, column %u\n", unsigned(csw.GetLine()), unsigned(csw.GetColumn()));
+    \endcode
+
+    \tparam InputStream A stream over text in memory: GenericStringStream (and
+        streams derived from it, such as MmapReadStream) or MemoryStream. Use
+        CursorStreamWrapper for other streams.
+    \note An insitu stream is not supported, as parsing overwrites the text.
+*/
+template <typename InputStream, typename Encoding = UTF8<> >
+class LazyCursorStreamWrapper : public GenericStreamWrapper<InputStream, Encoding> {
+public:
+    typedef typename Encoding::Ch Ch;
+
+    LazyCursorStreamWrapper(InputStream& is):
+        GenericStreamWrapper<InputStream, Encoding>(is), text_(internal::CursorText(is)), offset_(0), line_(1), lineStart_(0) {}
+
+    //! Get the line number of the current position, the error position after a parse error.
+    size_t GetLine() const { Locate(); return line_; }
+    //! Get the column number of the current position, the error position after a parse error.
+    size_t GetColumn() const { Locate(); return offset_ - lineStart_; }
+
+    //! Get the wrapped stream.
+    InputStream& GetStream() const { return this->is_; }
+
+private:
+    // Counts the new lines from the last located offset to Tell().
+    void Locate() const {
+        const size_t offset = this->is_.Tell();
+        if (offset < offset_) {
+            offset_ = lineStart_ = 0;
+            line_ = 1;
+        }
+        const Ch* end = text_ + offset;
+        for (const Ch* p = internal::FindNewLine(text_ + offset_, end); p != end; p = internal::FindNewLine(p + 1, end)) {
+            line_++;
+            lineStart_ = static_cast<size_t>(p + 1 - text_);
+        }
+        offset_ = offset;
+    }
+
+    const Ch* text_;            //!< Start of the text, where Tell() is 0.
+    mutable size_t offset_;     //!< Offset of the last located position.
+    mutable size_t line_;       //!< Line of the last located position.
+    mutable size_t lineStart_;  //!< Offset of the start of that line.
+};
+
+//! The reader parses a LazyCursorStreamWrapper as the stream it wraps.
+template <typename InputStream, typename Encoding>
+struct StreamParsedAs<LazyCursorStreamWrapper<InputStream, Encoding> > {
+    typedef typename StreamParsedAs<InputStream>::Type Type;
+    static Type& Get(LazyCursorStreamWrapper<InputStream, Encoding>& stream) { return StreamParsedAs<InputStream>::Get(stream.GetStream()); }
+};
+
 #if defined(_MSC_VER) && _MSC_VER <= 1800
 RAPIDJSON_DIAG_POP
 #endif
@@ -47,6 +47,38 @@ RAPIDJSON_DIAG_OFF(effc++)
 #include <utility> // std::move
 #endif
 
+#if RAPIDJSON_HAS_CXX11_THREADS
+#include <thread>
+#include <vector>
+#endif
+
+/*! \def RAPIDJSON_MEMBER_INDEX
+    \ingroup RAPIDJSON_CONFIG
+    \brief Enable a hash index for member lookup in large objects.
+
+    Define this to 1 to make GenericValue::FindMember() and every lookup based on
+    it run in constant time on average for objects of at least
+    \ref RAPIDJSON_MEMBER_INDEX_THRESHOLD members. The index lives in the same
+    allocation as the members, after them, and is built by the first lookup;
+    member order and the API are unchanged.
+
+    \note With the index, the first lookup in a large object writes to it even
+        through a const value, so concurrent lookups in the same document need
+        to be serialized. Member names must not be modified, nor members
+        reordered, through member iterators.
+*/
+#ifndef RAPIDJSON_MEMBER_INDEX
+#define RAPIDJSON_MEMBER_INDEX 0
+#endif
+
+/*! \def RAPIDJSON_MEMBER_INDEX_THRESHOLD
+    \ingroup RAPIDJSON_CONFIG
+    \brief Smallest object capacity that gets a member index, see \ref RAPIDJSON_MEMBER_INDEX.
+*/
+#ifndef RAPIDJSON_MEMBER_INDEX_THRESHOLD
+#define RAPIDJSON_MEMBER_INDEX_THRESHOLD 32
+#endif
+
 RAPIDJSON_NAMESPACE_BEGIN
 
 // Forward declaration.
@@ -647,7 +679,7 @@ public:
         switch (rhs.GetType()) {
         case kObjectType: {
                 SizeType count = rhs.data_.o.size;
-                Member* lm = reinterpret_cast<Member*>(allocator.Malloc(count * sizeof(Member)));
+                Member* lm = reinterpret_cast<Member*>(allocator.Malloc(MembersSize(count)));
                 const typename GenericValue<Encoding,SourceAllocator>::Member* rm = rhs.GetMembersPointer();
                 for (SizeType i = 0; i < count; i++) {
                     new (&lm[i].name) GenericValue(rm[i].name, allocator, copyConstStrings);
@@ -656,6 +688,7 @@ public:
                 data_.f.flags = kObjectFlag;
                 data_.o.size = data_.o.capacity = count;
                 SetMembersPointer(lm);
+                ResetMemberIndex();
             }
             break;
         case kArrayType: {
@@ -1172,8 +1205,9 @@ public:
     GenericValue& MemberReserve(SizeType newCapacity, Allocator &allocator) {
         RAPIDJSON_ASSERT(IsObject());
         if (newCapacity > data_.o.capacity) {
-            SetMembersPointer(reinterpret_cast<Member*>(allocator.Realloc(GetMembersPointer(), data_.o.capacity * sizeof(Member), newCapacity * sizeof(Member))));
+            SetMembersPointer(reinterpret_cast<Member*>(allocator.Realloc(GetMembersPointer(), MembersSize(data_.o.capacity), MembersSize(newCapacity))));
             data_.o.capacity = newCapacity;
+            ResetMemberIndex();
         }
         return *this;
     }
@@ -1242,12 +1276,16 @@ public:
         \note Earlier versions of Rapidjson returned a \c NULL pointer, in case
             the requested member doesn't exist. For consistency with e.g.
             \c std::map, this has been changed to MemberEnd() now.
-        \note Linear time complexity.
+        \note Linear time complexity, or constant on average for large objects with \ref RAPIDJSON_MEMBER_INDEX.
     */
     template <typename SourceAllocator>
     MemberIterator FindMember(const GenericValue<Encoding, SourceAllocator>& name) {
         RAPIDJSON_ASSERT(IsObject());
         RAPIDJSON_ASSERT(name.IsString());
+#if RAPIDJSON_MEMBER_INDEX
+        if (data_.o.size >= RAPIDJSON_MEMBER_INDEX_THRESHOLD)
+            return FindIndexedMember(name);
+#endif
         MemberIterator member = MemberBegin();
         for ( ; member != MemberEnd(); ++member)
             if (name.StringEqual(member->name))
@@ -1425,6 +1463,7 @@ public:
         for (MemberIterator m = MemberBegin(); m != MemberEnd(); ++m)
             m->~Member();
         data_.o.size = 0;
+        ResetMemberIndex();
     }
 
     //! Remove a member in object by its name.
@@ -1475,6 +1514,7 @@ public:
         else
             m->~Member(); // Only one left, just destroy
         --data_.o.size;
+        ResetMemberIndex();
         return m;
     }
 
@@ -1513,6 +1553,7 @@ public:
             itr->~Member();
         std::memmove(static_cast<void*>(&*pos), &*last, static_cast<size_t>(MemberEnd() - last) * sizeof(Member));
         data_.o.size -= static_cast<SizeType>(last - first);
+        ResetMemberIndex();
         return pos;
     }
 
@@ -2024,6 +2065,74 @@ private:
     RAPIDJSON_FORCEINLINE Member* GetMembersPointer() const { return RAPIDJSON_GETPOINTER(Member, data_.o.members); }
     RAPIDJSON_FORCEINLINE Member* SetMembersPointer(Member* members) { return RAPIDJSON_SETPOINTER(Member, data_.o.members, members); }
 
+#if RAPIDJSON_MEMBER_INDEX
+    // Open-addressing hash table of member positions, after the members of objects with capacity >= RAPIDJSON_MEMBER_INDEX_THRESHOLD.
+    // Lookups index members [count, size) before probing, so AddMember() needs no maintenance; removals reset count.
+    struct MemberIndex {
+        SizeType count; //!< Number of members indexed
+        SizeType mask;  //!< Number of slots - 1, followed by the slots
+    };
+
+    static const SizeType kNoMember = ~SizeType(0);
+
+    static size_t MemberIndexSlots(SizeType capacity) {
+        size_t slots = 64;
+        while (slots < size_t(capacity) * 2) // load factor at most 1/2
+            slots *= 2;
+        return slots;
+    }
+
+    static size_t MembersSize(SizeType capacity) {
+        size_t size = capacity * sizeof(Member);
+        if (capacity >= RAPIDJSON_MEMBER_INDEX_THRESHOLD)
+            size += sizeof(MemberIndex) + MemberIndexSlots(capacity) * sizeof(SizeType);
+        return size;
+    }
+
+    void ResetMemberIndex() {
+        if (data_.o.capacity >= RAPIDJSON_MEMBER_INDEX_THRESHOLD) {
+            MemberIndex* index = reinterpret_cast<MemberIndex*>(GetMembersPointer() + data_.o.capacity);
+            index->count = 0;
+            index->mask = static_cast<SizeType>(MemberIndexSlots(data_.o.capacity) - 1);
+        }
+    }
+
+    // FNV-1a over code units
+    static SizeType HashMemberName(const Ch* str, SizeType length) {
+        uint32_t h = 2166136261u;
+        for (SizeType i = 0; i < length; i++)
+            h = (h ^ static_cast<uint32_t>(str[i])) * 16777619u;
+        return h;
+    }
+
+    template <typename SourceAllocator>
+    MemberIterator FindIndexedMember(const GenericValue<Encoding, SourceAllocator>& name) {
+        RAPIDJSON_ASSERT(data_.o.capacity >= RAPIDJSON_MEMBER_INDEX_THRESHOLD);
+        Member* members = GetMembersPointer();
+        MemberIndex* index = reinterpret_cast<MemberIndex*>(members + data_.o.capacity);
+        SizeType* slots = reinterpret_cast<SizeType*>(index + 1);
+
+        if (index->count == 0)
+            std::memset(slots, 0xFF, (index->mask + 1) * sizeof(SizeType));
+        for (; index->count < data_.o.size; index->count++) {
+            const GenericValue& n = members[index->count].name;
+            SizeType slot = HashMemberName(n.GetString(), n.GetStringLength()) & index->mask;
+            while (slots[slot] != kNoMember && !n.StringEqual(members[slots[slot]].name))
+                slot = (slot + 1) & index->mask;
+            if (slots[slot] == kNoMember) // keeps the first of duplicate names, as the linear search does
+                slots[slot] = index->count;
+        }
+
+        for (SizeType slot = HashMemberName(name.GetString(), name.GetStringLength()) & index->mask; slots[slot] != kNoMember; slot = (slot + 1) & index->mask)
+            if (name.StringEqual(members[slots[slot]].name))
+                return MemberIterator(members + slots[slot]);
+        return MemberEnd();
+    }
+#else
+    static size_t MembersSize(SizeType capacity) { return capacity * sizeof(Member); }
+    void ResetMemberIndex() {}
+#endif
+
     // Initialize this value as array with initial data, without calling destructor.
     void SetArrayRaw(GenericValue* values, SizeType count, Allocator& allocator) {
         data_.f.flags = kArrayFlag;
@@ -2041,13 +2150,14 @@ private:
     void SetObjectRaw(Member* members, SizeType count, Allocator& allocator) {
         data_.f.flags = kObjectFlag;
         if (count) {
-            Member* m = static_cast<Member*>(allocator.Malloc(count * sizeof(Member)));
+            Member* m = static_cast<Member*>(allocator.Malloc(MembersSize(count)));
             SetMembersPointer(m);
             std::memcpy(static_cast<void*>(m), members, count * sizeof(Member));
         }
         else
             SetMembersPointer(0);
         data_.o.size = data_.o.capacity = count;
+        ResetMemberIndex();
     }
 
     //! Initialize this value as constant string, without calling destructor.
@@ -2164,6 +2274,9 @@ public:
 #endif
 
     ~GenericDocument() {
+        // Free the values while the allocator is alive, if it needs Free().
+        if (Allocator::kNeedFree)
+            ValueType::SetNull();
         Destroy();
     }
 
@@ -2224,6 +2337,27 @@ public:
      */
     friend inline void swap(GenericDocument& a, GenericDocument& b) RAPIDJSON_NOEXCEPT { a.Swap(b); }
 
+    //! Release the value and its memory, to parse another JSON text into the same allocator.
+    /*! With MemoryPoolAllocator, the memory chunks are kept and reused by the
+        next parse (see MemoryPoolAllocator::Reset()), so parsing one request
+        after another into the same document does not allocate chunks again.
+        \code
+        Document d;
+        while (const char* request = Receive()) {
+            d.Recycle().Parse(request);
+            ...
+        }
+        \endcode
+        \param maxCapacity Total capacity in bytes of the chunks kept by MemoryPoolAllocator.
+        \return The document itself for fluent API.
+        \note No other value may use memory of the allocator, e.g. when it is shared with another document.
+    */
+    GenericDocument& Recycle(size_t maxCapacity = ~static_cast<size_t>(0)) {
+        ValueType::SetNull();
+        ResetAllocator(GetAllocator(), maxCapacity);
+        return *this;
+    }
+
     //! Populate this document by a generator which produces SAX events.
     /*! \tparam Generator A functor with <tt>bool f(Handler)</tt> prototype.
         \param g Generator functor which sends SAX events to the parameter.
@@ -2375,6 +2509,100 @@ public:
 
     //!@}
 
+#if RAPIDJSON_HAS_CXX11_THREADS
+    //!@name Parse in parallel
+    //!@{
+
+    //! Parse a large JSON array from a read-only string on several threads.
+    /*! The text is split at commas guessed to separate elements of the root
+        array, found by a quote-aware scan near equally spaced positions. The
+        parts are parsed concurrently into fragments with their own allocators,
+        then their elements are moved into the root without copying.
+
+        A guess is confirmed when the previous part ends exactly at its comma.
+        If a guess fails (e.g. it was inside a string or an element larger than
+        the scan), if the root is not an array, or on any parse error, the text
+        is parsed again serially, so the result is always the same as Parse().
+
+        \tparam parseFlags Combination of \ref ParseFlag (must not contain \ref kParseInsituFlag).
+        \param str Read-only zero-terminated string to be parsed.
+        \param threadCount Number of threads, including the calling thread. 0 for one per hardware thread.
+        \note Allocator must be MemoryPoolAllocator or CrtAllocator. With \ref kParseCommentsFlag,
+            the text is parsed serially.
+    */
+    template <unsigned parseFlags>
+    GenericDocument& ParseParallel(const Ch* str, unsigned threadCount = 0) {
+        RAPIDJSON_ASSERT(!(parseFlags & kParseInsituFlag));
+        if (threadCount == 0)
+            threadCount = std::thread::hardware_concurrency();
+        const size_t length = internal::StrLen(str);
+        const Ch* begin = str;
+        while (*begin == ' ' || *begin == '\n' || *begin == '\r' || *begin == '\t')
+            ++begin;
+        if (threadCount < 2 || length / kParallelMinPartLength < 2 || (parseFlags & kParseCommentsFlag) || *begin != '[')
+            return Parse<parseFlags>(str);
+
+        // Part i starts after starts[i], which is the '[' or a comma.
+        const size_t partCount = threadCount < length / kParallelMinPartLength ? threadCount : length / kParallelMinPartLength;
+        std::vector<const Ch*> starts(1, begin);
+        for (size_t i = 1; i < partCount; i++) {
+            const Ch* target = str + length / partCount * i;
+            if (target > starts.back())
+                if (const Ch* split = FindParallelSplit(target, str + length))
+                    starts.push_back(split);
+        }
+        const size_t n = starts.size();
+        if (n < 2)
+            return Parse<parseFlags>(str);
+
+        std::vector<Allocator> allocators(n);
+        std::vector<GenericDocument> fragments;
+        fragments.reserve(n);
+        for (size_t i = 0; i < n; i++)
+            fragments.emplace_back(&allocators[i]);
+        std::vector<char> succeeded(n);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < n; i++)
+            threads.push_back(std::thread([&, i]() {
+                ParallelPart<parseFlags> part(starts[i], i + 1 < n ? starts[i + 1] : 0);
+                succeeded[i] = fragments[i].Populate(part).IsArray();
+            }));
+        ParallelPart<parseFlags> part(starts[0], starts[1]);
+        succeeded[0] = fragments[0].Populate(part).IsArray();
+        for (size_t i = 0; i < threads.size(); i++)
+            threads[i].join();
+
+        size_t count = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (!succeeded[i])
+                return Parse<parseFlags>(str);
+            count += fragments[i].Size();
+        }
+
+        // Move the elements, and take over the memory they use.
+        ValueType root(kArrayType);
+        root.Reserve(static_cast<SizeType>(count), GetAllocator());
+        for (size_t i = 0; i < n; i++) {
+            for (typename ValueType::ValueIterator v = fragments[i].Begin(); v != fragments[i].End(); ++v)
+                root.PushBack(*v, GetAllocator());
+            AdoptAllocations(GetAllocator(), allocators[i]);
+        }
+        ValueType::operator=(root);
+        parseResult_ = ParseResult();
+        return *this;
+    }
+
+    //! Parse a large JSON array from a read-only string on several threads (with \ref kParseDefaultFlags)
+    /*! \param str Read-only zero-terminated string to be parsed.
+        \param threadCount Number of threads, including the calling thread. 0 for one per hardware thread.
+    */
+    GenericDocument& ParseParallel(const Ch* str, unsigned threadCount = 0) {
+        return ParseParallel<kParseDefaultFlags>(str, threadCount);
+    }
+    //!@}
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
     //!@name Handling parse errors
     //!@{
 
@@ -2489,6 +2717,105 @@ private:
         RAPIDJSON_DELETE(ownAllocator_);
     }
 
+    template <typename AllocatorType>
+    static void ResetAllocator(AllocatorType&, size_t) {}
+
+    template <typename BaseAllocator>
+    static void ResetAllocator(MemoryPoolAllocator<BaseAllocator>& allocator, size_t maxCapacity) {
+        allocator.Reset(maxCapacity);
+    }
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+    //! Generator of the fragment of ParseParallel() for the elements between two commas.
+    template <unsigned parseFlags>
+    struct ParallelPart {
+        ParallelPart(const Ch* start, const Ch* stop) : start_(start), stop_(stop), reader_() {}
+
+        bool operator()(GenericDocument& handler) {
+            // One element at a time, which must not run past the next part.
+            static const unsigned kFlags = parseFlags | kParseStopWhenDoneFlag;
+            GenericStringStream<Encoding> s(start_ + 1);
+            SizeType count = 0;
+            handler.StartArray();
+            for (;;) {
+                if (reader_.template Parse<kFlags>(s, handler).IsError())
+                    return false;
+                count++;
+                SkipWhitespace(s);
+                if (stop_) {
+                    if (s.src_ == stop_)
+                        break;
+                    if (s.src_ > stop_ || s.Peek() != ',')
+                        return false;
+                }
+                else if (s.Peek() == ']') {
+                    s.Take();
+                    SkipWhitespace(s);
+                    if (s.Peek() != '\0')
+                        return false;
+                    break;
+                }
+                else if (s.Peek() != ',')
+                    return false;
+                s.Take();
+            }
+            return handler.EndArray(count);
+        }
+
+        const Ch* start_;
+        const Ch* stop_;    //!< Comma where the next part starts, null for the last part.
+        GenericReader<Encoding, Encoding, StackAllocator> reader_;
+    };
+
+    //! Finds a comma which likely separates two elements of the root array, after p.
+    /*! Strings cannot contain a raw newline, so the scan starts outside strings
+        after one, if there is one nearby. The comma at the lowest nesting level
+        within the scan is taken.
+    */
+    static const Ch* FindParallelSplit(const Ch* p, const Ch* end) {
+        const Ch* limit = static_cast<size_t>(end - p) > kParallelSplitWindow ? p + kParallelSplitWindow : end;
+        for (const Ch* q = p; q != limit; ++q)
+            if (*q == '\n') {
+                p = q + 1;
+                break;
+            }
+
+        const Ch* split = 0;
+        int depth = 0, splitDepth = 0;
+        bool inString = false;
+        for (; p < limit; ++p) {
+            const Ch c = *p;
+            if (inString) {
+                if (c == '\\')
+                    ++p;
+                else if (c == '"')
+                    inString = false;
+            }
+            else if (c == '"')
+                inString = true;
+            else if (c == '[' || c == '{')
+                ++depth;
+            else if (c == ']' || c == '}')
+                --depth;
+            else if (c == ',' && (!split || depth < splitDepth)) {
+                split = p;
+                splitDepth = depth;
+            }
+        }
+        return split;
+    }
+
+    static void AdoptAllocations(CrtAllocator&, CrtAllocator&) {}
+
+    template <typename BaseAllocator>
+    static void AdoptAllocations(MemoryPoolAllocator<BaseAllocator>& allocator, MemoryPoolAllocator<BaseAllocator>& rhs) {
+        allocator.AdoptChunks(rhs);
+    }
+
+    static const size_t kParallelMinPartLength = 256 * 1024;  //!< Shortest text parsed by each thread, in Ch.
+    static const size_t kParallelSplitWindow = 64 * 1024;     //!< Length of the text scanned for a split, in Ch.
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
     static const size_t kDefaultStackCapacity = 1024;
     Allocator* allocator_;
     Allocator* ownAllocator_;
@@ -60,6 +60,23 @@ public:
         }
     }
 
+    void PutBlock(const char* str, size_t n) {
+        size_t avail = static_cast<size_t>(bufferEnd_ - current_);
+        while (n > avail) {
+            std::memcpy(current_, str, avail);
+            current_ += avail;
+            Flush();
+            str += avail;
+            n -= avail;
+            avail = static_cast<size_t>(bufferEnd_ - current_);
+        }
+
+        if (n > 0) {
+            std::memcpy(current_, str, n);
+            current_ += n;
+        }
+    }
+
     void Flush() {
         if (current_ != buffer_) {
             size_t result = std::fwrite(buffer_, 1, static_cast<size_t>(current_ - buffer_), fp_);
@@ -95,6 +112,12 @@ inline void PutN(FileWriteStream& stream, char c, size_t n) {
     stream.PutN(c, n);
 }
 
+//! Implement specialized version of PutBlockUnsafe() with memcpy() for better performance.
+template<>
+inline void PutBlockUnsafe(FileWriteStream& stream, const char* str, size_t n) {
+    stream.PutBlock(str, n);
+}
+
 RAPIDJSON_NAMESPACE_END
 
 #ifdef __clang__
@@ -41,6 +41,19 @@ class CrtAllocator;
 template <typename BaseAllocator>
 class MemoryPoolAllocator;
 
+template <typename BaseAllocator>
+class FreeListAllocator;
+
+struct AllocatorStats;
+
+template <typename BaseAllocator>
+class InstrumentedAllocator;
+
+// chunkpool.h
+
+class ChunkPool;
+class ChunkPoolAllocator;
+
 // stream.h
 
 template <typename Encoding>
@@ -64,6 +77,15 @@ typedef GenericStringBuffer<UTF8<char>, CrtAllocator> StringBuffer;
 
 class FileReadStream;
 
+// mmapreadstream.h
+
+class MmapReadStream;
+
+// readaheadstream.h
+
+template <typename Source>
+class GenericReadAheadStream;
+
 // filewritestream.h
 
 class FileWriteStream;
@@ -89,6 +111,13 @@ class GenericReader;
 
 typedef GenericReader<UTF8<char>, UTF8<char>, CrtAllocator> Reader;
 
+// pushparser.h
+
+template <typename SourceEncoding, typename TargetEncoding, typename StackAllocator>
+class GenericPushParser;
+
+typedef GenericPushParser<UTF8<char>, UTF8<char>, CrtAllocator> PushParser;
+
 // writer.h
 
 template<typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator, unsigned writeFlags>
@@ -120,6 +149,23 @@ class GenericDocument;
 
 typedef GenericDocument<UTF8<char>, MemoryPoolAllocator<CrtAllocator>, CrtAllocator> Document;
 
+// lazydocument.h
+
+template <typename DocumentType>
+class GenericLazyValue;
+
+template <typename Encoding, typename Allocator, typename StackAllocator>
+class GenericLazyDocument;
+
+typedef GenericLazyDocument<UTF8<char>, MemoryPoolAllocator<CrtAllocator>, CrtAllocator> LazyDocument;
+
+// jsonlines.h
+
+template <typename Encoding, typename Allocator, typename StackAllocator>
+class GenericJsonLinesParser;
+
+typedef GenericJsonLinesParser<UTF8<char>, MemoryPoolAllocator<CrtAllocator>, CrtAllocator> JsonLinesParser;
+
 // pointer.h
 
 template <typename ValueType, typename Allocator>
@@ -0,0 +1,161 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// This is a C++ header-only implementation of the Schubfach algorithm from the publication:
+// Giulietti, Raffaello. "The Schubfach way to render doubles." (2020).
+// Unlike Grisu2 it always finds the shortest decimal that rounds back to the same
+// double, and the closest one among those.
+
+#ifndef RAPIDJSON_SCHUBFACH_H_
+#define RAPIDJSON_SCHUBFACH_H_
+
+#include "dtoa.h" // Prettify()
+#include "pow10.h"
+
+RAPIDJSON_NAMESPACE_BEGIN
+namespace internal {
+
+// floor(log10(2^e)), or floor(log10(3/4 * 2^e)) if threeQuarters, for e in [-1650, 1650]
+inline int FloorLog10Pow2(int e, bool threeQuarters) {
+    return (e * 1262611 - (threeQuarters ? 524031 : 0)) >> 22;
+}
+
+// floor(log2(10^e)) for e in [-1233, 1233]
+inline int FloorLog2Pow10(int e) {
+    return (e * 1741647) >> 19;
+}
+
+// High 64 bits of g * cp / 2^128, rounded to odd: the lowest bit is set if anything was cut off.
+inline uint64_t SchubfachRoundToOdd(const uint64_t g[2], uint64_t cp) {
+    uint64_t x1, y1;
+    Umul128(g[1], cp, &x1);
+    const uint64_t y0 = Umul128(g[0], cp, &y1);
+    const uint64_t z = y0 + x1;
+    if (z < y0)
+        y1++;
+    return y1 | (z > 1);
+}
+
+// Shortest decimal significand and exponent of a positive finite double: value ~ buffer[0, length) * 10^K
+inline void Schubfach(double value, char* buffer, int* length, int* K) {
+    const Double d(value);
+    const uint64_t c = d.IntegerSignificand();
+    const int q = d.IntegerExponent();
+    RAPIDJSON_ASSERT(c != 0);
+
+    uint64_t s;
+    int k;
+    if (q <= 0 && q > -53 && (c & ((uint64_t(1) << -q) - 1)) == 0) {
+        // Integers below 2^53 are exact
+        s = c >> -q;
+        k = 0;
+    }
+    else {
+        const bool even = (c & 1) == 0;
+        const bool lowerBoundaryCloser = d.Significand() == 0 && q > -1074;
+        const uint64_t cbl = 4 * c - 2 + (lowerBoundaryCloser ? 1 : 0);
+        const uint64_t cb = 4 * c;
+        const uint64_t cbr = 4 * c + 2;
+
+        k = FloorLog10Pow2(q, lowerBoundaryCloser);
+        const int h = q + FloorLog2Pow10(-k) + 1;  // in [1, 4]
+
+        // 10^-k rounded up to 128 bits; the table rounds down, which is exact for 10^0...10^55
+        const uint64_t* pow10 = Pow10Significand128(-k);
+        uint64_t g[2] = { pow10[0], pow10[1] };
+        if (-k < 0 || -k > 55) {
+            if (++g[1] == 0)
+                g[0]++;
+        }
+
+        const uint64_t vbl = SchubfachRoundToOdd(g, cbl << h);
+        const uint64_t vb = SchubfachRoundToOdd(g, cb << h);
+        const uint64_t vbr = SchubfachRoundToOdd(g, cbr << h);
+        const uint64_t lower = vbl + (even ? 0 : 1);
+        const uint64_t upper = vbr - (even ? 0 : 1);
+
+        // One digit less if only one of the two candidates is inside the rounding interval
+        s = vb / 4;
+        bool done = false;
+        if (s >= 10) {
+            const uint64_t sp = s / 10;
+            const bool upInside = lower <= 40 * sp;
+            const bool wpInside = 40 * sp + 40 <= upper;
+            if (upInside != wpInside) {
+                s = sp + (wpInside ? 1 : 0);
+                k++;
+                done = true;
+            }
+        }
+        if (!done) {
+            const bool uInside = lower <= 4 * s;
+            const bool wInside = 4 * s + 4 <= upper;
+            if (uInside != wInside)
+                s += wInside ? 1 : 0;
+            else {
+                // Both inside: the closer one, ties to even
+                const uint64_t mid = 4 * s + 2;
+                s += (vb > mid || (vb == mid && (s & 1) != 0)) ? 1 : 0;
+            }
+        }
+    }
+
+    // Short decimals such as 0.3 come out padded with zeros to 16 or 17 digits
+    if (s % 100000000 == 0) {
+        s /= 100000000;
+        k += 8;
+    }
+    if (s % 10000 == 0) {
+        s /= 10000;
+        k += 4;
+    }
+    if (s % 100 == 0) {
+        s /= 100;
+        k += 2;
+    }
+    if (s % 10 == 0) {
+        s /= 10;
+        k++;
+    }
+    *length = static_cast<int>(u64toa(s, buffer) - buffer);
+    *K = k;
+}
+
+//! Shortest round-trip counterpart of dtoa(), with the same output format.
+inline char* ShortestDtoa(double value, char* buffer, int maxDecimalPlaces = 324) {
+    RAPIDJSON_ASSERT(maxDecimalPlaces >= 1);
+    Double d(value);
+    if (d.IsZero()) {
+        if (d.Sign())
+            *buffer++ = '-';     // -0.0, Issue #289
+        buffer[0] = '0';
+        buffer[1] = '.';
+        buffer[2] = '0';
+        return &buffer[3];
+    }
+    else {
+        if (value < 0) {
+            *buffer++ = '-';
+            value = -value;
+        }
+        int length, K;
+        Schubfach(value, buffer, &length, &K);
+        return Prettify(buffer, length, K, maxDecimalPlaces);
+    }
+}
+
+} // namespace internal
+RAPIDJSON_NAMESPACE_END
+
+#endif // RAPIDJSON_SCHUBFACH_H_
@@ -0,0 +1,1202 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_INTERNAL_SIMD_H_
+#define RAPIDJSON_INTERNAL_SIMD_H_
+
+#include "../rapidjson.h"
+#include <cstring>
+
+//! The x86 kernels below are compiled, either for run time dispatch or because AVX2 is enabled.
+#if defined(RAPIDJSON_SIMD_DISPATCH) || defined(RAPIDJSON_AVX2)
+#define RAPIDJSON_SIMD_KERNELS
+#endif
+
+//! The SSE2 and SSE4.2 kernels are also compiled when SSE4.2 is enabled, for the validating string scan.
+#if defined(RAPIDJSON_SIMD_KERNELS) || defined(RAPIDJSON_SSE42)
+#define RAPIDJSON_SIMD_SSE42_KERNELS
+#endif
+
+#ifdef RAPIDJSON_SIMD_SSE42_KERNELS
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#pragma intrinsic(_BitScanForward)
+#else
+#ifdef RAPIDJSON_SIMD_DISPATCH
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#endif
+#endif // RAPIDJSON_SIMD_SSE42_KERNELS
+
+#if defined(RAPIDJSON_SIMD_DISPATCH) && RAPIDJSON_HAS_CXX11_THREADS
+#include <atomic>
+#endif
+
+//! Compile a single function for an instruction set extension not enabled for the whole translation unit.
+#if defined(RAPIDJSON_SIMD_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+#define RAPIDJSON_SIMD_TARGET(x) __attribute__((target(x)))
+#else
+#define RAPIDJSON_SIMD_TARGET(x)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+namespace internal {
+
+///////////////////////////////////////////////////////////////////////////////
+// Portable kernels
+//
+// All kernels work on raw UTF-8 code units. The single-pointer overloads rely on
+// the text being null-terminated, the range overloads never read at or beyond end.
+
+inline bool IsWhitespaceChar(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+//! Whether a code unit terminates an unescaped run in a string: '"', '\\' or a control character.
+inline bool IsStringSpecialChar(char c) {
+    return c == '\"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+inline const char* SkipWhitespace_Scalar(const char* p) {
+    while (IsWhitespaceChar(*p))
+        ++p;
+    return p;
+}
+
+inline const char* SkipWhitespace_Scalar(const char* p, const char* end) {
+    while (p != end && IsWhitespaceChar(*p))
+        ++p;
+    return p;
+}
+
+//! Return the first '"', '\\' or control character at or after p.
+inline const char* ScanUnescaped_Scalar(const char* p) {
+    while (!IsStringSpecialChar(*p))
+        ++p;
+    return p;
+}
+
+inline const char* ScanUnescaped_Scalar(const char* p, const char* end) {
+    while (p != end && !IsStringSpecialChar(*p))
+        ++p;
+    return p;
+}
+
+inline bool IsUtf8Continuation(unsigned char c) {
+    return (c & 0xC0) == 0x80;
+}
+
+//! Length of the well-formed UTF-8 sequence at p, or 0 if p is ill-formed or starts with '"', '\\' or a control character.
+/*! Accepts exactly what UTF8::Validate() accepts: no overlong forms, surrogates or
+    code points above U+10FFFF. Stops reading at the first byte that is not a
+    continuation, so it never reads past a terminator.
+*/
+inline unsigned ValidUtf8Length(const char* p) {
+    const unsigned char c = static_cast<unsigned char>(p[0]);
+    if (c < 0x80)
+        return IsStringSpecialChar(p[0]) ? 0 : 1;
+
+    const unsigned char c1 = static_cast<unsigned char>(p[1]);
+    if (c >= 0xC2 && c <= 0xDF)
+        return IsUtf8Continuation(c1) ? 2 : 0;
+
+    if (c >= 0xE0 && c <= 0xEF) {
+        const unsigned char lo = c == 0xE0 ? 0xA0 : 0x80;
+        const unsigned char hi = c == 0xED ? 0x9F : 0xBF;
+        if (c1 < lo || c1 > hi)
+            return 0;
+        return IsUtf8Continuation(static_cast<unsigned char>(p[2])) ? 3 : 0;
+    }
+
+    if (c >= 0xF0 && c <= 0xF4) {
+        const unsigned char lo = c == 0xF0 ? 0x90 : 0x80;
+        const unsigned char hi = c == 0xF4 ? 0x8F : 0xBF;
+        if (c1 < lo || c1 > hi || !IsUtf8Continuation(static_cast<unsigned char>(p[2])))
+            return 0;
+        return IsUtf8Continuation(static_cast<unsigned char>(p[3])) ? 4 : 0;
+    }
+    return 0;
+}
+
+//! Return the first '"', '\\', control character or ill-formed UTF-8 sequence at or after p.
+inline const char* ScanValidUnescaped_Scalar(const char* p) {
+    while (unsigned length = ValidUtf8Length(p))
+        p += length;
+    return p;
+}
+
+//! Range form: also stops at a sequence cut by end, without reading at or beyond end.
+inline const char* ScanValidUnescaped_Scalar(const char* p, const char* end) {
+    while (end - p >= 4) {
+        const unsigned length = ValidUtf8Length(p);
+        if (length == 0)
+            return p;
+        p += length;
+    }
+    while (p != end) {
+        char tail[4] = { 0, 0, 0, 0 };  // a sequence cut by end is followed by zeros, which are not continuations
+        std::memcpy(tail, p, static_cast<size_t>(end - p));
+        const unsigned length = ValidUtf8Length(tail);
+        if (length == 0)
+            return p;
+        p += length;
+    }
+    return p;
+}
+
+//! Number of UTF-16 or UTF-32 code units at p before the first '"', '\\', control character or unit with a bit of highMask, in whole vectors.
+/*! The scalar family checks no vectors, so the caller scans all the units itself.
+*/
+inline size_t ScanUnescapedWide_Scalar(const void* p, size_t n, uint32_t highMask) {
+    (void)p;
+    (void)n;
+    (void)highMask;
+    return 0;
+}
+
+//! Restart point for the scalar validator when a block at b fails the vector check.
+/*! Everything in [start, b) is well-formed except possibly a sequence truncated
+    by b, so back up to the lead byte of the last sequence before b.
+*/
+inline const char* Utf8BlockRestart(const char* start, const char* b) {
+    if (b <= start)
+        return start;
+    const char* r = b;
+    for (int i = 0; i < 3 && r != start && IsUtf8Continuation(static_cast<unsigned char>(r[-1])); i++)
+        --r;
+    if (r != start && static_cast<unsigned char>(r[-1]) >= 0xC0)
+        --r;
+    return r;
+}
+
+//! Whether the eight bytes at p are all ASCII digits, checked one by one.
+/*! For null-terminated text, whose end is only known after reading it: the
+    check stops at the first other byte, so it never reads past the terminator.
+*/
+inline bool IsDigits8(const char* p) {
+    for (int i = 0; i < 8; i++)
+        if (p[i] < '0' || p[i] > '9')
+            return false;
+    return true;
+}
+
+//! Convert the eight ASCII digits at p, eight at a time in a 64-bit word (SWAR).
+/*! \return false, leaving value untouched, if any of the eight bytes is not a digit.
+*/
+inline bool ParseDigits8(const char* p, uint32_t* value) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+#if RAPIDJSON_ENDIAN == RAPIDJSON_BIGENDIAN
+    v = (v >> 56) | ((v >> 40) & 0xFF00) | ((v >> 24) & 0xFF0000) | ((v >> 8) & RAPIDJSON_UINT64_C2(0, 0xFF000000)) |
+        ((v << 8) & RAPIDJSON_UINT64_C2(0xFF, 0)) | ((v << 24) & RAPIDJSON_UINT64_C2(0xFF00, 0)) |
+        ((v << 40) & RAPIDJSON_UINT64_C2(0xFF0000, 0)) | (v << 56);
+#endif
+    // Every byte is in 0x30-0x3F, and stays there when 6 is added.
+    const uint64_t kHighNibbles = RAPIDJSON_UINT64_C2(0xF0F0F0F0, 0xF0F0F0F0);
+    if (((v & kHighNibbles) | (((v + RAPIDJSON_UINT64_C2(0x06060606, 0x06060606)) & kHighNibbles) >> 4)) != RAPIDJSON_UINT64_C2(0x33333333, 0x33333333))
+        return false;
+
+    // Combine adjacent digits into 2-digit lanes, then pairs of those into two 4-digit
+    // lanes scaled by 10^4 and 1 so that the final sum lands in the upper half.
+    v -= RAPIDJSON_UINT64_C2(0x30303030, 0x30303030);
+    v = v * 10 + (v >> 8);
+    const uint64_t kMask = RAPIDJSON_UINT64_C2(0x000000FF, 0x000000FF);
+    v = ((v & kMask) * RAPIDJSON_UINT64_C2(0x000F4240, 0x00000064) + ((v >> 16) & kMask) * RAPIDJSON_UINT64_C2(0x00002710, 0x00000001)) >> 32;
+    *value = static_cast<uint32_t>(v);
+    return true;
+}
+
+#ifdef RAPIDJSON_SIMD_SSE42_KERNELS
+
+inline unsigned SimdFirstSetBit(uint32_t mask) {
+    RAPIDJSON_ASSERT(mask != 0);
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long offset;
+    _BitScanForward(&offset, mask);
+    return static_cast<unsigned>(offset);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+inline unsigned SimdFirstSetBit64(uint64_t mask) {
+    RAPIDJSON_ASSERT(mask != 0);
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    unsigned long offset;
+    _BitScanForward64(&offset, mask);
+    return static_cast<unsigned>(offset);
+#elif defined(_MSC_VER) && !defined(__clang__)
+    const uint32_t low = static_cast<uint32_t>(mask);
+    return low != 0 ? SimdFirstSetBit(low) : 32 + SimdFirstSetBit(static_cast<uint32_t>(mask >> 32));
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+//! Round p up to the next multiple of alignment (a power of two).
+inline const char* SimdAlignUp(const char* p, size_t alignment) {
+    return reinterpret_cast<const char*>((reinterpret_cast<size_t>(p) + alignment - 1) & ~(alignment - 1));
+}
+
+//! Round p down to a multiple of alignment (a power of two).
+inline const char* SimdAlignDown(const char* p, size_t alignment) {
+    return reinterpret_cast<const char*>(reinterpret_cast<size_t>(p) & ~(alignment - 1));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+//
+// Null-terminated scans walk byte by byte up to an aligned address and then use
+// aligned loads only, which can never cross into an unmapped page.
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline uint32_t WhitespaceMask_SSE2(__m128i s) {
+    __m128i x = _mm_cmpeq_epi8(s, _mm_set1_epi8(' '));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\n')));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\r')));
+    x = _mm_or_si128(x, _mm_cmpeq_epi8(s, _mm_set1_epi8('\t')));
+    return static_cast<uint32_t>(_mm_movemask_epi8(x));
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline uint32_t StringSpecialMask_SSE2(__m128i s) {
+    const __m128i sp = _mm_set1_epi8(0x1F);
+    const __m128i t1 = _mm_cmpeq_epi8(s, _mm_set1_epi8('\"'));
+    const __m128i t2 = _mm_cmpeq_epi8(s, _mm_set1_epi8('\\'));
+    const __m128i t3 = _mm_cmpeq_epi8(_mm_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(t1, t2), t3)));
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline const char* SkipWhitespace_SSE2(const char* p) {
+    for (const char* nextAligned = SimdAlignUp(p, 16); p != nextAligned; ++p)
+        if (!IsWhitespaceChar(*p))
+            return p;
+
+    for (;; p += 16) {
+        uint32_t r = ~WhitespaceMask_SSE2(_mm_load_si128(reinterpret_cast<const __m128i *>(p))) & 0xFFFFu;
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline const char* SkipWhitespace_SSE2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        uint32_t r = ~WhitespaceMask_SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) & 0xFFFFu;
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+    }
+    return SkipWhitespace_Scalar(p, end);
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline const char* ScanUnescaped_SSE2(const char* p) {
+    for (const char* nextAligned = SimdAlignUp(p, 16); p != nextAligned; ++p)
+        if (IsStringSpecialChar(*p))
+            return p;
+
+    for (;; p += 16) {
+        uint32_t r = StringSpecialMask_SSE2(_mm_load_si128(reinterpret_cast<const __m128i *>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline const char* ScanUnescaped_SSE2(const char* p, const char* end) {
+    for (; end - p >= 16; p += 16) {
+        uint32_t r = StringSpecialMask_SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+    }
+    return ScanUnescaped_Scalar(p, end);
+}
+
+//! Lanes of 16-bit units which are not '"', '\\', a control character or a unit with a bit of high.
+RAPIDJSON_SIMD_TARGET("sse2")
+inline uint32_t UnescapedMask16_SSE2(__m128i s, __m128i high) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i x = _mm_or_si128(_mm_cmpeq_epi16(s, _mm_set1_epi16('\"')), _mm_cmpeq_epi16(s, _mm_set1_epi16('\\')));
+    x = _mm_or_si128(x, _mm_cmpeq_epi16(_mm_and_si128(s, _mm_set1_epi16(~0x1F)), zero));   // s < 0x20
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_andnot_si128(x, _mm_cmpeq_epi16(_mm_and_si128(s, high), zero))));
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline uint32_t UnescapedMask32_SSE2(__m128i s, __m128i high) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i x = _mm_or_si128(_mm_cmpeq_epi32(s, _mm_set1_epi32('\"')), _mm_cmpeq_epi32(s, _mm_set1_epi32('\\')));
+    x = _mm_or_si128(x, _mm_cmpeq_epi32(_mm_and_si128(s, _mm_set1_epi32(~0x1F)), zero));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_andnot_si128(x, _mm_cmpeq_epi32(_mm_and_si128(s, high), zero))));
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline size_t ScanUnescaped16_SSE2(const void* p, size_t n, uint32_t highMask) {
+    const __m128i high = _mm_set1_epi16(static_cast<short>(highMask));
+    const char* b = static_cast<const char*>(p);
+    size_t i = 0;
+    for (; n - i >= 8; i += 8) {
+        uint32_t r = ~UnescapedMask16_SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i * 2)), high) & 0xFFFFu;
+        if (r != 0)
+            return i + SimdFirstSetBit(r) / 2;
+    }
+    return i;
+}
+
+RAPIDJSON_SIMD_TARGET("sse2")
+inline size_t ScanUnescaped32_SSE2(const void* p, size_t n, uint32_t highMask) {
+    const __m128i high = _mm_set1_epi32(static_cast<int>(highMask));
+    const char* b = static_cast<const char*>(p);
+    size_t i = 0;
+    for (; n - i >= 4; i += 4) {
+        uint32_t r = ~UnescapedMask32_SSE2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i * 4)), high) & 0xFFFFu;
+        if (r != 0)
+            return i + SimdFirstSetBit(r) / 4;
+    }
+    return i;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SSE4.2 kernels
+//
+// pcmpistri only helps whitespace skipping; string scanning reuses the SSE2 kernels.
+
+RAPIDJSON_SIMD_TARGET("sse4.2")
+inline const char* SkipWhitespace_SSE42(const char* p) {
+    for (const char* nextAligned = SimdAlignUp(p, 16); p != nextAligned; ++p)
+        if (!IsWhitespaceChar(*p))
+            return p;
+
+    static const char whitespace[16] = " \n\r\t";
+    const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&whitespace[0]));
+
+    for (;; p += 16) {
+        const __m128i s = _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+        const int r = _mm_cmpistri(w, s, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT | _SIDD_NEGATIVE_POLARITY);
+        if (r != 16)    // some of characters is non-whitespace
+            return p + r;
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("sse4.2")
+inline const char* SkipWhitespace_SSE42(const char* p, const char* end) {
+    static const char whitespace[16] = " \n\r\t";
+    const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&whitespace[0]));
+
+    for (; end - p >= 16; p += 16) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const int r = _mm_cmpistri(w, s, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT | _SIDD_NEGATIVE_POLARITY);
+        if (r != 16)    // some of characters is non-whitespace
+            return p + r;
+    }
+    return SkipWhitespace_Scalar(p, end);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// UTF-8 validation kernels
+//
+// Blocks are checked with the nibble lookup algorithm of Keiser and Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte" (2021). A block that
+// holds '"', '\\', a control character or an error is handed to the scalar
+// validator from the last sequence boundary before it, which finds the exact
+// offset of the first offending byte.
+
+//! Error classes of a (previous byte, current byte) pair, as bit flags.
+enum Utf8ErrorBits {
+    kUtf8TooShort = 1 << 0,     //!< Lead byte not followed by a continuation.
+    kUtf8TooLong = 1 << 1,      //!< Continuation after an ASCII byte.
+    kUtf8Overlong3 = 1 << 2,    //!< E0 80..9F.
+    kUtf8TooLarge = 1 << 3,     //!< F4 90..BF, F5..FF 90..BF.
+    kUtf8Surrogate = 1 << 4,    //!< ED A0..BF.
+    kUtf8Overlong2 = 1 << 5,    //!< C0..C1 followed by a continuation.
+    kUtf8TooLarge1000 = 1 << 6, //!< F5..FF 80..8F.
+    kUtf8Overlong4 = 1 << 6,    //!< F0 80..8F.
+    kUtf8TwoConts = 1 << 7,     //!< Continuation after a continuation.
+    kUtf8Carry = kUtf8TooShort | kUtf8TooLong | kUtf8TwoConts
+};
+
+//! Lookup tables indexed by the high nibble of the previous byte, its low nibble and the high nibble of the current byte.
+inline const unsigned char* Utf8ErrorTables() {
+    static const unsigned char tables[48] = {
+        // previous byte, high nibble
+        kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong,
+        kUtf8TooLong, kUtf8TooLong, kUtf8TooLong, kUtf8TooLong,
+        kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts, kUtf8TwoConts,
+        kUtf8TooShort | kUtf8Overlong2,
+        kUtf8TooShort,
+        kUtf8TooShort | kUtf8Overlong3 | kUtf8Surrogate,
+        kUtf8TooShort | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Overlong4,
+        // previous byte, low nibble
+        kUtf8Carry | kUtf8Overlong3 | kUtf8Overlong2 | kUtf8Overlong4,
+        kUtf8Carry | kUtf8Overlong2,
+        kUtf8Carry,
+        kUtf8Carry,
+        kUtf8Carry | kUtf8TooLarge,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000 | kUtf8Surrogate,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        kUtf8Carry | kUtf8TooLarge | kUtf8TooLarge1000,
+        // current byte, high nibble
+        kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+        kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort,
+        kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 | kUtf8TooLarge1000 | kUtf8Overlong4,
+        kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Overlong3 | kUtf8TooLarge,
+        kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate | kUtf8TooLarge,
+        kUtf8TooLong | kUtf8Overlong2 | kUtf8TwoConts | kUtf8Surrogate | kUtf8TooLarge,
+        kUtf8TooShort, kUtf8TooShort, kUtf8TooShort, kUtf8TooShort
+    };
+    return tables;
+}
+
+//! Nonzero where the last three bytes of a block start a sequence that needs more bytes: >= F0, >= E0, >= C0.
+inline const unsigned char* Utf8IncompleteLimits() {
+    static const unsigned char limits[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+    };
+    return limits;
+}
+
+//! Loaded at 32 - n (or 16 - n for 16 bytes), selects the first n bytes of a block.
+inline const char* SimdHeadMasks() {
+    static const char masks[64] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    };
+    return masks;
+}
+
+//! Nonzero bytes where input, preceded by the 16 bytes prev, is not well-formed UTF-8.
+RAPIDJSON_SIMD_TARGET("sse4.2")
+inline __m128i Utf8Errors_SSE42(__m128i input, __m128i prev) {
+    const unsigned char* t = Utf8ErrorTables();
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+    const __m128i byte1High = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t)), _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    const __m128i byte1Low = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t + 16)), _mm_and_si128(prev1, nibble));
+    const __m128i byte2High = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t + 32)), _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    const __m128i pairErrors = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    // The second and third continuation of a three- or four-byte sequence show up as kUtf8TwoConts, and only those.
+    const __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14), _mm_set1_epi8(0xE0 - 0x80));
+    const __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13), _mm_set1_epi8(0xF0 - 0x80));
+    const __m128i mustBeContinuation = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(mustBeContinuation, pairErrors);
+}
+
+//! Sequences up to an aligned address are validated one by one; the last bytes of one straddling it are replaced by spaces in the first block.
+RAPIDJSON_SIMD_TARGET("sse4.2")
+inline const char* ScanValidUnescaped_SSE42(const char* p) {
+    for (const char* nextAligned = SimdAlignUp(p, 16); p < nextAligned; ) {
+        const unsigned length = ValidUtf8Length(p);
+        if (length == 0)
+            return p;
+        p += length;
+    }
+
+    const char* b = SimdAlignDown(p, 16);
+    const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(SimdHeadMasks() + 32 - (p - b)));
+    const __m128i incomplete = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Utf8IncompleteLimits() + 16));
+    __m128i s = _mm_blendv_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(b)), _mm_set1_epi8(' '), head);
+    __m128i prev = _mm_setzero_si128();
+    for (;;) {
+        const __m128i errors = _mm_movemask_epi8(s) == 0 ?
+            _mm_subs_epu8(prev, incomplete) :   // ASCII block: only a sequence truncated by the previous block can be wrong
+            Utf8Errors_SSE42(s, prev);
+        if (StringSpecialMask_SSE2(s) != 0 || !_mm_testz_si128(errors, errors))
+            return ScanValidUnescaped_Scalar(Utf8BlockRestart(p, b));
+        prev = s;
+        b += 16;
+        s = _mm_load_si128(reinterpret_cast<const __m128i *>(b));
+    }
+}
+
+//! Range form: unaligned blocks from p, then the scalar validator for the tail.
+RAPIDJSON_SIMD_TARGET("sse4.2")
+inline const char* ScanValidUnescaped_SSE42(const char* p, const char* end) {
+    const __m128i incomplete = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Utf8IncompleteLimits() + 16));
+    __m128i prev = _mm_setzero_si128();
+    const char* b = p;
+    for (; end - b >= 16; b += 16) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+        const __m128i errors = _mm_movemask_epi8(s) == 0 ? _mm_subs_epu8(prev, incomplete) : Utf8Errors_SSE42(s, prev);
+        if (StringSpecialMask_SSE2(s) != 0 || !_mm_testz_si128(errors, errors))
+            break;
+        prev = s;
+    }
+    return ScanValidUnescaped_Scalar(Utf8BlockRestart(p, b), end);
+}
+
+#endif // RAPIDJSON_SIMD_SSE42_KERNELS
+
+#ifdef RAPIDJSON_SIMD_KERNELS
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX2 kernels
+//
+// The head is walked byte by byte to 16-byte alignment and, if needed, one more
+// aligned SSE2 block reaches 32-byte alignment for the aligned 256-bit loads.
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline uint32_t WhitespaceMask_AVX2(__m256i s) {
+    __m256i x = _mm256_cmpeq_epi8(s, _mm256_set1_epi8(' '));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\n')));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\r')));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\t')));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(x));
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline uint32_t StringSpecialMask_AVX2(__m256i s) {
+    const __m256i sp = _mm256_set1_epi8(0x1F);
+    const __m256i t1 = _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\"'));
+    const __m256i t2 = _mm256_cmpeq_epi8(s, _mm256_set1_epi8('\\'));
+    const __m256i t3 = _mm256_cmpeq_epi8(_mm256_max_epu8(s, sp), sp); // s < 0x20 <=> max(s, 0x1F) == 0x1F
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(t1, t2), t3)));
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* SkipWhitespace_AVX2(const char* p) {
+    for (const char* nextAligned = SimdAlignUp(p, 16); p != nextAligned; ++p)
+        if (!IsWhitespaceChar(*p))
+            return p;
+
+    if (reinterpret_cast<size_t>(p) & 16) {
+        uint32_t r = ~WhitespaceMask_SSE2(_mm_load_si128(reinterpret_cast<const __m128i *>(p))) & 0xFFFFu;
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+        p += 16;
+    }
+
+    for (;; p += 32) {
+        uint32_t r = ~WhitespaceMask_AVX2(_mm256_load_si256(reinterpret_cast<const __m256i *>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* SkipWhitespace_AVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        uint32_t r = ~WhitespaceMask_AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+    }
+    return SkipWhitespace_SSE2(p, end);
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* ScanUnescaped_AVX2(const char* p) {
+    for (const char* nextAligned = SimdAlignUp(p, 16); p != nextAligned; ++p)
+        if (IsStringSpecialChar(*p))
+            return p;
+
+    if (reinterpret_cast<size_t>(p) & 16) {
+        uint32_t r = StringSpecialMask_SSE2(_mm_load_si128(reinterpret_cast<const __m128i *>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+        p += 16;
+    }
+
+    for (;; p += 32) {
+        uint32_t r = StringSpecialMask_AVX2(_mm256_load_si256(reinterpret_cast<const __m256i *>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* ScanUnescaped_AVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        uint32_t r = StringSpecialMask_AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit(r);
+    }
+    return ScanUnescaped_SSE2(p, end);
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline __m256i Utf8Errors_AVX2(__m256i input, __m256i prev) {
+    const unsigned char* t = Utf8ErrorTables();
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i carried = _mm256_permute2x128_si256(prev, input, 0x21);   // high lane of prev, low lane of input
+    const __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+    const __m256i byte1High = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t))), _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    const __m256i byte1Low = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t + 16))), _mm256_and_si256(prev1, nibble));
+    const __m256i byte2High = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(t + 32))), _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const __m256i pairErrors = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    const __m256i third = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 14), _mm256_set1_epi8(0xE0 - 0x80));
+    const __m256i fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 13), _mm256_set1_epi8(0xF0 - 0x80));
+    const __m256i mustBeContinuation = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(mustBeContinuation, pairErrors);
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* ScanValidUnescaped_AVX2(const char* p) {
+    for (const char* nextAligned = SimdAlignUp(p, 32); p < nextAligned; ) {
+        const unsigned length = ValidUtf8Length(p);
+        if (length == 0)
+            return p;
+        p += length;
+    }
+
+    const char* b = SimdAlignDown(p, 32);
+    const __m256i head = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(SimdHeadMasks() + 32 - (p - b)));
+    const __m256i incomplete = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Utf8IncompleteLimits()));
+    __m256i s = _mm256_blendv_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(b)), _mm256_set1_epi8(' '), head);
+    __m256i prev = _mm256_setzero_si256();
+    for (;;) {
+        const __m256i errors = _mm256_movemask_epi8(s) == 0 ?
+            _mm256_subs_epu8(prev, incomplete) :
+            Utf8Errors_AVX2(s, prev);
+        if (StringSpecialMask_AVX2(s) != 0 || !_mm256_testz_si256(errors, errors))
+            return ScanValidUnescaped_Scalar(Utf8BlockRestart(p, b));
+        prev = s;
+        b += 32;
+        s = _mm256_load_si256(reinterpret_cast<const __m256i *>(b));
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline const char* ScanValidUnescaped_AVX2(const char* p, const char* end) {
+    const __m256i incomplete = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Utf8IncompleteLimits()));
+    __m256i prev = _mm256_setzero_si256();
+    const char* b = p;
+    for (; end - b >= 32; b += 32) {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+        const __m256i errors = _mm256_movemask_epi8(s) == 0 ? _mm256_subs_epu8(prev, incomplete) : Utf8Errors_AVX2(s, prev);
+        if (StringSpecialMask_AVX2(s) != 0 || !_mm256_testz_si256(errors, errors))
+            break;
+        prev = s;
+    }
+    return ScanValidUnescaped_Scalar(Utf8BlockRestart(p, b), end);
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline uint32_t UnescapedMask16_AVX2(__m256i s, __m256i high) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i x = _mm256_or_si256(_mm256_cmpeq_epi16(s, _mm256_set1_epi16('\"')), _mm256_cmpeq_epi16(s, _mm256_set1_epi16('\\')));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi16(_mm256_and_si256(s, _mm256_set1_epi16(~0x1F)), zero));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(x, _mm256_cmpeq_epi16(_mm256_and_si256(s, high), zero))));
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline uint32_t UnescapedMask32_AVX2(__m256i s, __m256i high) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i x = _mm256_or_si256(_mm256_cmpeq_epi32(s, _mm256_set1_epi32('\"')), _mm256_cmpeq_epi32(s, _mm256_set1_epi32('\\')));
+    x = _mm256_or_si256(x, _mm256_cmpeq_epi32(_mm256_and_si256(s, _mm256_set1_epi32(~0x1F)), zero));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(x, _mm256_cmpeq_epi32(_mm256_and_si256(s, high), zero))));
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline size_t ScanUnescaped16_AVX2(const void* p, size_t n, uint32_t highMask) {
+    const __m256i high = _mm256_set1_epi16(static_cast<short>(highMask));
+    const char* b = static_cast<const char*>(p);
+    size_t i = 0;
+    for (; n - i >= 16; i += 16) {
+        uint32_t r = ~UnescapedMask16_AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i * 2)), high);
+        if (r != 0)
+            return i + SimdFirstSetBit(r) / 2;
+    }
+    return i + ScanUnescaped16_SSE2(b + i * 2, n - i, highMask);
+}
+
+RAPIDJSON_SIMD_TARGET("avx2")
+inline size_t ScanUnescaped32_AVX2(const void* p, size_t n, uint32_t highMask) {
+    const __m256i high = _mm256_set1_epi32(static_cast<int>(highMask));
+    const char* b = static_cast<const char*>(p);
+    size_t i = 0;
+    for (; n - i >= 8; i += 8) {
+        uint32_t r = ~UnescapedMask32_AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i * 4)), high);
+        if (r != 0)
+            return i + SimdFirstSetBit(r) / 4;
+    }
+    return i + ScanUnescaped32_SSE2(b + i * 4, n - i, highMask);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX-512BW kernels
+//
+// Masked-off bytes of a masked load never fault, so the head up to 64-byte
+// alignment and the tail of a range are each handled as one partial block.
+
+RAPIDJSON_SIMD_TARGET("avx512f,avx512bw")
+inline uint64_t WhitespaceMask_AVX512(__m512i s) {
+    return _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8(' ')) |
+           _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\n')) |
+           _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\r')) |
+           _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\t'));
+}
+
+RAPIDJSON_SIMD_TARGET("avx512f,avx512bw")
+inline uint64_t StringSpecialMask_AVX512(__m512i s) {
+    return _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\"')) |
+           _mm512_cmpeq_epi8_mask(s, _mm512_set1_epi8('\\')) |
+           _mm512_cmplt_epu8_mask(s, _mm512_set1_epi8(0x20));
+}
+
+//! Mask of the lowest n bytes of a 64-byte block, 0 < n < 64.
+inline uint64_t SimdLowBytesMask(size_t n) {
+    RAPIDJSON_ASSERT(n > 0 && n < 64);
+    return (static_cast<uint64_t>(1) << n) - 1;
+}
+
+RAPIDJSON_SIMD_TARGET("avx512f,avx512bw")
+inline const char* SkipWhitespace_AVX512(const char* p) {
+    const size_t head = static_cast<size_t>(SimdAlignUp(p, 64) - p);
+    if (head != 0) {
+        const uint64_t k = SimdLowBytesMask(head);
+        uint64_t r = ~WhitespaceMask_AVX512(_mm512_maskz_loadu_epi8(k, p)) & k;
+        if (r != 0)
+            return p + SimdFirstSetBit64(r);
+        p += head;
+    }
+
+    for (;; p += 64) {
+        uint64_t r = ~WhitespaceMask_AVX512(_mm512_load_si512(reinterpret_cast<const void*>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit64(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("avx512f,avx512bw")
+inline const char* SkipWhitespace_AVX512(const char* p, const char* end) {
+    for (; end - p >= 64; p += 64) {
+        uint64_t r = ~WhitespaceMask_AVX512(_mm512_loadu_si512(reinterpret_cast<const void*>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit64(r);
+    }
+    if (p == end)
+        return p;
+
+    const uint64_t k = SimdLowBytesMask(static_cast<size_t>(end - p));
+    uint64_t r = ~WhitespaceMask_AVX512(_mm512_maskz_loadu_epi8(k, p)) & k;
+    return r != 0 ? p + SimdFirstSetBit64(r) : end;
+}
+
+RAPIDJSON_SIMD_TARGET("avx512f,avx512bw")
+inline const char* ScanUnescaped_AVX512(const char* p) {
+    const size_t head = static_cast<size_t>(SimdAlignUp(p, 64) - p);
+    if (head != 0) {
+        const uint64_t k = SimdLowBytesMask(head);
+        uint64_t r = StringSpecialMask_AVX512(_mm512_maskz_loadu_epi8(k, p)) & k;
+        if (r != 0)
+            return p + SimdFirstSetBit64(r);
+        p += head;
+    }
+
+    for (;; p += 64) {
+        uint64_t r = StringSpecialMask_AVX512(_mm512_load_si512(reinterpret_cast<const void*>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit64(r);
+    }
+}
+
+RAPIDJSON_SIMD_TARGET("avx512f,avx512bw")
+inline const char* ScanUnescaped_AVX512(const char* p, const char* end) {
+    for (; end - p >= 64; p += 64) {
+        uint64_t r = StringSpecialMask_AVX512(_mm512_loadu_si512(reinterpret_cast<const void*>(p)));
+        if (r != 0)
+            return p + SimdFirstSetBit64(r);
+    }
+    if (p == end)
+        return p;
+
+    const uint64_t k = SimdLowBytesMask(static_cast<size_t>(end - p));
+    uint64_t r = StringSpecialMask_AVX512(_mm512_maskz_loadu_epi8(k, p)) & k;
+    return r != 0 ? p + SimdFirstSetBit64(r) : end;
+}
+
+//! The tail of fewer units than a vector is one masked block, so all n units are scanned.
+RAPIDJSON_SIMD_TARGET("avx512f,avx512bw")
+inline size_t ScanUnescaped16_AVX512(const void* p, size_t n, uint32_t highMask) {
+    const __m512i high = _mm512_set1_epi16(static_cast<short>(highMask));
+    const __m512i low = _mm512_set1_epi16(~0x1F);
+    const uint16_t* u = static_cast<const uint16_t*>(p);
+    for (size_t i = 0; i < n; i += 32) {
+        const __mmask32 k = n - i >= 32 ? ~static_cast<__mmask32>(0) : static_cast<__mmask32>(SimdLowBytesMask(n - i));
+        const __m512i s = _mm512_maskz_loadu_epi16(k, u + i);
+        const uint32_t r = (_mm512_cmpeq_epi16_mask(s, _mm512_set1_epi16('\"')) |
+                            _mm512_cmpeq_epi16_mask(s, _mm512_set1_epi16('\\')) |
+                            _mm512_testn_epi16_mask(s, low) |
+                            _mm512_test_epi16_mask(s, high)) & k;
+        if (r != 0)
+            return i + SimdFirstSetBit(r);
+    }
+    return n;
+}
+
+RAPIDJSON_SIMD_TARGET("avx512f,avx512bw")
+inline size_t ScanUnescaped32_AVX512(const void* p, size_t n, uint32_t highMask) {
+    const __m512i high = _mm512_set1_epi32(static_cast<int>(highMask));
+    const __m512i low = _mm512_set1_epi32(~0x1F);
+    const uint32_t* u = static_cast<const uint32_t*>(p);
+    for (size_t i = 0; i < n; i += 16) {
+        const __mmask16 k = n - i >= 16 ? static_cast<__mmask16>(0xFFFF) : static_cast<__mmask16>(SimdLowBytesMask(n - i));
+        const __m512i s = _mm512_maskz_loadu_epi32(k, u + i);
+        const uint32_t r = static_cast<uint32_t>(_mm512_cmpeq_epi32_mask(s, _mm512_set1_epi32('\"')) |
+                                                 _mm512_cmpeq_epi32_mask(s, _mm512_set1_epi32('\\')) |
+                                                 _mm512_testn_epi32_mask(s, low) |
+                                                 _mm512_test_epi32_mask(s, high)) & k;
+        if (r != 0)
+            return i + SimdFirstSetBit(r);
+    }
+    return n;
+}
+
+#endif // RAPIDJSON_SIMD_KERNELS
+
+#ifdef RAPIDJSON_SIMD_DISPATCH
+
+///////////////////////////////////////////////////////////////////////////////
+// CPU feature detection
+
+//! Instruction set levels with a kernel family, in increasing order of preference.
+enum SimdLevel {
+    kSimdScalar = 0,    //!< Portable C++ only.
+    kSimdSSE2,          //!< SSE2.
+    kSimdSSE42,         //!< SSE4.2.
+    kSimdAVX2,          //!< AVX2.
+    kSimdAVX512BW       //!< AVX-512 Foundation and Byte/Word instructions.
+};
+
+inline void Cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++)
+        regs[i] = static_cast<unsigned>(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+//! Register state enabled by the operating system (XCR0).
+inline uint64_t Xgetbv0() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+//! Query the best kernel family supported by the running CPU.
+inline SimdLevel DetectSimdLevel() {
+    unsigned regs[4];
+    Cpuid(0, 0, regs);
+    const unsigned maxLeaf = regs[0];
+    if (maxLeaf < 1)
+        return kSimdScalar;
+
+    Cpuid(1, 0, regs);
+    const bool sse2 = (regs[3] & (1u << 26)) != 0;
+    const bool sse42 = (regs[2] & (1u << 20)) != 0;
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+    if (!sse2)
+        return kSimdScalar;
+    if (!sse42)
+        return kSimdSSE2;
+    if (maxLeaf < 7 || !osxsave || !avx)
+        return kSimdSSE42;
+
+    // The OS must save the YMM (bits 1-2) and opmask/ZMM (bits 5-7) state.
+    const uint64_t xcr0 = Xgetbv0();
+    Cpuid(7, 0, regs);
+    const bool avx2 = (xcr0 & 0x6) == 0x6 && (regs[1] & (1u << 5)) != 0;
+    const bool avx512bw = (xcr0 & 0xE6) == 0xE6 && (regs[1] & (1u << 16)) != 0 && (regs[1] & (1u << 30)) != 0;
+    if (avx2 && avx512bw)
+        return kSimdAVX512BW;
+    return avx2 ? kSimdAVX2 : kSimdSSE42;
+}
+
+inline const char* GetSimdLevelName(SimdLevel level) {
+    switch (level) {
+    case kSimdSSE2:     return "SSE2";
+    case kSimdSSE42:    return "SSE4.2";
+    case kSimdAVX2:     return "AVX2";
+    case kSimdAVX512BW: return "AVX-512BW";
+    default:            return "Scalar";
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Dispatch table
+
+//! Kernels bound for the running CPU.
+struct SimdKernels {
+    const char* (*skipWhitespace)(const char* p);
+    const char* (*skipWhitespaceRange)(const char* p, const char* end);
+    const char* (*scanUnescaped)(const char* p);
+    const char* (*scanUnescapedRange)(const char* p, const char* end);
+    const char* (*scanValidUnescaped)(const char* p);
+    const char* (*scanValidUnescapedRange)(const char* p, const char* end);
+    size_t (*scanUnescaped16)(const void* p, size_t n, uint32_t highMask);
+    size_t (*scanUnescaped32)(const void* p, size_t n, uint32_t highMask);
+};
+
+inline const char* SkipWhitespace_Resolve(const char* p);
+inline const char* SkipWhitespace_Resolve(const char* p, const char* end);
+inline const char* ScanUnescaped_Resolve(const char* p);
+inline const char* ScanUnescaped_Resolve(const char* p, const char* end);
+inline const char* ScanValidUnescaped_Resolve(const char* p);
+inline const char* ScanValidUnescaped_Resolve(const char* p, const char* end);
+inline size_t ScanUnescaped16_Resolve(const void* p, size_t n, uint32_t highMask);
+inline size_t ScanUnescaped32_Resolve(const void* p, size_t n, uint32_t highMask);
+
+//! Process-wide kernel tables.
+/*! There is a constant table for each level, and one of resolver stubs, which
+    is current until the first call detects the CPU and publishes the table for
+    it. Tables are never written, and with C++11 the current one is published
+    through an atomic pointer, so threads may parse concurrently from the start.
+    Without C++11, call GetSimdLevel() once at startup before spawning threads.
+    \note Class template so that the static members can be defined in a header.
+*/
+template <typename T = void>
+struct SimdDispatch {
+    static const SimdKernels& Kernels() {
+#if RAPIDJSON_HAS_CXX11_THREADS
+        return *current.load(std::memory_order_acquire);
+#else
+        return *current;
+#endif
+    }
+
+    static void Bind(SimdLevel l) {
+#if RAPIDJSON_HAS_CXX11_THREADS
+        current.store(&tables[l], std::memory_order_release);
+#else
+        current = &tables[l];
+#endif
+    }
+
+    static void Resolve() {
+        if (&Kernels() == &resolver)
+            Bind(DetectSimdLevel());
+    }
+
+    //! Level of the current table, which must not be the resolver.
+    static SimdLevel Level() {
+        RAPIDJSON_ASSERT(&Kernels() != &resolver);
+        return static_cast<SimdLevel>(&Kernels() - tables);
+    }
+
+    static const SimdKernels resolver;
+    static const SimdKernels tables[kSimdAVX512BW + 1];
+#if RAPIDJSON_HAS_CXX11_THREADS
+    static std::atomic<const SimdKernels*> current;
+#else
+    static const SimdKernels* current;
+#endif
+};
+
+template <typename T>
+const SimdKernels SimdDispatch<T>::resolver = {
+    &SkipWhitespace_Resolve, &SkipWhitespace_Resolve, &ScanUnescaped_Resolve, &ScanUnescaped_Resolve,
+    &ScanValidUnescaped_Resolve, &ScanValidUnescaped_Resolve, &ScanUnescaped16_Resolve, &ScanUnescaped32_Resolve
+};
+
+template <typename T>
+const SimdKernels SimdDispatch<T>::tables[kSimdAVX512BW + 1] = {
+    {   // kSimdScalar
+        &SkipWhitespace_Scalar, &SkipWhitespace_Scalar, &ScanUnescaped_Scalar, &ScanUnescaped_Scalar,
+        &ScanValidUnescaped_Scalar, &ScanValidUnescaped_Scalar, &ScanUnescapedWide_Scalar, &ScanUnescapedWide_Scalar
+    },
+    {   // kSimdSSE2
+        &SkipWhitespace_SSE2, &SkipWhitespace_SSE2, &ScanUnescaped_SSE2, &ScanUnescaped_SSE2,
+        &ScanValidUnescaped_Scalar, &ScanValidUnescaped_Scalar, &ScanUnescaped16_SSE2, &ScanUnescaped32_SSE2
+    },
+    {   // kSimdSSE42: string scanning reuses SSE2
+        &SkipWhitespace_SSE42, &SkipWhitespace_SSE42, &ScanUnescaped_SSE2, &ScanUnescaped_SSE2,
+        &ScanValidUnescaped_SSE42, &ScanValidUnescaped_SSE42, &ScanUnescaped16_SSE2, &ScanUnescaped32_SSE2
+    },
+    {   // kSimdAVX2
+        &SkipWhitespace_AVX2, &SkipWhitespace_AVX2, &ScanUnescaped_AVX2, &ScanUnescaped_AVX2,
+        &ScanValidUnescaped_AVX2, &ScanValidUnescaped_AVX2, &ScanUnescaped16_AVX2, &ScanUnescaped32_AVX2
+    },
+    {   // kSimdAVX512BW: validation keeps AVX2
+        &SkipWhitespace_AVX512, &SkipWhitespace_AVX512, &ScanUnescaped_AVX512, &ScanUnescaped_AVX512,
+        &ScanValidUnescaped_AVX2, &ScanValidUnescaped_AVX2, &ScanUnescaped16_AVX512, &ScanUnescaped32_AVX512
+    }
+};
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+template <typename T>
+std::atomic<const SimdKernels*> SimdDispatch<T>::current(&SimdDispatch<T>::resolver);
+#else
+template <typename T>
+const SimdKernels* SimdDispatch<T>::current = &SimdDispatch<T>::resolver;
+#endif
+
+inline const char* SkipWhitespace_Resolve(const char* p) {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Kernels().skipWhitespace(p);
+}
+
+inline const char* SkipWhitespace_Resolve(const char* p, const char* end) {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Kernels().skipWhitespaceRange(p, end);
+}
+
+inline const char* ScanUnescaped_Resolve(const char* p) {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Kernels().scanUnescaped(p);
+}
+
+inline const char* ScanUnescaped_Resolve(const char* p, const char* end) {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Kernels().scanUnescapedRange(p, end);
+}
+
+inline const char* ScanValidUnescaped_Resolve(const char* p) {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Kernels().scanValidUnescaped(p);
+}
+
+inline const char* ScanValidUnescaped_Resolve(const char* p, const char* end) {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Kernels().scanValidUnescapedRange(p, end);
+}
+
+inline size_t ScanUnescaped16_Resolve(const void* p, size_t n, uint32_t highMask) {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Kernels().scanUnescaped16(p, n, highMask);
+}
+
+inline size_t ScanUnescaped32_Resolve(const void* p, size_t n, uint32_t highMask) {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Kernels().scanUnescaped32(p, n, highMask);
+}
+
+//! Kernel family currently bound, detecting the CPU if nothing is bound yet.
+inline SimdLevel GetSimdLevel() {
+    SimdDispatch<>::Resolve();
+    return SimdDispatch<>::Level();
+}
+
+//! Force a kernel family, e.g. to test or benchmark a narrower one.
+/*! \return false, leaving the binding unchanged, if the CPU does not support \c level.
+    \note Threads parsing or writing meanwhile switch to the new kernels from their next call.
+*/
+inline bool SetSimdLevel(SimdLevel level) {
+    if (level > DetectSimdLevel())
+        return false;
+    SimdDispatch<>::Bind(level);
+    return true;
+}
+
+#endif // RAPIDJSON_SIMD_DISPATCH
+
+#ifdef RAPIDJSON_SIMD_KERNELS
+
+///////////////////////////////////////////////////////////////////////////////
+// Entry points for the reader and writer: the bound kernel with dispatch,
+// otherwise the widest family enabled at compile time.
+
+inline const char* SimdSkipWhitespace(const char* p) {
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    return SimdDispatch<>::Kernels().skipWhitespace(p);
+#elif defined(RAPIDJSON_AVX512)
+    return SkipWhitespace_AVX512(p);
+#else
+    return SkipWhitespace_AVX2(p);
+#endif
+}
+
+inline const char* SimdSkipWhitespace(const char* p, const char* end) {
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    return SimdDispatch<>::Kernels().skipWhitespaceRange(p, end);
+#elif defined(RAPIDJSON_AVX512)
+    return SkipWhitespace_AVX512(p, end);
+#else
+    return SkipWhitespace_AVX2(p, end);
+#endif
+}
+
+inline const char* SimdScanUnescaped(const char* p) {
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    return SimdDispatch<>::Kernels().scanUnescaped(p);
+#elif defined(RAPIDJSON_AVX512)
+    return ScanUnescaped_AVX512(p);
+#else
+    return ScanUnescaped_AVX2(p);
+#endif
+}
+
+inline const char* SimdScanUnescaped(const char* p, const char* end) {
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    return SimdDispatch<>::Kernels().scanUnescapedRange(p, end);
+#elif defined(RAPIDJSON_AVX512)
+    return ScanUnescaped_AVX512(p, end);
+#else
+    return ScanUnescaped_AVX2(p, end);
+#endif
+}
+
+//! The AVX-512BW family keeps the 32-byte AVX2 validator.
+inline const char* SimdScanValidUnescaped(const char* p) {
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    return SimdDispatch<>::Kernels().scanValidUnescaped(p);
+#else
+    return ScanValidUnescaped_AVX2(p);
+#endif
+}
+
+inline const char* SimdScanValidUnescaped(const char* p, const char* end) {
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    return SimdDispatch<>::Kernels().scanValidUnescapedRange(p, end);
+#else
+    return ScanValidUnescaped_AVX2(p, end);
+#endif
+}
+
+//! Number of 16-bit units at p which need no escaping, in whole vectors; the caller scans the rest.
+inline size_t SimdScanUnescaped16(const void* p, size_t n, uint32_t highMask) {
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    return SimdDispatch<>::Kernels().scanUnescaped16(p, n, highMask);
+#elif defined(RAPIDJSON_AVX512)
+    return ScanUnescaped16_AVX512(p, n, highMask);
+#else
+    return ScanUnescaped16_AVX2(p, n, highMask);
+#endif
+}
+
+//! Number of 32-bit units at p which need no escaping, in whole vectors; the caller scans the rest.
+inline size_t SimdScanUnescaped32(const void* p, size_t n, uint32_t highMask) {
+#if defined(RAPIDJSON_SIMD_DISPATCH)
+    return SimdDispatch<>::Kernels().scanUnescaped32(p, n, highMask);
+#elif defined(RAPIDJSON_AVX512)
+    return ScanUnescaped32_AVX512(p, n, highMask);
+#else
+    return ScanUnescaped32_AVX2(p, n, highMask);
+#endif
+}
+
+#endif // RAPIDJSON_SIMD_KERNELS
+
+} // namespace internal
+RAPIDJSON_NAMESPACE_END
+
+#endif // RAPIDJSON_INTERNAL_SIMD_H_
@@ -127,6 +127,78 @@ inline bool StrtodFast(double d, int p, double* result) {
         return false;
 }
 
+// Eisel-Lemire: w * 10^q correctly rounded from a 128-bit product, for normal results.
+// Returns false if the truncated product cannot decide the rounding.
+// see https://nigeltao.github.io/blog/2020/eisel-lemire.html
+inline bool StrtodEiselLemire(uint64_t w, int q, double* result) {
+    RAPIDJSON_ASSERT(w != 0);
+    if (q < kPow10Significand128MinExp || q > kPow10Significand128MaxExp)
+        return false;
+
+    // Normalization
+    const DiyFp v = DiyFp(w, 0).Normalize();
+    w = v.f;
+    int exp2 = ((217706 * q) >> 16) + 64 + 0x3FF + v.e; // 217706 / 2^16 ~= log2(10), 0x3FF: exponent bias
+
+    // Multiplication, widened to 192 bits if the low bits of the 128-bit product may carry into the mantissa
+    const uint64_t* pow10 = Pow10Significand128(q);
+    uint64_t hi, lo = Umul128(w, pow10[0], &hi);
+    if ((hi & 0x1FF) == 0x1FF && lo + w < w) {
+        uint64_t yHi, yLo = Umul128(w, pow10[1], &yHi);
+        uint64_t mergedHi = hi, mergedLo = lo + yHi;
+        if (mergedLo < lo)
+            mergedHi++;
+        if ((mergedHi & 0x1FF) == 0x1FF && mergedLo + 1 == 0 && yLo + w < w)
+            return false;
+        hi = mergedHi;
+        lo = mergedLo;
+    }
+
+    // Shift to 54 bits
+    const int msb = static_cast<int>(hi >> 63);
+    uint64_t mantissa = hi >> (msb + 9);
+    exp2 -= 1 ^ msb;
+
+    // Halfway between two doubles: the truncated tail decides
+    if (lo == 0 && (hi & 0x1FF) == 0 && (mantissa & 3) == 1)
+        return false;
+
+    // Round to 53 bits
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >> 53) {
+        mantissa >>= 1;
+        exp2++;
+    }
+
+    // Subnormal, infinity and NaN are left to the slow path
+    if (exp2 <= 0 || exp2 >= 0x7FF)
+        return false;
+
+    *result = Double((static_cast<uint64_t>(exp2) << 52) | (mantissa & RAPIDJSON_UINT64_C2(0x000FFFFF, 0xFFFFFFFF))).Value();
+    return true;
+}
+
+// Eisel-Lemire on up to 19 leading decimal digits. The value of longer inputs
+// lies between the truncated digits and the next 19-digit number, and is
+// decided only if both round to the same double.
+inline bool StrtodEiselLemire(const char* decimals, int dLen, int dExp, double* result) {
+    const int kMaxDigits = 19;  // 10^19 - 1 < 2^64
+    uint64_t w = 0;
+    const int n = dLen < kMaxDigits ? dLen : kMaxDigits;
+    for (int i = 0; i < n; i++)
+        w = w * 10u + static_cast<unsigned>(decimals[i] - '0');
+    const int q = dExp + dLen - n;
+
+    if (!StrtodEiselLemire(w, q, result))
+        return false;
+    if (dLen <= kMaxDigits)
+        return true;
+
+    double upper;
+    return StrtodEiselLemire(w + 1, q, &upper) && Double(upper).Uint64Value() == Double(*result).Uint64Value();
+}
+
 // Compute an approximation and see if it is within 1/2 ULP
 inline bool StrtodDiyFp(const char* decimals, int dLen, int dExp, double* result) {
     uint64_t significand = 0;
@@ -277,6 +349,9 @@ inline double StrtodFullPrecision(double d, int p, const char* decimals, size_t
     if (dLen + dExp > 309)
         return std::numeric_limits<double>::infinity();
 
+    if (StrtodEiselLemire(decimals, dLen, dExp, &result))
+        return result;
+
     if (StrtodDiyFp(decimals, dLen, dExp, &result))
         return result;
 
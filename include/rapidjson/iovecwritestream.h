@@ -0,0 +1,284 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_IOVECWRITESTREAM_H_
+#define RAPIDJSON_IOVECWRITESTREAM_H_
+
+/*! \file iovecwritestream.h */
+
+#include "stream.h"
+#include "internal/stack.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+//! Byte stream for output into a list of \c iovec, written with writev().
+/*! Unlike StringBuffer, which copies all the output into one buffer, the stream
+    copies the small pieces, such as punctuation, numbers and short strings,
+    into blocks, and only refers to the long runs of a string which need no
+    escaping, and to raw values, where they are. Writer hands over these runs
+    with PutBlockUnsafe().
+
+    Flush() writes the list to the file descriptor with writev(), then clears
+    it, keeping the blocks for the next output. Writer flushes at the end of
+    each root value, so the strings written must not change or be freed
+    before, e.g. the Document given to Accept() is kept until it returns.
+
+    \code
+    IoVecWriteStream os(fd);
+    Writer<IoVecWriteStream> writer(os);
+    d.Accept(writer);
+    if (os.HasError())
+        ...
+    \endcode
+
+    With no file descriptor, Flush() keeps the list, which is got with
+    GetIoVecs() and sent by other means, then cleared with Clear().
+
+    \tparam Allocator type for allocating the blocks and the list.
+    \note implements Stream concept
+*/
+template <typename Allocator = CrtAllocator>
+class GenericIoVecWriteStream {
+public:
+    typedef char Ch;    //!< Character type. Only support char.
+
+    static const size_t kDefaultMinReferenceSize = 128;
+    static const size_t kDefaultBlockSize = 16384;
+
+    //! Constructor.
+    /*!
+        \param fd File descriptor written by Flush(), or -1 to keep the list.
+        \param minReferenceSize Runs of at least this many bytes are referred to, shorter ones are copied.
+        \param blockSize Size of each block for the copied bytes.
+        \param allocator Allocator for the blocks and the list. A new one is created if null.
+    */
+    explicit GenericIoVecWriteStream(int fd = -1, size_t minReferenceSize = kDefaultMinReferenceSize, size_t blockSize = kDefaultBlockSize, Allocator* allocator = 0) :
+        fd_(fd), minReferenceSize_(minReferenceSize), blockSize_(blockSize),
+        iovecs_(allocator, kDefaultIoVecCapacity * sizeof(struct iovec)), blocks_(allocator, kDefaultBlockCapacity * sizeof(Ch*)),
+        blockCount_(0), current_(0), runBegin_(0), blockEnd_(0),
+        size_(0), copiedSize_(0), referencedSize_(0), error_(false)
+    {
+        RAPIDJSON_ASSERT(blockSize > 0);
+    }
+
+    ~GenericIoVecWriteStream() {
+        for (size_t i = 0; i < blocks_.GetSize() / sizeof(Ch*); i++)
+            Allocator::Free(blocks_.template Bottom<Ch*>()[i]);
+    }
+
+    void Put(Ch c) {
+        if (RAPIDJSON_UNLIKELY(current_ == blockEnd_))
+            NextBlock();
+        *current_++ = c;
+    }
+
+    void PutN(Ch c, size_t n) {
+        while (n > 0) {
+            if (current_ == blockEnd_)
+                NextBlock();
+            const size_t count = n < static_cast<size_t>(blockEnd_ - current_) ? n : static_cast<size_t>(blockEnd_ - current_);
+            std::memset(current_, c, count);
+            current_ += count;
+            n -= count;
+        }
+    }
+
+    //! Puts \c n bytes, referring to them if they are at least the minimum reference size.
+    /*! \note The bytes must be kept until the list is written or cleared.
+    */
+    void PutBlock(const Ch* str, size_t n) {
+        if (n >= minReferenceSize_)
+            Reference(str, n);
+        else
+            Copy(str, n);
+    }
+
+    //! Writes the list to the file descriptor, if any, and clears it.
+    void Flush() {
+        if (fd_ < 0)
+            return;
+        EndRun();
+        struct iovec* iov = iovecs_.template Bottom<struct iovec>();
+        size_t count = iovecs_.GetSize() / sizeof(struct iovec);
+        while (count > 0 && !error_) {
+            const ssize_t result = writev(fd_, iov, static_cast<int>(count < kMaxIoVecs ? count : kMaxIoVecs));
+            if (result < 0) {
+                if (errno != EINTR)
+                    error_ = true;
+                continue;
+            }
+            // Skip what was written, which may end in the middle of a buffer.
+            size_t written = static_cast<size_t>(result);
+            while (count > 0 && written >= iov->iov_len) {
+                written -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+                iov->iov_len -= written;
+            }
+        }
+        Clear();
+    }
+
+    //! Clears the list, keeping the blocks for the next output.
+    void Clear() {
+        EndRun();
+        iovecs_.Clear();
+        blockCount_ = 0;
+        current_ = runBegin_ = blockEnd_ = 0;
+        size_ = 0;
+    }
+
+    //! Get the list of buffers of the output.
+    const struct iovec* GetIoVecs() {
+        EndRun();
+        return iovecs_.template Bottom<struct iovec>();
+    }
+
+    //! Get the number of buffers in the list.
+    size_t GetIoVecCount() {
+        EndRun();
+        return iovecs_.GetSize() / sizeof(struct iovec);
+    }
+
+    //! Number of bytes in the list.
+    size_t GetSize() const { return size_ + static_cast<size_t>(current_ - runBegin_); }
+
+    //! Number of bytes copied into the blocks since construction.
+    size_t GetCopiedSize() const { return copiedSize_ + static_cast<size_t>(current_ - runBegin_); }
+
+    //! Number of bytes referred to where they are since construction.
+    size_t GetReferencedSize() const { return referencedSize_; }
+
+    //! Whether writev() failed. The output is dropped after a failure.
+    bool HasError() const { return error_; }
+
+    // Not implemented
+    char Peek() const { RAPIDJSON_ASSERT(false); return 0; }
+    char Take() { RAPIDJSON_ASSERT(false); return 0; }
+    size_t Tell() const { RAPIDJSON_ASSERT(false); return 0; }
+    char* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+    size_t PutEnd(char*) { RAPIDJSON_ASSERT(false); return 0; }
+
+private:
+    // Prohibit copy constructor & assignment operator.
+    GenericIoVecWriteStream(const GenericIoVecWriteStream&);
+    GenericIoVecWriteStream& operator=(const GenericIoVecWriteStream&);
+
+    // Adds the bytes copied since the last buffer of the list as a buffer.
+    void EndRun() {
+        if (current_ != runBegin_) {
+            AddIoVec(runBegin_, static_cast<size_t>(current_ - runBegin_));
+            copiedSize_ += static_cast<size_t>(current_ - runBegin_);
+            runBegin_ = current_;
+        }
+    }
+
+    void AddIoVec(Ch* base, size_t length) {
+        struct iovec* iov = iovecs_.template Push<struct iovec>();
+        iov->iov_base = base;
+        iov->iov_len = length;
+        size_ += length;
+    }
+
+    // Moves to the next block, reusing the blocks of the previous output.
+    void NextBlock() {
+        EndRun();
+        if (blockCount_ == blocks_.GetSize() / sizeof(Ch*)) {
+            Ch** block = blocks_.template Push<Ch*>();
+            *block = static_cast<Ch*>(blocks_.GetAllocator().Malloc(blockSize_));
+        }
+        current_ = runBegin_ = blocks_.template Bottom<Ch*>()[blockCount_++];
+        blockEnd_ = current_ + blockSize_;
+    }
+
+    void Copy(const Ch* str, size_t n) {
+        while (n > 0) {
+            if (current_ == blockEnd_)
+                NextBlock();
+            const size_t count = n < static_cast<size_t>(blockEnd_ - current_) ? n : static_cast<size_t>(blockEnd_ - current_);
+            std::memcpy(current_, str, count);
+            current_ += count;
+            str += count;
+            n -= count;
+        }
+    }
+
+    void Reference(const Ch* str, size_t n) {
+        EndRun();
+        AddIoVec(const_cast<Ch*>(str), n);
+        referencedSize_ += n;
+    }
+
+#ifdef IOV_MAX
+    static const size_t kMaxIoVecs = IOV_MAX;
+#else
+    static const size_t kMaxIoVecs = 16;
+#endif
+    static const size_t kDefaultIoVecCapacity = 64;
+    static const size_t kDefaultBlockCapacity = 16;
+
+    int fd_;
+    size_t minReferenceSize_;
+    size_t blockSize_;
+    internal::Stack<Allocator> iovecs_; //!< The list of buffers.
+    internal::Stack<Allocator> blocks_; //!< All the blocks allocated.
+    size_t blockCount_;                 //!< Number of blocks in use.
+    Ch* current_;
+    Ch* runBegin_;                      //!< First byte copied which is not in the list yet.
+    Ch* blockEnd_;
+    size_t size_;
+    size_t copiedSize_;
+    size_t referencedSize_;
+    bool error_;
+};
+
+typedef GenericIoVecWriteStream<> IoVecWriteStream;
+
+//! Implement specialized version of PutN() with memset() for better performance.
+template<typename Allocator>
+inline void PutN(GenericIoVecWriteStream<Allocator>& stream, char c, size_t n) {
+    stream.PutN(c, n);
+}
+
+//! Implement specialized version of PutBlockUnsafe() which refers to long runs where they are.
+template<typename Allocator>
+inline void PutBlockUnsafe(GenericIoVecWriteStream<Allocator>& stream, const char* str, size_t n) {
+    stream.PutBlock(str, n);
+}
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // defined(__unix__) || defined(__APPLE__)
+
+#endif // RAPIDJSON_IOVECWRITESTREAM_H_
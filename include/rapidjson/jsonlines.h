@@ -0,0 +1,376 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_JSONLINES_H_
+#define RAPIDJSON_JSONLINES_H_
+
+/*! \file jsonlines.h */
+
+#include "document.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+//! Parallel parser for newline-delimited JSON (JSON Lines, NDJSON).
+/*! The input, a memory buffer or a file, is split into chunks which end at a
+    newline. Worker threads take the next chunk as soon as they are done with
+    the previous one, and parse each line of it into a document. Every chunk has
+    its own copy of the text, in which the lines are parsed in situ, and its own
+    allocator, so the workers share nothing but the position in the input.
+
+    The documents are passed to a callback with the offset of their line in the
+    input:
+
+    \code
+    struct Callback {
+        bool operator()(size_t offset, Document& record) {
+            if (record.HasParseError())
+                ...  // record.GetErrorOffset() is relative to offset
+            return true; // false to stop
+        }
+    };
+    \endcode
+
+    By default the records are delivered in input order, one at a time. The
+    workers then run at most two chunks per thread ahead of the delivery. With
+    SetOrdered(false), each worker calls the callback for its own chunk as soon
+    as it is parsed, so the callback is called concurrently and must be
+    thread-safe.
+
+    A record and the strings in it are only valid during the call. Blank lines
+    are skipped, and a trailing \c '\\r' is treated as whitespace.
+
+    \tparam Encoding Encoding of the input and the documents, with 8-bit code units.
+    \tparam Allocator Allocator of each chunk's documents, which must provide \c Clear().
+    \tparam StackAllocator Allocator for the documents' parsing stacks.
+    \note Requires C++11 threads (\ref RAPIDJSON_HAS_CXX11_THREADS).
+*/
+template <typename Encoding, typename Allocator = MemoryPoolAllocator<>, typename StackAllocator = CrtAllocator>
+class GenericJsonLinesParser {
+public:
+    typedef typename Encoding::Ch Ch; //!< Character type derived from Encoding.
+    typedef GenericDocument<Encoding, Allocator, StackAllocator> DocumentType; //!< Document type of the records.
+
+    //! Constructor.
+    /*! \param threadCount Number of threads, including the calling thread. 0 for one per hardware thread.
+        \param chunkSize Size of the chunks in bytes, extended to the end of the line.
+    */
+    GenericJsonLinesParser(unsigned threadCount = 0, size_t chunkSize = kDefaultChunkSize) :
+        threadCount_(threadCount ? threadCount : std::thread::hardware_concurrency()), chunkSize_(chunkSize), ordered_(true),
+        chunks_(), mutex_(), slotFree_(), input_(), length_(), position_(), fp_(), carry_(), eof_(),
+        nextChunk_(), delivered_(), delivering_(), readError_(), stopped_(false)
+    {
+        RAPIDJSON_STATIC_ASSERT(sizeof(Ch) == 1);
+        RAPIDJSON_ASSERT(chunkSize > 0);
+        if (threadCount_ == 0)
+            threadCount_ = 1;
+    }
+
+    //! Get the number of threads, including the calling thread.
+    unsigned GetThreadCount() const { return threadCount_; }
+
+    //! Set whether the records are delivered in input order, one at a time (the default).
+    GenericJsonLinesParser& SetOrdered(bool ordered) { ordered_ = ordered; return *this; }
+
+    //! Whether the records are delivered in input order.
+    bool IsOrdered() const { return ordered_; }
+
+    //! Parse the lines of a memory buffer.
+    /*! \tparam parseFlags Combination of \ref ParseFlag, for each line.
+        \param json The text, which need not be null-terminated.
+        \param length Length of the text in bytes.
+        \param callback Called with the offset and the document of each record.
+        \return Whether all records were delivered, i.e. the callback did not stop.
+    */
+    template <unsigned parseFlags, typename Callback>
+    bool Parse(const Ch* json, size_t length, Callback& callback) {
+        RAPIDJSON_ASSERT(json || length == 0);
+        Init();
+        input_ = json;
+        length_ = length;
+        Run<parseFlags>(callback);
+        input_ = 0;
+        return !stopped_;
+    }
+
+    //! Parse the lines of a memory buffer (with \ref kParseDefaultFlags)
+    template <typename Callback>
+    bool Parse(const Ch* json, size_t length, Callback& callback) {
+        return Parse<kParseDefaultFlags>(json, length, callback);
+    }
+
+    //! Parse the lines of a file, read from its current position to its end.
+    /*! The file is read by the workers one chunk at a time.
+        \tparam parseFlags Combination of \ref ParseFlag, for each line.
+        \param fp File opened for reading, in binary mode.
+        \param callback Called with the offset from the starting position and the document of each record.
+        \return Whether all records were delivered, i.e. the callback did not stop and the file could be read.
+    */
+    template <unsigned parseFlags, typename Callback>
+    bool ParseFile(std::FILE* fp, Callback& callback) {
+        RAPIDJSON_ASSERT(fp != 0);
+        Init();
+        fp_ = fp;
+        Run<parseFlags>(callback);
+        fp_ = 0;
+        return !stopped_;
+    }
+
+    //! Parse the lines of a file (with \ref kParseDefaultFlags)
+    template <typename Callback>
+    bool ParseFile(std::FILE* fp, Callback& callback) {
+        return ParseFile<kParseDefaultFlags>(fp, callback);
+    }
+
+    //! Whether the last ParseFile() failed to read the file.
+    bool HasReadError() const { return readError_; }
+
+private:
+    // Prohibit copy constructor & assignment operator.
+    GenericJsonLinesParser(const GenericJsonLinesParser&);
+    GenericJsonLinesParser& operator=(const GenericJsonLinesParser&);
+
+    //! Lines of the input parsed by one worker, with the documents kept until delivery.
+    struct Chunk {
+        Chunk() : text(), offset(), end(), allocator(), documents(), offsets(), count(), ready() {}
+
+        std::vector<Ch> text;   //!< Copy of the lines, each null-terminated when parsed.
+        size_t offset;          //!< Offset of the text in the input.
+        size_t end;             //!< End of the text in a memory input.
+        Allocator allocator;
+        std::vector<DocumentType> documents;    //!< Reused from chunk to chunk.
+        std::vector<size_t> offsets;
+        size_t count;           //!< Number of records in documents.
+        bool ready;             //!< Parsed, waiting for the delivery of the previous chunks.
+    };
+
+    void Init() {
+        position_ = 0;
+        carry_.clear();
+        eof_ = readError_ = delivering_ = false;
+        nextChunk_ = delivered_ = 0;
+        stopped_ = false;
+
+        // Ordered delivery needs a slot for each chunk parsed ahead of it.
+        const size_t slots = ordered_ ? 2 * threadCount_ : threadCount_;
+        if (chunks_.size() != slots)
+            chunks_ = std::vector<Chunk>(slots);
+    }
+
+    template <unsigned parseFlags, typename Callback>
+    void Run(Callback& callback) {
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < threadCount_; i++)
+            threads.push_back(std::thread([this, i, &callback]() { this->template Work<parseFlags>(i, callback); }));
+        Work<parseFlags>(0, callback);
+        for (size_t i = 0; i < threads.size(); i++)
+            threads[i].join();
+    }
+
+    template <unsigned parseFlags, typename Callback>
+    void Work(size_t worker, Callback& callback) {
+        for (;;) {
+            Chunk* c;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (ordered_)
+                    while (!stopped_ && nextChunk_ >= delivered_ + chunks_.size())
+                        slotFree_.wait(lock);
+                if (stopped_)
+                    return;
+                c = &chunks_[ordered_ ? nextChunk_ % chunks_.size() : worker];
+                if (!(fp_ ? ReadChunk(*c) : TakeChunk(*c)))
+                    return;
+                nextChunk_++;
+            }
+
+            if (!fp_)
+                c->text.assign(input_ + c->offset, input_ + c->end);
+            ParseChunk<parseFlags>(*c);
+            if (ordered_)
+                Complete(*c, callback);
+            else
+                Deliver(*c, callback);
+        }
+    }
+
+    // Takes the next chunk of the memory input, up to the end of a line.
+    bool TakeChunk(Chunk& c) {
+        if (position_ == length_)
+            return false;
+        c.offset = position_;
+        c.end = length_;
+        if (length_ - position_ > chunkSize_) {
+            const size_t start = position_ + chunkSize_;
+            if (const void* newline = std::memchr(input_ + start, '\n', length_ - start))
+                c.end = static_cast<size_t>(static_cast<const Ch*>(newline) - input_) + 1;
+        }
+        position_ = c.end;
+        return true;
+    }
+
+    // Reads the next chunk of the file, up to the end of a line. The part of the
+    // last line read is carried over to the next chunk.
+    bool ReadChunk(Chunk& c) {
+        c.offset = position_;
+        c.text.swap(carry_);
+        carry_.clear();
+        while (!eof_) {
+            const size_t size = c.text.size();
+            c.text.resize(size + chunkSize_);
+            const size_t n = std::fread(&c.text[size], 1, chunkSize_, fp_);
+            c.text.resize(size + n);
+            if (n < chunkSize_) {
+                eof_ = true;
+                if (std::ferror(fp_)) {
+                    readError_ = stopped_ = true;
+                    slotFree_.notify_all();
+                }
+                break;
+            }
+
+            size_t last = size + n;
+            while (last != size && c.text[last - 1] != '\n')
+                --last;
+            if (last != size) {
+                carry_.assign(c.text.begin() + static_cast<std::ptrdiff_t>(last), c.text.end());
+                c.text.resize(last);
+                break;
+            }
+        }
+        position_ += c.text.size();
+        return !stopped_ && !c.text.empty();
+    }
+
+    template <unsigned parseFlags>
+    void ParseChunk(Chunk& c) {
+        c.text.push_back('\0');
+        Ch* begin = &c.text[0];
+        Ch* end = begin + c.text.size() - 1;
+        c.count = 0;
+        for (Ch* p = begin; p < end; ) {
+            Ch* newline = static_cast<Ch*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!newline)
+                newline = end;
+            *newline = '\0';
+            if (!IsBlank(p)) {
+                if (c.count == c.documents.size()) {
+                    c.documents.emplace_back(&c.allocator);
+                    c.offsets.push_back(0);
+                }
+                c.documents[c.count].template ParseInsitu<parseFlags>(p);
+                c.offsets[c.count] = c.offset + static_cast<size_t>(p - begin);
+                c.count++;
+            }
+            p = newline + 1;
+        }
+    }
+
+    static bool IsBlank(const Ch* p) {
+        while (*p == ' ' || *p == '\t' || *p == '\r')
+            ++p;
+        return *p == '\0';
+    }
+
+    // Marks a chunk parsed, and delivers it with the following ones which are
+    // ready, unless another worker is delivering.
+    template <typename Callback>
+    void Complete(Chunk& c, Callback& callback) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        c.ready = true;
+        if (delivering_)
+            return;
+        delivering_ = true;
+        for (;;) {
+            Chunk& d = chunks_[delivered_ % chunks_.size()];
+            if (!d.ready)
+                break;
+            lock.unlock();
+            Deliver(d, callback);
+            lock.lock();
+            d.ready = false;
+            delivered_++;
+            slotFree_.notify_all();
+        }
+        delivering_ = false;
+    }
+
+    // Passes the records of a chunk to the callback, then frees them for the next chunk.
+    template <typename Callback>
+    void Deliver(Chunk& c, Callback& callback) {
+        for (size_t i = 0; i < c.count && !stopped_; i++)
+            if (!callback(c.offsets[i], c.documents[i]))
+                stopped_ = true;
+        for (size_t i = 0; i < c.count; i++)
+            c.documents[i].SetNull();
+        c.allocator.Clear();
+        c.count = 0;
+    }
+
+    static const size_t kDefaultChunkSize = 1024 * 1024;
+
+    unsigned threadCount_;
+    size_t chunkSize_;
+    bool ordered_;
+    std::vector<Chunk> chunks_;     //!< Chunk slots, indexed by chunk number if ordered, by worker otherwise.
+    std::mutex mutex_;
+    std::condition_variable slotFree_;
+
+    const Ch* input_;       //!< Memory input, possibly null if empty.
+    size_t length_;
+    size_t position_;       //!< Offset of the next chunk.
+    std::FILE* fp_;         //!< File input, null for memory input.
+    std::vector<Ch> carry_; //!< Start of the next chunk's first line, already read from the file.
+    bool eof_;
+
+    size_t nextChunk_;      //!< Number of the next chunk to take.
+    size_t delivered_;      //!< Number of chunks delivered in order.
+    bool delivering_;
+    bool readError_;
+    std::atomic<bool> stopped_;
+};
+
+//! JSON Lines parser with UTF8 encoding and default allocators.
+typedef GenericJsonLinesParser<UTF8<> > JsonLinesParser;
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // RAPIDJSON_JSONLINES_H_
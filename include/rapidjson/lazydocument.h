@@ -0,0 +1,943 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_LAZYDOCUMENT_H_
+#define RAPIDJSON_LAZYDOCUMENT_H_
+
+/*! \file lazydocument.h */
+
+#include "document.h"
+#include <iterator> // std::forward_iterator_tag
+
+/*! \def RAPIDJSON_LAZYDOCUMENT_MAX_TOKENS
+    \ingroup RAPIDJSON_CONFIG
+    \brief Bound of the tape positions of GenericLazyDocument containers.
+
+    Containers keep the position of their end in the tape in 29 bits, so a
+    container must end before this many tokens, or Parse() fails with
+    kParseErrorTermination. It may be lowered, but not raised.
+*/
+#ifndef RAPIDJSON_LAZYDOCUMENT_MAX_TOKENS
+#define RAPIDJSON_LAZYDOCUMENT_MAX_TOKENS (1u << 29)
+#endif
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+RAPIDJSON_DIAG_OFF(switch-enum)
+#elif defined(_MSC_VER)
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(4512) // assignment operator could not be generated
+#endif
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+template <typename Encoding, typename Allocator, typename StackAllocator>
+class GenericLazyDocument;
+
+template <typename DocumentType>
+class GenericLazyValue;
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericLazyMember
+
+//! Name-value pair of an object in a GenericLazyDocument.
+template <typename DocumentType>
+struct GenericLazyMember {
+    GenericLazyMember(const DocumentType* document, SizeType index) : name(document, index), value(document, index + 1) {}
+
+    GenericLazyValue<DocumentType> name;     //!< name of member (must be a string)
+    GenericLazyValue<DocumentType> value;    //!< value of member.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericLazyIterator
+
+//! Forward iterator over the elements or the members of a GenericLazyValue.
+/*! Elements and members are located by stepping over the tape, so only
+    forward traversal is provided.
+    \tparam DocumentType Type of the document.
+    \tparam T GenericLazyValue for elements, GenericLazyMember for members.
+*/
+template <typename DocumentType, typename T>
+class GenericLazyIterator {
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+    typedef std::ptrdiff_t difference_type;
+
+    GenericLazyIterator(const DocumentType* document, SizeType index) : current_(document, index) {}
+
+    reference operator*() const { return current_; }
+    pointer operator->() const { return &current_; }
+
+    GenericLazyIterator& operator++() { Advance(current_); return *this; }
+    GenericLazyIterator operator++(int) { GenericLazyIterator old(*this); ++*this; return old; }
+
+    bool operator==(const GenericLazyIterator& that) const { return Index(current_) == Index(that.current_); }
+    bool operator!=(const GenericLazyIterator& that) const { return Index(current_) != Index(that.current_); }
+
+private:
+    static SizeType Index(const GenericLazyValue<DocumentType>& v) { return v.index_; }
+    static SizeType Index(const GenericLazyMember<DocumentType>& m) { return m.name.index_; }
+
+    static void Advance(GenericLazyValue<DocumentType>& v) { v.index_ = v.document_->NextToken(v.index_); }
+    static void Advance(GenericLazyMember<DocumentType>& m) {
+        m.name.index_ = m.value.document_->NextToken(m.value.index_);
+        m.value.index_ = m.name.index_ + 1;
+    }
+
+    T current_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericLazyValue
+
+//! Read-only view of a value in a GenericLazyDocument.
+/*! The counterpart of GenericValue for lazily parsed documents: it is a small
+    handle to a token of the document's tape, copied by value. Strings and
+    numbers are decoded from the source text when accessed.
+
+    \note Values refer to their document and to the text it was parsed from,
+        and are invalidated when the document is parsed again or destroyed.
+    \note Decoded strings are cached in the document, so the first GetString()
+        of a string writes to the document even through a const value.
+        Concurrent accesses to the same document need to be serialized.
+    \tparam DocumentType Type of the document, a GenericLazyDocument.
+*/
+template <typename DocumentType>
+class GenericLazyValue {
+public:
+    typedef typename DocumentType::EncodingType EncodingType;   //!< Encoding type from template parameter.
+    typedef typename EncodingType::Ch Ch;                       //!< Character type derived from Encoding.
+    typedef GenericLazyMember<DocumentType> Member;             //!< Name-value pair in an object.
+    typedef GenericLazyIterator<DocumentType, GenericLazyValue> ValueIterator;  //!< Iterator over the elements of an array.
+    typedef GenericLazyIterator<DocumentType, Member> MemberIterator;           //!< Iterator over the members of an object.
+
+    GenericLazyValue(const DocumentType* document, SizeType index) : document_(document), index_(index) {}
+
+    //!@name Type
+    //@{
+
+    Type GetType() const { return document_->GetTokenType(index_); }
+    bool IsNull()   const { return GetType() == kNullType; }
+    bool IsFalse()  const { return GetType() == kFalseType; }
+    bool IsTrue()   const { return GetType() == kTrueType; }
+    bool IsBool()   const { return IsFalse() || IsTrue(); }
+    bool IsObject() const { return GetType() == kObjectType; }
+    bool IsArray()  const { return GetType() == kArrayType; }
+    bool IsNumber() const { return GetType() == kNumberType; }
+    bool IsString() const { return GetType() == kStringType; }
+
+    //! Whether the number fits in an int, like GenericValue::IsInt(). Parses the number.
+    bool IsInt() const      { NumberType n; return IsNumber() && DecodeNumber(n) && n.IsInt(); }
+    bool IsUint() const     { NumberType n; return IsNumber() && DecodeNumber(n) && n.IsUint(); }
+    bool IsInt64() const    { NumberType n; return IsNumber() && DecodeNumber(n) && n.IsInt64(); }
+    bool IsUint64() const   { NumberType n; return IsNumber() && DecodeNumber(n) && n.IsUint64(); }
+    bool IsDouble() const   { NumberType n; return IsNumber() && DecodeNumber(n) && n.IsDouble(); }
+
+    //@}
+
+    //!@name Bool
+    //@{
+
+    bool GetBool() const { RAPIDJSON_ASSERT(IsBool()); return IsTrue(); }
+
+    //@}
+
+    //!@name Number
+    //! Each call parses the number from the source text.
+    //@{
+
+    int GetInt() const          { NumberType n; DecodeNumber(n); return n.GetInt(); }
+    unsigned GetUint() const    { NumberType n; DecodeNumber(n); return n.GetUint(); }
+    int64_t GetInt64() const    { NumberType n; DecodeNumber(n); return n.GetInt64(); }
+    uint64_t GetUint64() const  { NumberType n; DecodeNumber(n); return n.GetUint64(); }
+    double GetDouble() const    { NumberType n; DecodeNumber(n); return n.GetDouble(); }
+    float GetFloat() const      { return static_cast<float>(GetDouble()); }
+
+    //@}
+
+    //!@name String
+    //@{
+
+    //! Null-terminated string, decoded on first access and cached in the document.
+    const Ch* GetString() const { RAPIDJSON_ASSERT(IsString()); return document_->GetTokenString(index_); }
+
+    //! Length of the string, without decoding it unless it contains escapes.
+    SizeType GetStringLength() const { RAPIDJSON_ASSERT(IsString()); return document_->GetTokenStringLength(index_); }
+
+#if RAPIDJSON_HAS_STDSTRING
+    //! Whether the string equals a std::basic_string.
+    bool operator==(const std::basic_string<Ch>& str) const { return IsString() && document_->TokenEquals(index_, str.data(), SizeType(str.size())); }
+    bool operator!=(const std::basic_string<Ch>& str) const { return !(*this == str); }
+#endif
+
+    //@}
+
+    //!@name Array
+    //@{
+
+    //! Number of elements in the array.
+    SizeType Size() const { RAPIDJSON_ASSERT(IsArray()); return document_->GetContainerSize(index_); }
+    bool Empty() const { RAPIDJSON_ASSERT(IsArray()); return Size() == 0; }
+
+    //! Get an element by index.
+    /*! \note Linear time complexity, by stepping over the preceding elements.
+    */
+    GenericLazyValue operator[](SizeType index) const {
+        RAPIDJSON_ASSERT(index < Size());
+        ValueIterator itr = Begin();
+        for (; index > 0; --index)
+            ++itr;
+        return *itr;
+    }
+
+    ValueIterator Begin() const { RAPIDJSON_ASSERT(IsArray()); return ValueIterator(document_, index_ + 1); }
+    ValueIterator End() const { RAPIDJSON_ASSERT(IsArray()); return ValueIterator(document_, document_->GetContainerEnd(index_)); }
+
+    //@}
+
+    //!@name Object
+    //@{
+
+    SizeType MemberCount() const { RAPIDJSON_ASSERT(IsObject()); return document_->GetContainerSize(index_); }
+    bool ObjectEmpty() const { RAPIDJSON_ASSERT(IsObject()); return MemberCount() == 0; }
+
+    MemberIterator MemberBegin() const { RAPIDJSON_ASSERT(IsObject()); return MemberIterator(document_, index_ + 1); }
+    MemberIterator MemberEnd() const { RAPIDJSON_ASSERT(IsObject()); return MemberIterator(document_, document_->GetContainerEnd(index_)); }
+
+    //! Find member by name.
+    /*! Names without escapes are compared against the source text without decoding them.
+        \note Linear time complexity.
+    */
+    MemberIterator FindMember(const Ch* name) const { return FindMember(name, internal::StrLen(name)); }
+
+    //! Find member by name with length (may contain null characters).
+    MemberIterator FindMember(const Ch* name, SizeType length) const {
+        RAPIDJSON_ASSERT(IsObject());
+        RAPIDJSON_ASSERT(name);
+        MemberIterator member = MemberBegin(), end = MemberEnd();
+        for (; member != end; ++member)
+            if (document_->TokenEquals(member->name.index_, name, length))
+                break;
+        return member;
+    }
+
+#if RAPIDJSON_HAS_STDSTRING
+    MemberIterator FindMember(const std::basic_string<Ch>& name) const { return FindMember(name.data(), SizeType(name.size())); }
+    bool HasMember(const std::basic_string<Ch>& name) const { return FindMember(name) != MemberEnd(); }
+    GenericLazyValue operator[](const std::basic_string<Ch>& name) const { return (*this)[name.c_str()]; }
+#endif
+
+    bool HasMember(const Ch* name) const { return FindMember(name) != MemberEnd(); }
+
+    //! Get a value from an object by name.
+    /*! \note Asserts that the member exists; a null value is returned otherwise, as with GenericValue.
+    */
+    template <typename T>
+    RAPIDJSON_DISABLEIF_RETURN((internal::NotExpr<internal::IsSame<typename internal::RemoveConst<T>::Type, Ch> >),(GenericLazyValue)) operator[](T* name) const {
+        MemberIterator member = FindMember(name);
+        if (member != MemberEnd())
+            return member->value;
+        RAPIDJSON_ASSERT(false);    // see above note
+        return GenericLazyValue(document_, 0);
+    }
+
+    //@}
+
+    //! Generate events of this value to a Handler, with the same events as GenericValue::Accept().
+    /*! Strings and numbers are decoded from the source text as they are emitted.
+        \return false if the handler terminated the traversal, or a string
+            could not be decoded (see GenericLazyDocument::Parse()).
+    */
+    template <typename Handler>
+    bool Accept(Handler& handler) const {
+        switch (GetType()) {
+        case kNullType:     return handler.Null();
+        case kFalseType:    return handler.Bool(false);
+        case kTrueType:     return handler.Bool(true);
+        case kNumberType:   return document_->DecodeToken(index_, handler);
+        case kStringType:   return document_->AcceptString(index_, handler, false);
+
+        case kObjectType:
+            if (RAPIDJSON_UNLIKELY(!handler.StartObject()))
+                return false;
+            for (MemberIterator m = MemberBegin(), end = MemberEnd(); m != end; ++m) {
+                if (RAPIDJSON_UNLIKELY(!document_->AcceptString(m->name.index_, handler, true)))
+                    return false;
+                if (RAPIDJSON_UNLIKELY(!m->value.Accept(handler)))
+                    return false;
+            }
+            return handler.EndObject(MemberCount());
+
+        default:
+            RAPIDJSON_ASSERT(GetType() == kArrayType);
+            if (RAPIDJSON_UNLIKELY(!handler.StartArray()))
+                return false;
+            for (ValueIterator v = Begin(), end = End(); v != end; ++v)
+                if (RAPIDJSON_UNLIKELY(!v->Accept(handler)))
+                    return false;
+            return handler.EndArray(Size());
+        }
+    }
+
+private:
+    template <typename, typename> friend class GenericLazyIterator;
+
+    typedef GenericValue<EncodingType, CrtAllocator> NumberType;
+
+    //! Captures the number event of a number token.
+    struct NumberDecoder : BaseReaderHandler<EncodingType, NumberDecoder> {
+        explicit NumberDecoder(NumberType& value) : value_(value) {}
+        bool Default() { return false; }
+        bool Int(int i) { value_.SetInt(i); return true; }
+        bool Uint(unsigned u) { value_.SetUint(u); return true; }
+        bool Int64(int64_t i) { value_.SetInt64(i); return true; }
+        bool Uint64(uint64_t u) { value_.SetUint64(u); return true; }
+        bool Double(double d) { value_.SetDouble(d); return true; }
+        NumberType& value_;
+    private:
+        NumberDecoder(const NumberDecoder&);
+        NumberDecoder& operator=(const NumberDecoder&);
+    };
+
+    //! Parse the number from the text, which Parse() has checked to fit in a double.
+    bool DecodeNumber(NumberType& value) const {
+        RAPIDJSON_ASSERT(IsNumber());
+        NumberDecoder decoder(value);
+        return document_->DecodeToken(index_, decoder);
+    }
+
+    const DocumentType* document_;
+    SizeType index_;    //!< Position of the token in the tape.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// GenericLazyDocument
+
+//! A document that parses into a tape and decodes values on access.
+/*!
+    Parse() checks the syntax of the text and records one tape entry per
+    token: its type and its position in the text, and for objects and arrays
+    the position of their end, so that skipping a value takes constant time.
+    Strings and numbers are not decoded until accessed through a
+    GenericLazyValue, which offers the read-only part of the GenericValue API
+    and Accept(). Compared with GenericDocument, this takes far less memory and
+    time when only a few values of a large document are used.
+
+    The text must be null-terminated, outlive the document, and be shorter
+    than 4 GB, as positions in the tape are 32-bit. Containers must end within
+    \ref RAPIDJSON_LAZYDOCUMENT_MAX_TOKENS tokens, about 500 million. Numbers that overflow a
+    double are reported by Parse() as kParseErrorNumberTooBig, as by
+    GenericDocument. Checks of strings that need decoding are deferred to the
+    access of the value: ill-formed surrogates and (with
+    kParseValidateEncodingFlag) ill-formed code units. Such a string decodes to
+    an empty string, and Accept() returns false on it.
+
+    Member lookup and element access are linear, like GenericValue without an
+    index.
+
+    \tparam Encoding Encoding of the text.
+    \tparam Allocator Allocator for decoded strings.
+    \tparam StackAllocator Allocator for the tape and the parsing stack.
+    \note Implements only kParseValidateEncodingFlag, kParseFullPrecisionFlag
+        and kParseStopWhenDoneFlag; other parse flags are rejected at compile time.
+*/
+template <typename Encoding, typename Allocator = MemoryPoolAllocator<>, typename StackAllocator = CrtAllocator>
+class GenericLazyDocument {
+public:
+    typedef Encoding EncodingType;                              //!< Encoding type from template parameter.
+    typedef typename Encoding::Ch Ch;                           //!< Character type derived from Encoding.
+    typedef GenericLazyValue<GenericLazyDocument> ValueType;    //!< Value type of the document.
+    typedef Allocator AllocatorType;                            //!< Allocator type from template parameter.
+
+    //! Constructor
+    /*! Creates an empty document whose root is null.
+        \param allocator        Optional allocator for decoded strings.
+        \param stackCapacity    Optional initial capacity of the tape in bytes.
+        \param stackAllocator   Optional allocator for the tape and the parsing stack.
+    */
+    GenericLazyDocument(Allocator* allocator = 0, size_t stackCapacity = kDefaultStackCapacity, StackAllocator* stackAllocator = 0) :
+        allocator_(allocator), ownAllocator_(0), tape_(stackAllocator, stackCapacity), strings_(stackAllocator, 0),
+        stack_(stackAllocator, kDefaultStackCapacity), reader_(stackAllocator), json_(), decodeFlags_(), parseResult_()
+    {
+        if (!allocator_)
+            ownAllocator_ = allocator_ = RAPIDJSON_NEW(Allocator)();
+        ResetTape();
+    }
+
+    ~GenericLazyDocument() {
+        ClearStrings();
+        RAPIDJSON_DELETE(ownAllocator_);
+    }
+
+    //!@name Parse from null-terminated text
+    //!@{
+
+    //! Parse JSON text into a tape (with parseFlags).
+    /*! \tparam parseFlags Combination of kParseValidateEncodingFlag, kParseFullPrecisionFlag and kParseStopWhenDoneFlag.
+        \param str Null-terminated JSON text, which must outlive the document.
+        \return The document itself for fluent API. On error, the root becomes null.
+        \note Text of 4 GB or more fails with kParseErrorTermination at offset 4 GB - 1, and a
+            container ending after \ref RAPIDJSON_LAZYDOCUMENT_MAX_TOKENS tokens at its end.
+    */
+    template <unsigned parseFlags>
+    GenericLazyDocument& Parse(const Ch* str) {
+        RAPIDJSON_STATIC_ASSERT((parseFlags & (kParseInsituFlag | kParseCommentsFlag | kParseNumbersAsStringsFlag |
+            kParseTrailingCommasFlag | kParseNanAndInfFlag)) == 0);
+        RAPIDJSON_ASSERT(str);
+        ClearStrings();
+        stack_.Clear();
+        json_ = str;
+        decodeFlags_ = parseFlags & (kParseValidateEncodingFlag | kParseFullPrecisionFlag);
+        parseResult_.Clear();
+        if (!ParseTape<parseFlags>(str))
+            ResetTape();
+        stack_.Clear();
+        stack_.ShrinkToFit();
+        return *this;
+    }
+
+    //! Parse JSON text into a tape (with \ref kParseDefaultFlags)
+    GenericLazyDocument& Parse(const Ch* str) {
+        return Parse<kParseDefaultFlags & (kParseValidateEncodingFlag | kParseFullPrecisionFlag | kParseStopWhenDoneFlag)>(str);
+    }
+
+    //!@}
+
+    //!@name Handling parse errors
+    //!@{
+
+    //! Whether a parse error has occurred in the last parsing.
+    bool HasParseError() const { return parseResult_.IsError(); }
+
+    //! Get the \ref ParseErrorCode of last parsing.
+    ParseErrorCode GetParseError() const { return parseResult_.Code(); }
+
+    //! Get the position of last parsing error in input, 0 otherwise.
+    size_t GetErrorOffset() const { return parseResult_.Offset(); }
+
+    //! Implicit conversion to get the last parse result
+    operator ParseResult() const { return parseResult_; }
+
+    //!@}
+
+    //! Root value of the document.
+    ValueType Root() const { return ValueType(this, 1); }
+
+    //! Generate the events of the whole document to a handler, see GenericLazyValue::Accept().
+    template <typename Handler>
+    bool Accept(Handler& handler) const { return Root().Accept(handler); }
+
+    //! Get the allocator of decoded strings.
+    Allocator& GetAllocator() {
+        RAPIDJSON_ASSERT(allocator_);
+        return *allocator_;
+    }
+
+    //! Number of tokens in the tape.
+    size_t GetTokenCount() const { return tape_.GetSize() / sizeof(Token) - 1; }
+
+private:
+    template <typename> friend class GenericLazyValue;
+    template <typename, typename> friend class GenericLazyIterator;
+
+    //! Tape entry.
+    /*! The low bits of \c word are the tag. Containers keep the position of
+        their end token in the rest, and end tokens that of their start.
+        Strings keep flags and the length of their raw text between the quotation marks.
+    */
+    struct Token {
+        uint32_t offset;    //!< Position in the text, element count for end tokens, cache index for decoded strings.
+        uint32_t word;
+    };
+
+    enum TokenTag {
+        kTagNull, kTagFalse, kTagTrue, kTagNumber, kTagString, kTagObject, kTagArray, kTagEnd
+    };
+
+    static const uint32_t kTagBits = 3;
+    static const uint32_t kTagMask = 7u;
+    static const uint32_t kStringEscaped = 8u;          //!< The string contains escapes.
+    static const uint32_t kStringDecoded = 16u;         //!< The string is cached, offset is its index in strings_.
+    static const uint32_t kStringLengthShift = 5;
+    static const uint32_t kLongString = 0x7FFFFFFu;     //!< Raw length that does not fit.
+
+    //! Parsing stack entry of an open object or array.
+    struct Frame {
+        SizeType start;     //!< Tape position of the start token.
+        SizeType count;     //!< Members or elements so far.
+    };
+
+    struct DecodedString {
+        const Ch* str;
+        SizeType length;
+        bool valid;     //!< Whether the string could be decoded, or is empty for lack of it.
+    };
+
+    //! Captures the string event of a string token.
+    struct StringDecoder : BaseReaderHandler<Encoding, StringDecoder> {
+        explicit StringDecoder(internal::Stack<StackAllocator>& stack) : stack_(stack), length() {}
+        bool Default() { return false; }
+        bool String(const Ch* str, SizeType len, bool) {
+            Ch* s = stack_.template Push<Ch>(len + 1);
+            std::memcpy(static_cast<void*>(s), str, len * sizeof(Ch));
+            s[len] = '\0';
+            length = len;
+            return true;
+        }
+        internal::Stack<StackAllocator>& stack_;
+        SizeType length;
+    private:
+        StringDecoder(const StringDecoder&);
+        StringDecoder& operator=(const StringDecoder&);
+    };
+
+    //!@name Tape access
+    //@{
+
+    Token& GetToken(SizeType index) const { return tape_.template Bottom<Token>()[index]; }
+    static uint32_t Tag(const Token& t) { return t.word & kTagMask; }
+
+    Type GetTokenType(SizeType index) const {
+        static const Type types[] = { kNullType, kFalseType, kTrueType, kNumberType, kStringType, kObjectType, kArrayType };
+        RAPIDJSON_ASSERT(Tag(GetToken(index)) != kTagEnd);
+        return types[Tag(GetToken(index))];
+    }
+
+    //! Position of the token after the value at index.
+    SizeType NextToken(SizeType index) const {
+        const Token& t = GetToken(index);
+        return (Tag(t) == kTagObject || Tag(t) == kTagArray) ? (t.word >> kTagBits) + 1 : index + 1;
+    }
+
+    SizeType GetContainerEnd(SizeType index) const { return GetToken(index).word >> kTagBits; }
+    SizeType GetContainerSize(SizeType index) const { return GetToken(GetContainerEnd(index)).offset; }
+
+    //@}
+
+    //!@name Decoding
+    //@{
+
+    //! Parse the scalar token at index with the reader, sending its event to the handler.
+    template <typename Handler>
+    bool DecodeToken(SizeType index, Handler& handler) const {
+        GenericStringStream<Encoding> is(json_ + GetToken(index).offset);
+        switch (decodeFlags_) {
+        case 0:
+            return !reader_.template Parse<kParseStopWhenDoneFlag>(is, handler).IsError();
+        case kParseFullPrecisionFlag:
+            return !reader_.template Parse<kParseStopWhenDoneFlag | kParseFullPrecisionFlag>(is, handler).IsError();
+        case kParseValidateEncodingFlag:
+            return !reader_.template Parse<kParseStopWhenDoneFlag | kParseValidateEncodingFlag>(is, handler).IsError();
+        default:
+            RAPIDJSON_ASSERT(decodeFlags_ == (kParseValidateEncodingFlag | kParseFullPrecisionFlag));
+            return !reader_.template Parse<kParseStopWhenDoneFlag | kParseValidateEncodingFlag | kParseFullPrecisionFlag>(is, handler).IsError();
+        }
+    }
+
+    //! Whether the string can be used from the text as is.
+    bool IsPlainString(const Token& t) const {
+        return (t.word & (kStringEscaped | kStringDecoded)) == 0 && !(decodeFlags_ & kParseValidateEncodingFlag);
+    }
+
+    //! Length of the raw text of an unescaped string.
+    SizeType RawStringLength(const Token& t) const {
+        SizeType length = t.word >> kStringLengthShift;
+        if (RAPIDJSON_UNLIKELY(length == kLongString)) {
+            const Ch* str = json_ + t.offset + 1;
+            length = static_cast<SizeType>(ScanUnescaped(str) - str);
+        }
+        return length;
+    }
+
+    //! Null-terminated decoding of the string token on stack_, or its cached decoding.
+    /*! An undecodable string yields an empty string.
+        \return Whether the string could be decoded.
+    */
+    bool LoadString(SizeType index, const Ch** str, SizeType* length) const {
+        const Token& t = GetToken(index);
+        RAPIDJSON_ASSERT(Tag(t) == kTagString);
+        if (t.word & kStringDecoded) {
+            const DecodedString& s = strings_.template Bottom<DecodedString>()[t.offset];
+            *str = s.str;
+            *length = s.length;
+            return s.valid;
+        }
+
+        stack_.Clear();
+        bool success = true;
+        if (IsPlainString(t)) {
+            *length = RawStringLength(t);
+            Ch* s = stack_.template Push<Ch>(*length + 1);
+            std::memcpy(static_cast<void*>(s), json_ + t.offset + 1, *length * sizeof(Ch));
+            s[*length] = '\0';
+        }
+        else {
+            StringDecoder decoder(stack_);
+            success = DecodeToken(index, decoder);
+            if (!success) {
+                stack_.Clear();
+                *stack_.template Push<Ch>() = '\0';
+            }
+            *length = decoder.length;
+        }
+        *str = stack_.template Bottom<Ch>();
+        return success;
+    }
+
+    const Ch* GetTokenString(SizeType index) const {
+        Token& t = GetToken(index);
+        if (!(t.word & kStringDecoded)) {
+            const Ch* str;
+            SizeType length;
+            const bool valid = LoadString(index, &str, &length);
+            Ch* s = static_cast<Ch*>(allocator_->Malloc((length + 1) * sizeof(Ch)));
+            std::memcpy(static_cast<void*>(s), str, (length + 1) * sizeof(Ch));
+            DecodedString* d = strings_.template Push<DecodedString>();
+            d->str = s;
+            d->length = length;
+            d->valid = valid;
+            t.offset = static_cast<uint32_t>(strings_.GetSize() / sizeof(DecodedString) - 1);
+            t.word |= kStringDecoded;
+        }
+        return strings_.template Bottom<DecodedString>()[t.offset].str;
+    }
+
+    SizeType GetTokenStringLength(SizeType index) const {
+        const Token& t = GetToken(index);
+        if (IsPlainString(t))
+            return RawStringLength(t);
+        GetTokenString(index);
+        return strings_.template Bottom<DecodedString>()[t.offset].length;
+    }
+
+    bool TokenEquals(SizeType index, const Ch* str, SizeType length) const {
+        const Token& t = GetToken(index);
+        RAPIDJSON_ASSERT(Tag(t) == kTagString);
+        if (IsPlainString(t))
+            return RawStringLength(t) == length && std::memcmp(json_ + t.offset + 1, str, length * sizeof(Ch)) == 0;
+        const Ch* s = GetTokenString(index);
+        const SizeType sLength = strings_.template Bottom<DecodedString>()[t.offset].length;
+        return sLength == length && std::memcmp(s, str, length * sizeof(Ch)) == 0;
+    }
+
+    template <typename Handler>
+    bool AcceptString(SizeType index, Handler& handler, bool isKey) const {
+        const Ch* str;
+        SizeType length;
+        if (!LoadString(index, &str, &length))
+            return false;
+        return isKey ? handler.Key(str, length, true) : handler.String(str, length, true);
+    }
+
+    void ClearStrings() {
+        if (Allocator::kNeedFree)
+            for (const DecodedString* s = strings_.template Bottom<DecodedString>(); s != strings_.template End<DecodedString>(); ++s)
+                Allocator::Free(const_cast<Ch*>(s->str));
+        strings_.Clear();
+    }
+
+    //@}
+
+    //!@name Tape building
+    //@{
+
+    //! Tape of a null root, after the null token that stands for missing members at position 0.
+    void ResetTape() {
+        tape_.Clear();
+        PushToken(0, kTagNull);
+        PushToken(0, kTagNull);
+    }
+
+    SizeType TapeSize() const { return static_cast<SizeType>(tape_.GetSize() / sizeof(Token)); }
+
+    void PushToken(uint32_t offset, uint32_t word) {
+        Token* t = tape_.template Push<Token>();
+        t->offset = offset;
+        t->word = word;
+    }
+
+    //! Position of p in the text, which wraps beyond 4 GB; ParseTape() checks the end of the text instead.
+    uint32_t Offset(const Ch* p) const {
+        return static_cast<uint32_t>(p - json_);
+    }
+
+    //! Fail if the text parsed up to end is too long for the positions in the tape.
+    bool CheckLength(const Ch* end) {
+        static const uint64_t kMaxLength = 0xFFFFFFFFu;
+        if (RAPIDJSON_UNLIKELY(static_cast<uint64_t>(end - json_) > kMaxLength))
+            return Error(kParseErrorTermination, json_ + kMaxLength) != 0;
+        return true;
+    }
+
+    //! Record a parse error at p. Returns null, for the scanning functions.
+    const Ch* Error(ParseErrorCode code, const Ch* p) {
+        parseResult_.Set(code, static_cast<size_t>(p - json_));
+        return 0;
+    }
+
+    static const Ch* SkipWhitespace(const Ch* p) {
+        GenericStringStream<Encoding> is(p);
+        RAPIDJSON_NAMESPACE::SkipWhitespace(is);
+        return is.src_;
+    }
+
+    //! First '"', '\\' or control character at or after p.
+    template <typename T>
+    static const T* ScanUnescaped(const T* p) {
+        while (!(*p == '\"' || *p == '\\' || static_cast<unsigned>(*p) < 0x20))
+            ++p;
+        return p;
+    }
+
+    static const char* ScanUnescaped(const char* p) {
+#ifdef RAPIDJSON_SIMD_KERNELS
+        return internal::SimdScanUnescaped(p);
+#else
+        return internal::ScanUnescaped_Scalar(p);
+#endif
+    }
+
+    static bool IsDigit(Ch c) { return c >= '0' && c <= '9'; }
+
+    static bool IsHex(Ch c) { return IsDigit(c) || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'); }
+
+    //! Check the string at p and record it. Returns the position after it, or null on error.
+    const Ch* ScanString(const Ch* p) {
+        RAPIDJSON_ASSERT(*p == '\"');
+        const Ch* q = p + 1;
+        uint32_t flags = 0;
+        for (;;) {
+            q = ScanUnescaped(q);
+            const Ch c = *q;
+            if (c == '\"')
+                break;
+            else if (c == '\\') {
+                const Ch* escape = q;
+                const Ch e = *++q;
+                flags = kStringEscaped;
+                if (e == 'u') {
+                    for (int i = 0; i < 4; i++)
+                        if (RAPIDJSON_UNLIKELY(!IsHex(*++q)))
+                            return Error(kParseErrorStringUnicodeEscapeInvalidHex, escape);
+                    ++q;
+                }
+                else if (e == '\"' || e == '\\' || e == '/' || e == 'b' || e == 'f' || e == 'n' || e == 'r' || e == 't')
+                    ++q;
+                else
+                    return Error(kParseErrorStringEscapeInvalid, escape);
+            }
+            else if (c == '\0')
+                return Error(kParseErrorStringMissQuotationMark, q);
+            else
+                return Error(kParseErrorStringInvalidEncoding, q);
+        }
+        const size_t length = static_cast<size_t>(q - p - 1);
+        PushToken(Offset(p), kTagString | flags | (length < kLongString ? static_cast<uint32_t>(length) : kLongString) << kStringLengthShift);
+        return q + 1;
+    }
+
+    //! Check the number grammar at p and record it. Returns the position after it, or null on error.
+    /*! A number with at most 308 integer digits, including a positive
+        exponent, fits in a double. Others are decoded to check that they do not overflow.
+    */
+    const Ch* ScanNumber(const Ch* p) {
+        const Ch* q = p;
+        if (*q == '-')
+            ++q;
+        if (*q == '0')
+            ++q;
+        else if (*q >= '1' && *q <= '9')
+            while (IsDigit(*++q)) {}
+        else
+            return Error(kParseErrorValueInvalid, q);
+        int magnitude = static_cast<int>(q - p < kMaxMagnitude ? q - p : kMaxMagnitude);
+
+        if (*q == '.') {
+            if (RAPIDJSON_UNLIKELY(!IsDigit(*++q)))
+                return Error(kParseErrorNumberMissFraction, q);
+            while (IsDigit(*++q)) {}
+        }
+        if (*q == 'e' || *q == 'E') {
+            ++q;
+            const bool expMinus = *q == '-';
+            if (*q == '+' || *q == '-')
+                ++q;
+            if (RAPIDJSON_UNLIKELY(!IsDigit(*q)))
+                return Error(kParseErrorNumberMissExponent, q);
+            int exp = 0;
+            for (; IsDigit(*q); ++q)
+                if (exp < kMaxMagnitude)
+                    exp = exp * 10 + static_cast<int>(*q - '0');
+            if (!expMinus)
+                magnitude += exp;
+        }
+        PushToken(Offset(p), kTagNumber);
+        if (RAPIDJSON_UNLIKELY(magnitude > 308)) {
+            BaseReaderHandler<Encoding> handler;
+            if (!DecodeToken(TapeSize() - 1, handler))
+                return Error(kParseErrorNumberTooBig, p);
+        }
+        return q;
+    }
+
+    //! Check a literal at p and record it. Returns the position after it, or null on error.
+    const Ch* ScanLiteral(const Ch* p, const char* literal, uint32_t tag) {
+        const Ch* q = p;
+        for (; *literal; ++literal, ++q)
+            if (RAPIDJSON_UNLIKELY(*q != static_cast<Ch>(*literal)))
+                return Error(kParseErrorValueInvalid, q);
+        PushToken(Offset(p), tag);
+        return q;
+    }
+
+    //! Check the name of a member and the colon after it. Returns the position of the value, or null on error.
+    const Ch* ScanName(const Ch* p) {
+        if (RAPIDJSON_UNLIKELY(*p != '\"'))
+            return Error(kParseErrorObjectMissName, p);
+        if (!(p = ScanString(p)))
+            return 0;
+        p = SkipWhitespace(p);
+        if (RAPIDJSON_UNLIKELY(*p != ':'))
+            return Error(kParseErrorObjectMissColon, p);
+        return SkipWhitespace(p + 1);
+    }
+
+    //! Record the end token of the innermost open container, closed at p. Returns false if the tape is too long.
+    bool CloseContainer(const Ch* p) {
+        RAPIDJSON_STATIC_ASSERT(RAPIDJSON_LAZYDOCUMENT_MAX_TOKENS <= (1u << (32 - kTagBits)));
+        Frame* f = stack_.template Pop<Frame>(1);
+        const SizeType end = TapeSize();
+        if (RAPIDJSON_UNLIKELY(end >= RAPIDJSON_LAZYDOCUMENT_MAX_TOKENS))
+            return Error(kParseErrorTermination, p) != 0;
+        PushToken(f->count, kTagEnd | f->start << kTagBits);
+        GetToken(f->start).word |= end << kTagBits;
+        return true;
+    }
+
+    //! Build the tape without recursion, with the open containers on stack_. Returns false on error.
+    template <unsigned parseFlags>
+    bool ParseTape(const Ch* p) {
+        tape_.Clear();
+        PushToken(0, kTagNull);
+
+        p = SkipWhitespace(p);
+        if (RAPIDJSON_UNLIKELY(*p == '\0'))
+            return Error(kParseErrorDocumentEmpty, p) != 0;
+
+        for (;;) {
+            // A value
+            switch (*p) {
+            case '{':
+            case '[': {
+                const bool isObject = *p == '{';
+                Frame* f = stack_.template Push<Frame>();
+                f->start = TapeSize();
+                f->count = 0;
+                PushToken(Offset(p), isObject ? kTagObject : kTagArray);
+                p = SkipWhitespace(p + 1);
+                if (*p == (isObject ? '}' : ']')) {
+                    if (!CloseContainer(p))
+                        return false;
+                    ++p;
+                    break;
+                }
+                if (isObject && !(p = ScanName(p)))
+                    return false;
+                continue;
+            }
+            case '\"': p = ScanString(p); break;
+            case 'n': p = ScanLiteral(p, "null", kTagNull); break;
+            case 't': p = ScanLiteral(p, "true", kTagTrue); break;
+            case 'f': p = ScanLiteral(p, "false", kTagFalse); break;
+            default: p = ScanNumber(p); break;
+            }
+            if (!p)
+                return false;
+
+            // Close the containers ended after the value, and go to the next value
+            for (;;) {
+                if (stack_.Empty()) {
+                    if (!(parseFlags & kParseStopWhenDoneFlag)) {
+                        p = SkipWhitespace(p);
+                        if (RAPIDJSON_UNLIKELY(*p != '\0'))
+                            return Error(kParseErrorDocumentRootNotSingular, p) != 0;
+                    }
+                    return CheckLength(p);
+                }
+
+                Frame* f = stack_.template Top<Frame>();
+                const bool isObject = Tag(GetToken(f->start)) == kTagObject;
+                f->count++;
+                p = SkipWhitespace(p);
+                if (*p == ',') {
+                    p = SkipWhitespace(p + 1);
+                    if (isObject && !(p = ScanName(p)))
+                        return false;
+                    break;
+                }
+                else if (*p == (isObject ? '}' : ']')) {
+                    if (!CloseContainer(p))
+                        return false;
+                    ++p;
+                }
+                else
+                    return Error(isObject ? kParseErrorObjectMissCommaOrCurlyBracket : kParseErrorArrayMissCommaOrSquareBracket, p) != 0;
+            }
+        }
+    }
+
+    //@}
+
+    GenericLazyDocument(const GenericLazyDocument&);
+    GenericLazyDocument& operator=(const GenericLazyDocument&);
+
+    static const size_t kDefaultStackCapacity = 1024;
+    static const int kMaxMagnitude = 100000;    //!< Bound of the digit and exponent counts of ScanNumber().
+    Allocator* allocator_;
+    Allocator* ownAllocator_;
+    mutable internal::Stack<StackAllocator> tape_;      //!< Tokens; decoding a string updates its entry.
+    mutable internal::Stack<StackAllocator> strings_;   //!< DecodedString of every decoded string.
+    mutable internal::Stack<StackAllocator> stack_;     //!< Open containers while parsing, a decoded string afterwards.
+    mutable GenericReader<Encoding, Encoding, StackAllocator> reader_;  //!< Decodes strings and numbers.
+    const Ch* json_;
+    unsigned decodeFlags_;
+    ParseResult parseResult_;
+};
+
+//! GenericLazyDocument with UTF8 encoding
+typedef GenericLazyDocument<UTF8<> > LazyDocument;
+//! GenericLazyValue of LazyDocument
+typedef LazyDocument::ValueType LazyValue;
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
+
+#if defined(__clang__) || defined(_MSC_VER)
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_LAZYDOCUMENT_H_
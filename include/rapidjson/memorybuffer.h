@@ -65,6 +65,12 @@ inline void PutN(MemoryBuffer& memoryBuffer, char c, size_t n) {
     std::memset(memoryBuffer.stack_.Push<char>(n), c, n * sizeof(c));
 }
 
+//! Implement specialized version of PutBlockUnsafe() with memcpy() for better performance.
+template<>
+inline void PutBlockUnsafe(MemoryBuffer& memoryBuffer, const char* str, size_t n) {
+    std::memcpy(memoryBuffer.stack_.Push<char>(n), str, n);
+}
+
 RAPIDJSON_NAMESPACE_END
 
 #endif // RAPIDJSON_MEMORYBUFFER_H_
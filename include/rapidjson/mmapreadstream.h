@@ -0,0 +1,179 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_MMAPREADSTREAM_H_
+#define RAPIDJSON_MMAPREADSTREAM_H_
+
+/*! \file mmapreadstream.h */
+
+#include "allocators.h"
+#include "stream.h"
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RAPIDJSON_MMAPREADSTREAM_MMAP 1
+#endif
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+//! File byte stream for input using mmap().
+/*! The file is mapped into memory and followed by a zero byte, so that it is
+    parsed as a StringStream: whitespace, strings and numbers are scanned
+    in place with the SIMD and raw pointer paths, and nothing is copied.
+
+    The mapping is advised for sequential access. A file which cannot be mapped,
+    e.g. a pipe, or on a platform without mmap(), is read into memory instead.
+
+    \code
+    FILE* fp = fopen("big.json", "rb");
+    MmapReadStream is(fp);
+    Document d;
+    d.ParseStream(is);
+    fclose(fp);
+    \endcode
+
+    \note implements Stream concept
+    \note The file must not be truncated while it is mapped.
+*/
+class MmapReadStream : public StringStream {
+public:
+    typedef char Ch;    //!< Character type (byte).
+
+    //! Constructor.
+    /*!
+        \param fp File pointer opened for read. The stream starts at its current position.
+        \param hugePages Whether to ask for transparent huge pages for the mapping, where supported.
+    */
+    explicit MmapReadStream(std::FILE* fp, bool hugePages = false) : StringStream(""), mapping_(0), mappingSize_(0), buffer_(0), size_(0) {
+        RAPIDJSON_ASSERT(fp != 0);
+        if (!Map(fp, hugePages))
+            Read(fp);
+    }
+
+    ~MmapReadStream() {
+#ifdef RAPIDJSON_MMAPREADSTREAM_MMAP
+        if (mapping_)
+            munmap(mapping_, mappingSize_);
+#endif
+        CrtAllocator::Free(buffer_);
+    }
+
+    //! Whether the file is mapped, rather than read into memory.
+    bool IsMapped() const { return mapping_ != 0; }
+
+    //! Size of the stream, in bytes.
+    size_t GetSize() const { return size_; }
+
+    // For encoding detection only.
+    const Ch* Peek4() const {
+        return Tell() + 4 <= size_ ? src_ : 0;
+    }
+
+private:
+    // Prohibit copy constructor & assignment operator.
+    MmapReadStream(const MmapReadStream&);
+    MmapReadStream& operator=(const MmapReadStream&);
+
+    // Maps the rest of the file, followed by at least one page of zeros.
+    bool Map(std::FILE* fp, bool hugePages) {
+#ifdef RAPIDJSON_MMAPREADSTREAM_MMAP
+        struct stat st;
+        const int fd = fileno(fp);
+        const off_t position = ftello(fp);
+        if (fd < 0 || position < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= position)
+            return false;
+
+        const off_t page = static_cast<off_t>(sysconf(_SC_PAGESIZE));
+        const off_t offset = position / page * page;
+        const size_t length = static_cast<size_t>(st.st_size - offset);
+        mappingSize_ = (length / static_cast<size_t>(page) + 1) * static_cast<size_t>(page);
+
+        // Reserve zero pages, then map the file over them.
+        void* p = mmap(0, mappingSize_, PROT_READ, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (p == MAP_FAILED)
+            return false;
+        if (mmap(p, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, offset) == MAP_FAILED) {
+            munmap(p, mappingSize_);
+            return false;
+        }
+        mapping_ = p;
+
+#ifdef MADV_SEQUENTIAL
+        madvise(p, length, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_HUGEPAGE
+        if (hugePages)
+            madvise(p, length, MADV_HUGEPAGE);
+#endif
+        (void)hugePages;
+
+        src_ = head_ = static_cast<const Ch*>(p) + (position - offset);
+        size_ = static_cast<size_t>(st.st_size - position);
+        fseeko(fp, st.st_size, SEEK_SET);
+        return true;
+#else
+        (void)fp;
+        (void)hugePages;
+        return false;
+#endif
+    }
+
+    // Reads the rest of the file into a zero-terminated buffer.
+    void Read(std::FILE* fp) {
+        CrtAllocator allocator;
+        size_t capacity = 0;
+        for (;;) {
+            if (capacity - size_ < kReadSize) {
+                const size_t newCapacity = capacity + (capacity >> 1) + kReadSize;
+                buffer_ = static_cast<Ch*>(allocator.Realloc(buffer_, capacity + 1, newCapacity + 1));
+                capacity = newCapacity;
+            }
+            const size_t readCount = std::fread(buffer_ + size_, 1, capacity - size_, fp);
+            size_ += readCount;
+            if (readCount == 0)
+                break;
+        }
+        buffer_[size_] = '\0';
+        src_ = head_ = buffer_;
+    }
+
+    static const size_t kReadSize = 65536;
+    void* mapping_;         //!< Start of the mapping, null if the file was read.
+    size_t mappingSize_;    //!< Size of the mapping, in bytes.
+    Ch* buffer_;            //!< Buffer of the file read into memory.
+    size_t size_;
+};
+
+//! The reader parses a MmapReadStream as a StringStream.
+template <>
+struct StreamParsedAs<MmapReadStream> {
+    typedef StringStream Type;
+    static Type& Get(MmapReadStream& stream) { return stream; }
+};
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_MMAPREADSTREAM_H_
@@ -51,6 +51,10 @@ public:
         stream_.put(c);
     }
 
+    void PutBlock(const Ch* str, size_t n) {
+        stream_.write(str, static_cast<std::streamsize>(n));
+    }
+
     void Flush() {
         stream_.flush();
     }
@@ -69,6 +73,12 @@ private:
     StreamType& stream_;
 };
 
+//! Implement specialized version of PutBlockUnsafe() with write() for better performance.
+template <typename StreamType>
+inline void PutBlockUnsafe(BasicOStreamWrapper<StreamType>& stream, const typename StreamType::char_type* str, size_t n) {
+    stream.PutBlock(str, n);
+}
+
 typedef BasicOStreamWrapper<std::ostream> OStreamWrapper;
 typedef BasicOStreamWrapper<std::wostream> WOStreamWrapper;
 
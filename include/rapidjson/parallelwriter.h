@@ -0,0 +1,235 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_PARALLELWRITER_H_
+#define RAPIDJSON_PARALLELWRITER_H_
+
+/*! \file parallelwriter.h */
+
+#include "prettywriter.h"
+#include "stringbuffer.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include <thread>
+#include <vector>
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+namespace internal {
+
+//! Writer of a part of AcceptParallel(), into a string buffer, with the settings of \c Handler.
+/*! Only Writer and PrettyWriter, which write the same encoding as they are
+    given, are written in parts; other handlers are given the whole value.
+*/
+template <typename Handler>
+struct ParallelPartWriter {
+    typedef FalseType Enabled;
+};
+
+template <typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator, unsigned writeFlags>
+struct ParallelPartWriter<Writer<OutputStream, SourceEncoding, TargetEncoding, StackAllocator, writeFlags> > {
+    typedef BoolType<IsSame<SourceEncoding, TargetEncoding>::Value> Enabled;
+    typedef GenericStringBuffer<TargetEncoding> Buffer;
+    typedef Writer<Buffer, SourceEncoding, TargetEncoding, StackAllocator, writeFlags> Type;
+
+    static void Init(Type& part, const Writer<OutputStream, SourceEncoding, TargetEncoding, StackAllocator, writeFlags>& writer) {
+        part.SetMaxDecimalPlaces(writer.GetMaxDecimalPlaces());
+    }
+};
+
+template <typename OutputStream, typename SourceEncoding, typename TargetEncoding, typename StackAllocator, unsigned writeFlags>
+struct ParallelPartWriter<PrettyWriter<OutputStream, SourceEncoding, TargetEncoding, StackAllocator, writeFlags> > {
+    typedef BoolType<IsSame<SourceEncoding, TargetEncoding>::Value> Enabled;
+    typedef GenericStringBuffer<TargetEncoding> Buffer;
+    typedef PrettyWriter<Buffer, SourceEncoding, TargetEncoding, StackAllocator, writeFlags> Type;
+
+    static void Init(Type& part, const PrettyWriter<OutputStream, SourceEncoding, TargetEncoding, StackAllocator, writeFlags>& writer) {
+        part.SetMaxDecimalPlaces(writer.GetMaxDecimalPlaces());
+        part.SetIndent(writer.GetIndentChar(), writer.GetIndentCharCount());
+        part.SetFormatOptions(writer.GetFormatOptions());
+    }
+};
+
+//! Writes the value given to AcceptParallel() in parts, on several threads.
+/*! The children of the root are split in ranges of the same size. The first
+    range is written by the calling thread, into the writer given. Each of the
+    others is written by a thread, into a string buffer, by a writer of the
+    same kind, and then into the writer given as a raw value.
+
+    The part writers start with two placeholders, so that a range has the
+    indentation and the separators of the root, and the separator between
+    the two tells how many characters to skip before the first child.
+*/
+template <typename ValueType, typename Handler>
+class ParallelAccept {
+public:
+    typedef typename ValueType::Ch Ch;
+    typedef ParallelPartWriter<Handler> PartWriter;
+    typedef typename PartWriter::Buffer Buffer;
+
+    static bool Accept(const ValueType& value, Handler& handler, unsigned threadCount) {
+        const size_t count = value.IsArray() ? value.Size() : value.MemberCount();
+        const size_t partCount = threadCount < count / kMinPartCount ? threadCount : count / kMinPartCount;
+        std::vector<Part> parts(partCount);
+        for (size_t i = 0; i < partCount; i++) {
+            parts[i].first = count / partCount * i;
+            parts[i].last = i + 1 < partCount ? count / partCount * (i + 1) : count;
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < partCount; i++)
+            threads.push_back(std::thread([&, i]() { WritePart(value, handler, parts[i]); }));
+        bool succeeded = value.IsArray() ? handler.StartArray() : handler.StartObject();
+        for (size_t i = parts[0].first; succeeded && i < parts[0].last; i++)
+            succeeded = WriteChild(value, i, handler);
+        for (size_t i = 0; i < threads.size(); i++)
+            threads[i].join();
+
+        for (size_t i = 1; succeeded && i < partCount; i++) {
+            const Part& part = parts[i];
+            const Ch* text = part.buffer.GetString();
+            if (!part.succeeded)
+                succeeded = false;
+            else if (value.IsArray())
+                succeeded = handler.RawValue(text + part.begin, part.end - part.begin, value[static_cast<SizeType>(part.first)].GetType());
+            else
+                succeeded = handler.RawValue(text + part.begin, part.keyEnd - part.begin, kStringType) &&
+                    handler.RawValue(text + part.valueBegin, part.end - part.valueBegin, GetMember(value, part.first).value.GetType());
+        }
+        if (!succeeded)
+            return false;
+        return value.IsArray() ? handler.EndArray(static_cast<SizeType>(count)) : handler.EndObject(static_cast<SizeType>(count));
+    }
+
+    static const size_t kMinPartCount = 64;    //!< Fewest children written by each thread.
+
+private:
+    //! Range of children, and the positions of their text in the buffer.
+    struct Part {
+        Part() : first(), last(), buffer(), begin(), keyEnd(), valueBegin(), end(), succeeded() {}
+        size_t first;
+        size_t last;
+        Buffer buffer;
+        size_t begin;       //!< Start of the first child, or of its name.
+        size_t keyEnd;      //!< End of the name of the first member.
+        size_t valueBegin;  //!< Start of the value of the first member.
+        size_t end;
+        bool succeeded;
+    };
+
+    static const typename ValueType::Member& GetMember(const ValueType& value, size_t i) {
+        return value.MemberBegin()[static_cast<typename ValueType::ConstMemberIterator::DifferenceType>(i)];
+    }
+
+    template <typename WriterType>
+    static bool WriteChild(const ValueType& value, size_t i, WriterType& writer) {
+        if (value.IsArray())
+            return value[static_cast<SizeType>(i)].Accept(writer);
+        const typename ValueType::Member& m = GetMember(value, i);
+        return writer.Key(m.name.GetString(), m.name.GetStringLength()) && m.value.Accept(writer);
+    }
+
+    static void WritePart(const ValueType& value, const Handler& handler, Part& part) {
+        typename PartWriter::Type writer(part.buffer);
+        PartWriter::Init(writer, handler);
+        size_t first = part.first;
+        if (value.IsArray()) {
+            writer.StartArray();
+            writer.Null();
+            const size_t placeholder = part.buffer.GetLength();
+            writer.Null();
+            const size_t separator = part.buffer.GetLength() - placeholder - 4;  // Before "null"
+            part.begin = part.buffer.GetLength() + separator;
+            part.succeeded = true;
+        }
+        else {
+            const Ch empty[] = { 0 };
+            writer.StartObject();
+            writer.Key(empty, 0);
+            const size_t name = part.buffer.GetLength();
+            writer.Null();
+            const size_t placeholder = part.buffer.GetLength();
+            const size_t colon = placeholder - name - 4;                        // Before "null"
+            writer.Key(empty, 0);
+            const size_t separator = part.buffer.GetLength() - placeholder - 2; // Before "\"\""
+            writer.Null();
+            part.begin = part.buffer.GetLength() + separator;
+
+            const typename ValueType::Member& m = GetMember(value, first++);
+            part.succeeded = writer.Key(m.name.GetString(), m.name.GetStringLength());
+            part.keyEnd = part.buffer.GetLength();
+            part.valueBegin = part.keyEnd + colon;
+            part.succeeded = part.succeeded && m.value.Accept(writer);
+        }
+        for (size_t i = first; part.succeeded && i < part.last; i++)
+            part.succeeded = WriteChild(value, i, writer);
+        part.end = part.buffer.GetLength();
+    }
+};
+
+template <typename ValueType, typename Handler>
+inline bool AcceptParallel(const ValueType& value, Handler& handler, unsigned threadCount, TrueType) {
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+    const size_t count = value.IsArray() ? value.Size() : value.IsObject() ? value.MemberCount() : 0;
+    if (threadCount < 2 || count / ParallelAccept<ValueType, Handler>::kMinPartCount < 2)
+        return value.Accept(handler);
+    return ParallelAccept<ValueType, Handler>::Accept(value, handler, threadCount);
+}
+
+template <typename ValueType, typename Handler>
+inline bool AcceptParallel(const ValueType& value, Handler& handler, unsigned, FalseType) {
+    return value.Accept(handler);
+}
+
+} // namespace internal
+
+//! Write a large array or object with a Writer or a PrettyWriter, on several threads.
+/*! The elements or members of \c value are split in ranges, which are written
+    concurrently into string buffers, then concatenated into \c handler in
+    order, so the output is the same as of <tt>value.Accept(handler)</tt>.
+
+    \code
+    Writer<StringBuffer> writer(sb);
+    AcceptParallel(d, writer);
+    \endcode
+
+    \param value Value to be written, which must not be changed meanwhile.
+    \param handler Writer or PrettyWriter, which has written nothing since construction or Reset().
+        Other handlers, and writers which transcode, are given <tt>value.Accept(handler)</tt>.
+    \param threadCount Number of threads, including the calling thread. 0 for one per hardware thread.
+    \return Whether all the calls to the writers succeeded. On failure, the output is incomplete.
+    \note A small value is written by the calling thread only. Ranges hold the same number of
+        children, so children of similar sizes are written fastest.
+*/
+template <typename ValueType, typename Handler>
+inline bool AcceptParallel(const ValueType& value, Handler& handler, unsigned threadCount = 0) {
+    return internal::AcceptParallel<typename ValueType::ValueType>(value, handler, threadCount, typename internal::ParallelPartWriter<Handler>::Enabled());
+}
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // RAPIDJSON_PARALLELWRITER_H_
@@ -1348,6 +1348,309 @@ bool EraseValueByPointer(T& root, const CharType(&source)[N]) {
 
 //@}
 
+//////////////////////////////////////////////////////////////////////////////
+// Field projection
+
+namespace internal {
+
+//! Generator for GenericDocument::Populate() that keeps only the values selected by a set of pointers.
+/*! The input is walked along the pointers. A selected value is parsed by the
+    reader as usual, containers on the way to one are emitted with only the
+    selected members and elements, and everything else is passed over by
+    GenericReader::SkipValue().
+*/
+template <unsigned parseFlags, typename SourceEncoding, typename InputStream, typename PointerType>
+class PointerProjection {
+public:
+    typedef typename PointerType::EncodingType EncodingType;
+    typedef typename PointerType::Ch Ch;
+    typedef typename PointerType::Token Token;
+    typedef GenericReader<SourceEncoding, EncodingType, CrtAllocator> ReaderType;
+
+    PointerProjection(InputStream& is, const PointerType* pointers, size_t pointerCount) :
+        reader_(), is_(is), pointers_(pointers), pointerCount_(pointerCount), active_(0, 64), key_(0, 64), parseResult_() {}
+
+    template <typename Handler>
+    bool operator()(Handler& handler) {
+        parseResult_.Clear();
+        for (size_t i = 0; i < pointerCount_; i++) {
+            // The root itself is selected
+            if (pointers_[i].GetTokenCount() == 0)
+                return SetResult(reader_.template Parse<parseFlags>(is_, handler));
+            *active_.template Push<size_t>() = i;
+        }
+
+        SkipWhitespace(is_);
+        if (RAPIDJSON_UNLIKELY(is_.Peek() == '\0'))
+            return SetError(kParseErrorDocumentEmpty);
+        if (!ProjectValue(handler, 0, 0, pointerCount_))
+            return false;
+        if (!(parseFlags & kParseStopWhenDoneFlag)) {
+            SkipWhitespace(is_);
+            if (RAPIDJSON_UNLIKELY(is_.Peek() != '\0'))
+                return SetError(kParseErrorDocumentRootNotSingular);
+        }
+        return true;
+    }
+
+    const ParseResult& GetParseResult() const { return parseResult_; }
+
+private:
+    // Values are handed to the reader one at a time.
+    static const unsigned kValueFlags = parseFlags | kParseStopWhenDoneFlag;
+
+    PointerProjection(const PointerProjection&);
+    PointerProjection& operator=(const PointerProjection&);
+
+    // Captures one key.
+    struct KeyHandler : BaseReaderHandler<EncodingType, KeyHandler> {
+        explicit KeyHandler(internal::Stack<CrtAllocator>& key) : key_(key) {}
+        bool Default() { return false; }
+        bool String(const Ch* str, SizeType length, bool) {
+            key_.Clear();
+            std::memcpy(key_.template Push<Ch>(length + 1), str, length * sizeof(Ch));
+            return true;
+        }
+        internal::Stack<CrtAllocator>& key_;
+    private:
+        KeyHandler& operator=(const KeyHandler&);
+    };
+
+    bool SetError(ParseErrorCode code) {
+        parseResult_.Set(code, is_.Tell());
+        return false;
+    }
+
+    bool SetResult(const ParseResult& result) {
+        parseResult_ = result;
+        return !result.IsError();
+    }
+
+    const PointerType& Active(size_t i) const { return pointers_[active_.template Bottom<size_t>()[i]]; }
+    size_t ActiveCount() const { return active_.GetSize() / sizeof(size_t); }
+
+    // Pushes the pointers of [begin, end) whose token at depth matches, and reports whether one of them ends there.
+    bool MatchName(size_t depth, size_t begin, size_t end, const Ch* name, SizeType length) {
+        bool selected = false;
+        for (size_t i = begin; i < end; i++) {
+            const Token& t = Active(i).GetTokens()[depth];
+            if (t.length == length && std::memcmp(t.name, name, length * sizeof(Ch)) == 0)
+                selected = Select(depth, i) || selected;
+        }
+        return selected;
+    }
+
+    bool MatchIndex(size_t depth, size_t begin, size_t end, SizeType index) {
+        bool selected = false;
+        for (size_t i = begin; i < end; i++)
+            if (Active(i).GetTokens()[depth].index == index)
+                selected = Select(depth, i) || selected;
+        return selected;
+    }
+
+    bool Select(size_t depth, size_t i) {
+        if (Active(i).GetTokenCount() == depth + 1)
+            return true;
+        const size_t p = active_.template Bottom<size_t>()[i];
+        *active_.template Push<size_t>() = p;
+        return false;
+    }
+
+    // Scalars that the pointers go through select nothing.
+    template <typename Handler>
+    bool ProjectValue(Handler& handler, size_t depth, size_t begin, size_t end) {
+        const Ch c = is_.Peek();
+        if (c == '{')
+            return ProjectObject(handler, depth, begin, end);
+        if (c == '[')
+            return ProjectArray(handler, depth, begin, end);
+        if (!SetResult(reader_.SkipValue(is_)))
+            return false;
+        return handler.Null() || SetError(kParseErrorTermination);
+    }
+
+    // Whether the member or element at the current position is emitted: if selected, or if it is a container that pointers go through.
+    bool IsEmitted(size_t end, bool selected) {
+        const Ch c = is_.Peek();
+        return selected || (ActiveCount() > end && (c == '{' || c == '['));
+    }
+
+    // The whole value, the selected parts of a container, or nothing.
+    template <typename Handler>
+    bool ProjectMember(Handler& handler, size_t depth, size_t end, bool selected, bool emitted) {
+        const size_t activeEnd = ActiveCount();
+        bool ok;
+        if (selected)
+            ok = SetResult(reader_.template Parse<kValueFlags>(is_, handler));
+        else if (emitted)
+            ok = ProjectValue(handler, depth + 1, end, activeEnd);
+        else
+            ok = SetResult(reader_.SkipValue(is_));
+        active_.template Pop<size_t>(activeEnd - end);
+        return ok;
+    }
+
+    template <typename Handler>
+    bool ProjectObject(Handler& handler, size_t depth, size_t begin, size_t end) {
+        is_.Take();  // Skip '{'
+        if (RAPIDJSON_UNLIKELY(!handler.StartObject()))
+            return SetError(kParseErrorTermination);
+
+        SkipWhitespace(is_);
+        SizeType memberCount = 0;
+        if (is_.Peek() != '}') {
+            for (;;) {
+                if (RAPIDJSON_UNLIKELY(is_.Peek() != '"'))
+                    return SetError(kParseErrorObjectMissName);
+
+                KeyHandler keyHandler(key_);
+                if (!SetResult(reader_.template Parse<kValueFlags>(is_, keyHandler)))
+                    return false;
+                const Ch* name = key_.template Bottom<Ch>();
+                const SizeType length = static_cast<SizeType>(key_.GetSize() / sizeof(Ch) - 1);
+
+                SkipWhitespace(is_);
+                if (RAPIDJSON_UNLIKELY(is_.Peek() != ':'))
+                    return SetError(kParseErrorObjectMissColon);
+                is_.Take();
+                SkipWhitespace(is_);
+
+                const bool selected = MatchName(depth, begin, end, name, length);
+                const bool emitted = IsEmitted(end, selected);
+                if (emitted) {
+                    if (RAPIDJSON_UNLIKELY(!handler.Key(name, length, true)))
+                        return SetError(kParseErrorTermination);
+                    memberCount++;
+                }
+                if (!ProjectMember(handler, depth, end, selected, emitted))
+                    return false;
+
+                SkipWhitespace(is_);
+                const Ch c = is_.Peek();
+                if (c == ',') {
+                    is_.Take();
+                    SkipWhitespace(is_);
+                    if ((parseFlags & kParseTrailingCommasFlag) && is_.Peek() == '}')
+                        break;
+                }
+                else if (c == '}')
+                    break;
+                else
+                    return SetError(kParseErrorObjectMissCommaOrCurlyBracket);
+            }
+        }
+        is_.Take();  // Skip '}'
+        return handler.EndObject(memberCount) || SetError(kParseErrorTermination);
+    }
+
+    // Elements before a selected one are kept as null, so that the pointers still resolve.
+    template <typename Handler>
+    bool ProjectArray(Handler& handler, size_t depth, size_t begin, size_t end) {
+        is_.Take();  // Skip '['
+        if (RAPIDJSON_UNLIKELY(!handler.StartArray()))
+            return SetError(kParseErrorTermination);
+
+        SkipWhitespace(is_);
+        SizeType elementCount = 0;
+        if (is_.Peek() != ']') {
+            for (SizeType index = 0;; index++) {
+                const bool selected = MatchIndex(depth, begin, end, index);
+                const bool emitted = IsEmitted(end, selected);
+                if (emitted) {
+                    for (; elementCount < index; elementCount++)
+                        if (RAPIDJSON_UNLIKELY(!handler.Null()))
+                            return SetError(kParseErrorTermination);
+                    elementCount++;
+                }
+                if (!ProjectMember(handler, depth, end, selected, emitted))
+                    return false;
+
+                SkipWhitespace(is_);
+                const Ch c = is_.Peek();
+                if (c == ',') {
+                    is_.Take();
+                    SkipWhitespace(is_);
+                    if ((parseFlags & kParseTrailingCommasFlag) && is_.Peek() == ']')
+                        break;
+                }
+                else if (c == ']')
+                    break;
+                else
+                    return SetError(kParseErrorArrayMissCommaOrSquareBracket);
+            }
+        }
+        is_.Take();  // Skip ']'
+        return handler.EndArray(elementCount) || SetError(kParseErrorTermination);
+    }
+
+    ReaderType reader_;
+    InputStream& is_;
+    const PointerType* pointers_;
+    size_t pointerCount_;
+    internal::Stack<CrtAllocator> active_;  //!< Indices of the pointers still being followed, one range per depth.
+    internal::Stack<CrtAllocator> key_;     //!< The current key, null-terminated.
+    ParseResult parseResult_;
+};
+
+} // namespace internal
+
+//!@name Field projection
+//@{
+
+//! Parse only the values selected by a set of JSON pointers from an input stream (with Encoding conversion).
+/*! The document receives the selected values, along with the objects and
+    arrays on the way to them. All other values are skipped without number
+    conversion, string unescaping or allocation, and only checked for balanced
+    brackets and terminated strings. Array elements before a selected element
+    are kept as null, so that the pointers resolve in the document as they
+    would in a full parse.
+
+    \tparam parseFlags Combination of \ref ParseFlag. \ref kParseCommentsFlag is not supported.
+    \tparam SourceEncoding Encoding of input stream
+    \param document Document to receive the values. It is left unchanged on error.
+    \param is Input stream to be parsed.
+    \param pointers Pointers selecting the values.
+    \param pointerCount Number of pointers.
+    \return The result of parsing.
+*/
+template <unsigned parseFlags, typename SourceEncoding, typename DocumentType, typename InputStream, typename PointerAllocator>
+ParseResult ParseStreamByPointers(DocumentType& document, InputStream& is, const GenericPointer<typename DocumentType::ValueType, PointerAllocator>* pointers, size_t pointerCount) {
+    RAPIDJSON_STATIC_ASSERT(!(parseFlags & kParseCommentsFlag));
+    internal::PointerProjection<parseFlags, SourceEncoding, InputStream, GenericPointer<typename DocumentType::ValueType, PointerAllocator> > projection(is, pointers, pointerCount);
+    document.Populate(projection);
+    return projection.GetParseResult();
+}
+
+template <unsigned parseFlags, typename DocumentType, typename InputStream, typename PointerAllocator>
+ParseResult ParseStreamByPointers(DocumentType& document, InputStream& is, const GenericPointer<typename DocumentType::ValueType, PointerAllocator>* pointers, size_t pointerCount) {
+    return ParseStreamByPointers<parseFlags, typename DocumentType::EncodingType>(document, is, pointers, pointerCount);
+}
+
+template <typename DocumentType, typename InputStream, typename PointerAllocator>
+ParseResult ParseStreamByPointers(DocumentType& document, InputStream& is, const GenericPointer<typename DocumentType::ValueType, PointerAllocator>* pointers, size_t pointerCount) {
+    return ParseStreamByPointers<kParseDefaultFlags, typename DocumentType::EncodingType>(document, is, pointers, pointerCount);
+}
+
+//! Parse only the values selected by a set of JSON pointers from a read-only string (with Encoding conversion).
+template <unsigned parseFlags, typename SourceEncoding, typename DocumentType, typename PointerAllocator>
+ParseResult ParseByPointers(DocumentType& document, const typename SourceEncoding::Ch* str, const GenericPointer<typename DocumentType::ValueType, PointerAllocator>* pointers, size_t pointerCount) {
+    RAPIDJSON_ASSERT(!(parseFlags & kParseInsituFlag));
+    GenericStringStream<SourceEncoding> s(str);
+    return ParseStreamByPointers<parseFlags, SourceEncoding>(document, s, pointers, pointerCount);
+}
+
+template <unsigned parseFlags, typename DocumentType, typename PointerAllocator>
+ParseResult ParseByPointers(DocumentType& document, const typename DocumentType::Ch* str, const GenericPointer<typename DocumentType::ValueType, PointerAllocator>* pointers, size_t pointerCount) {
+    return ParseByPointers<parseFlags, typename DocumentType::EncodingType>(document, str, pointers, pointerCount);
+}
+
+template <typename DocumentType, typename PointerAllocator>
+ParseResult ParseByPointers(DocumentType& document, const typename DocumentType::Ch* str, const GenericPointer<typename DocumentType::ValueType, PointerAllocator>* pointers, size_t pointerCount) {
+    return ParseByPointers<kParseDefaultFlags, typename DocumentType::EncodingType>(document, str, pointers, pointerCount);
+}
+
+//@}
+
 RAPIDJSON_NAMESPACE_END
 
 #if defined(__clang__) || defined(_MSC_VER)
@@ -60,7 +60,7 @@ public:
 
 
     explicit PrettyWriter(StackAllocator* allocator = 0, size_t levelDepth = Base::kDefaultLevelDepth) : 
-        Base(allocator, levelDepth), indentChar_(' '), indentCharCount_(4) {}
+        Base(allocator, levelDepth), indentChar_(' '), indentCharCount_(4), formatOptions_(kFormatDefault) {}
 
 #if RAPIDJSON_HAS_CXX11_RVALUE_REFS
     PrettyWriter(PrettyWriter&& rhs) :
@@ -87,6 +87,15 @@ public:
         return *this;
     }
 
+    //! Get the character for indentation.
+    Ch GetIndentChar() const { return indentChar_; }
+
+    //! Get the number of indent characters for each indentation level.
+    unsigned GetIndentCharCount() const { return indentCharCount_; }
+
+    //! Get pretty writer formatting options.
+    PrettyFormatOptions GetFormatOptions() const { return formatOptions_; }
+
     /*! @name Implementation of Handler
         \see Handler
     */
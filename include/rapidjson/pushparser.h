@@ -0,0 +1,301 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_PUSHPARSER_H_
+#define RAPIDJSON_PUSHPARSER_H_
+
+/*! \file pushparser.h */
+
+#include "reader.h"
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+//! Non-blocking SAX parser for JSON text which arrives in chunks.
+/*! The caller pushes the text in chunks of any size with Feed(), e.g. as they
+    are received from a socket, and the handler receives the events of every
+    token completed so far. A token cut by the end of a chunk, such as a string
+    in the middle of an escape or a number, is kept until a later chunk
+    completes it. Finish() marks the end of the text.
+
+    There is no thread and no blocking stream, so one parser per connection is
+    enough for many concurrent inputs. Each chunk is scanned once for the last
+    token boundary, then the complete tokens are parsed by the iterative parser
+    of GenericReader (see GenericReader::IterativeParsePartial()). The part of
+    a token that was already received is not scanned again.
+
+    \code
+    PushParser parser;
+    MyHandler handler;
+    while (size_t n = Receive(buffer, sizeof(buffer)))
+        if (!parser.Feed(buffer, n, handler))
+            break;
+    if (!parser.HasParseError())
+        parser.Finish(handler);
+    \endcode
+
+    Use the same parse flags for all calls. \ref kParseInsituFlag and
+    \ref kParseCommentsFlag are not supported, and \ref kParseIterativeFlag is
+    implied. With \ref kParseStopWhenDoneFlag, the text after the root is
+    ignored. The handler must not return \ref kHandlerSkipValue, as the value to
+    skip may not have been received yet.
+
+    \tparam SourceEncoding Encoding of the input.
+    \tparam TargetEncoding Encoding of the events.
+    \tparam StackAllocator Allocator for the pending input and the reader's stack.
+    \note Implements the SAX event publisher of GenericReader.
+*/
+template <typename SourceEncoding, typename TargetEncoding, typename StackAllocator = CrtAllocator>
+class GenericPushParser {
+public:
+    typedef typename SourceEncoding::Ch Ch; //!< SourceEncoding character type
+
+    //! Constructor.
+    /*! \param stackAllocator Optional allocator for the pending input and the reader's stack.
+        \param stackCapacity Initial capacity of the pending input, in bytes.
+    */
+    GenericPushParser(StackAllocator* stackAllocator = 0, size_t stackCapacity = kDefaultStackCapacity) :
+        reader_(stackAllocator), pending_(stackAllocator, stackCapacity), parseResult_(), offset_(), inString_(), escape_(), finished_()
+    {
+        Reset();
+    }
+
+    //! Start over with a new JSON text.
+    void Reset() {
+        reader_.IterativeParseInit();
+        pending_.Clear();
+        *pending_.template Push<Ch>() = '\0';
+        parseResult_.Clear();
+        offset_ = 0;
+        inString_ = escape_ = finished_ = false;
+    }
+
+    //! Parse the next chunk of the JSON text.
+    /*! \tparam parseFlags Combination of \ref ParseFlag, the same for all calls.
+        \param buffer The chunk, which is not needed after the call.
+        \param length Length of the chunk, in Ch.
+        \param handler The handler to receive the events of the completed tokens.
+        \return Whether the parsing is successful so far.
+    */
+    template <unsigned parseFlags, typename Handler>
+    bool Feed(const Ch* buffer, size_t length, Handler& handler) {
+        RAPIDJSON_STATIC_ASSERT(!(parseFlags & (kParseInsituFlag | kParseCommentsFlag)));
+        RAPIDJSON_ASSERT(!finished_);
+        if (HasParseError() || length == 0)
+            return !HasParseError();
+
+        // Append the chunk before the terminator.
+        const size_t pendingLength = PendingLength();
+        pending_.template Pop<Ch>(1);
+        std::memcpy(pending_.template Push<Ch>(length), buffer, length * sizeof(Ch));
+        *pending_.template Push<Ch>() = '\0';
+
+        const Ch* begin = pending_.template Bottom<Ch>();
+        const Ch* boundary = ScanBoundary(begin + pendingLength, begin + pendingLength + length);
+        if (boundary)
+            ParseTo<parseFlags>(static_cast<size_t>(boundary - begin), handler);
+        return !HasParseError();
+    }
+
+    //! Parse the next chunk of the JSON text (with \ref kParseDefaultFlags)
+    template <typename Handler>
+    bool Feed(const Ch* buffer, size_t length, Handler& handler) {
+        return Feed<kParseDefaultFlags>(buffer, length, handler);
+    }
+
+    //! Mark the end of the JSON text.
+    /*! The rest of the text is parsed, and it must complete the root.
+        \tparam parseFlags Combination of \ref ParseFlag, the same for all calls.
+        \param handler The handler to receive the events of the remaining tokens.
+        \return Whether the JSON text was parsed successfully.
+    */
+    template <unsigned parseFlags, typename Handler>
+    bool Finish(Handler& handler) {
+        RAPIDJSON_STATIC_ASSERT(!(parseFlags & (kParseInsituFlag | kParseCommentsFlag)));
+        if (HasParseError())
+            return false;
+        finished_ = true;
+
+        // The end of the text ends the last token, e.g. a number at the root.
+        if (PendingLength() != 0 && !ParseTo<parseFlags>(PendingLength(), handler))
+            return false;
+
+        Ch empty[] = { '\0' };
+        GenericStringStream<SourceEncoding> s(empty);
+        if (!reader_.template IterativeParseNext<ReaderFlags<parseFlags>::kValue>(s, handler))
+            SetParseError();
+        return !HasParseError();
+    }
+
+    //! Mark the end of the JSON text (with \ref kParseDefaultFlags)
+    template <typename Handler>
+    bool Finish(Handler& handler) {
+        return Finish<kParseDefaultFlags>(handler);
+    }
+
+    //! Whether the root has been parsed completely.
+    bool IsComplete() const { return !HasParseError() && reader_.IterativeParseComplete(); }
+
+    //! Whether a parse error has occurred.
+    bool HasParseError() const { return parseResult_.IsError(); }
+
+    //! Get the \ref ParseErrorCode of the parse error.
+    ParseErrorCode GetParseErrorCode() const { return parseResult_.Code(); }
+
+    //! Get the position of the parse error in the whole JSON text, 0 otherwise.
+    size_t GetErrorOffset() const { return parseResult_.Offset(); }
+
+    //! Get the result of parsing so far.
+    const ParseResult& GetParseResult() const { return parseResult_; }
+
+    //! Get the length of the text received but not parsed yet, in Ch.
+    size_t PendingLength() const { return pending_.GetSize() / sizeof(Ch) - 1; }
+
+private:
+    // Prohibit copy constructor & assignment operator.
+    GenericPushParser(const GenericPushParser&);
+    GenericPushParser& operator=(const GenericPushParser&);
+
+    template <unsigned parseFlags>
+    struct ReaderFlags {
+        static const unsigned kValue = parseFlags | kParseIterativeFlag;
+    };
+
+    // Parses the pending text up to the token boundary at position, and keeps the rest.
+    template <unsigned parseFlags, typename Handler>
+    bool ParseTo(size_t position, Handler& handler) {
+        Ch* begin = pending_.template Bottom<Ch>();
+        const Ch c = begin[position];
+        begin[position] = '\0';
+        GenericStringStream<SourceEncoding> s(begin);
+        const bool success = reader_.template IterativeParsePartial<ReaderFlags<parseFlags>::kValue>(s, handler);
+        begin[position] = c;
+        if (!success) {
+            SetParseError();
+            return false;
+        }
+
+        // Move the rest, with the terminator, to the front.
+        const size_t rest = PendingLength() - position;
+        std::memmove(begin, begin + position, (rest + 1) * sizeof(Ch));
+        pending_.template Pop<Ch>(position);
+        offset_ += position;
+        return true;
+    }
+
+    void SetParseError() {
+        parseResult_.Set(reader_.GetParseErrorCode(), offset_ + reader_.GetErrorOffset());
+    }
+
+    // Scans the text just received for the end of the last complete token, with
+    // the state of an unterminated string carried over from the previous chunk.
+    // Only the quotes and escapes are visited going forward; the delimiters are
+    // searched backward in the last text outside strings.
+    const Ch* ScanBoundary(const Ch* p, const Ch* end) {
+        const Ch* close = 0;        // After the last closing quote
+        const Ch* outside = p;      // Start of the text outside strings
+        const Ch* outsideEnd = p;
+        if (escape_ && p != end) {
+            escape_ = false;
+            ++p;
+        }
+        while (p != end) {
+            if (!inString_) {
+                outside = p;
+                outsideEnd = p = FindQuote(p, end);
+                if (p == end)
+                    break;
+                inString_ = true;
+                ++p;
+                continue;
+            }
+
+            p = ScanUnescaped(p, end);
+            if (p == end)
+                break;
+            const Ch c = *p++;
+            if (c == '"') {
+                inString_ = false;
+                close = p;
+            }
+            else if (c == '\\') {
+                if (p == end) {
+                    escape_ = true;
+                    break;
+                }
+                ++p;
+            }
+        }
+
+        while (outsideEnd != outside)
+            if (IsDelimiter(*--outsideEnd))
+                return outsideEnd + 1;
+        return close;
+    }
+
+    static bool IsDelimiter(Ch c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ':' || c == '[' || c == ']' || c == '{' || c == '}';
+    }
+
+    template <typename T>
+    static const T* FindQuote(const T* p, const T* end) {
+        while (p != end && *p != '"')
+            ++p;
+        return p;
+    }
+
+    static const char* FindQuote(const char* p, const char* end) {
+        const void* q = std::memchr(p, '"', static_cast<size_t>(end - p));
+        return q ? static_cast<const char*>(q) : end;
+    }
+
+    template <typename T>
+    static const T* ScanUnescaped(const T* p, const T* end) {
+        while (p != end && !(*p == '"' || *p == '\\' || static_cast<unsigned>(*p) < 0x20))
+            ++p;
+        return p;
+    }
+
+    static const char* ScanUnescaped(const char* p, const char* end) {
+#ifdef RAPIDJSON_SIMD_KERNELS
+        return internal::SimdScanUnescaped(p, end);
+#else
+        return internal::ScanUnescaped_Scalar(p, end);
+#endif
+    }
+
+    static const size_t kDefaultStackCapacity = 1024;   //!< Default capacity of the pending input, in bytes.
+    GenericReader<SourceEncoding, TargetEncoding, StackAllocator> reader_;
+    internal::Stack<StackAllocator> pending_;   //!< Text received but not parsed yet, null-terminated.
+    ParseResult parseResult_;
+    size_t offset_;     //!< Position of the pending text in the whole JSON text.
+    bool inString_;     //!< Whether the pending text ends inside a string.
+    bool escape_;       //!< Whether the pending text ends with a backslash inside a string.
+    bool finished_;
+};
+
+//! Push parser with UTF-8 encoding and default allocator.
+typedef GenericPushParser<UTF8<>, UTF8<> > PushParser;
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_PUSHPARSER_H_
@@ -320,7 +320,7 @@
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
-// RAPIDJSON_SSE2/RAPIDJSON_SSE42/RAPIDJSON_NEON/RAPIDJSON_SIMD
+// RAPIDJSON_SSE2/RAPIDJSON_SSE42/RAPIDJSON_AVX2/RAPIDJSON_AVX512/RAPIDJSON_NEON/RAPIDJSON_SIMD/RAPIDJSON_SIMD_DISPATCH
 
 /*! \def RAPIDJSON_SIMD
     \ingroup RAPIDJSON_CONFIG
@@ -345,11 +345,53 @@
 
     \c RAPIDJSON_SSE42 takes precedence over SSE2, if both are defined.
 
+    Whitespace skipping and string scanning/escaping can further use 32-byte
+    AVX2 or 64-byte AVX-512BW vectors:
+    \code
+    // Enable AVX2 optimization (implies RAPIDJSON_SSE42).
+    #define RAPIDJSON_AVX2
+
+    // Enable AVX-512BW optimization (implies RAPIDJSON_AVX2).
+    #define RAPIDJSON_AVX512
+    \endcode
+
     If any of these symbols is defined, RapidJSON defines the macro
     \c RAPIDJSON_SIMD to indicate the availability of the optimized code.
+
+    \see RAPIDJSON_SIMD_DISPATCH for selecting the instruction set at run time.
+*/
+
+/*! \def RAPIDJSON_SIMD_DISPATCH
+    \ingroup RAPIDJSON_CONFIG
+    \brief Select the SIMD kernels at run time on x86/x64.
+
+    The symbols above bake one instruction set into the binary, so a build for
+    a baseline target never uses the wider extensions of the host. Defining
+    \code
+    #define RAPIDJSON_SIMD_DISPATCH
+    \endcode
+    compiles every kernel family with per-function target attributes and binds
+    the best one supported by the running CPU (detected with \c cpuid) on first
+    use. \c internal::SetSimdLevel() forces a narrower family for testing.
+
+    \c RAPIDJSON_SIMD_DISPATCH takes precedence over the compile-time symbols.
+    It requires GCC 4.9, clang 3.8, MSVC 2015 or newer and is ignored on other
+    architectures.
 */
+#if defined(RAPIDJSON_SIMD_DISPATCH) && !(defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+#undef RAPIDJSON_SIMD_DISPATCH
+#endif
+
+#if defined(RAPIDJSON_AVX512) && !defined(RAPIDJSON_AVX2)
+#define RAPIDJSON_AVX2
+#endif
+#if defined(RAPIDJSON_AVX2) && !defined(RAPIDJSON_SSE42)
+#define RAPIDJSON_SSE42
+#endif
+
 #if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42) \
-    || defined(RAPIDJSON_NEON) || defined(RAPIDJSON_DOXYGEN_RUNNING)
+    || defined(RAPIDJSON_NEON) || defined(RAPIDJSON_SIMD_DISPATCH) \
+    || defined(RAPIDJSON_DOXYGEN_RUNNING)
 #define RAPIDJSON_SIMD
 #endif
 
@@ -591,6 +633,14 @@ RAPIDJSON_NAMESPACE_END
 #endif
 #endif // RAPIDJSON_HAS_CXX11_RANGE_FOR
 
+#ifndef RAPIDJSON_HAS_CXX11_THREADS
+#if (defined(__cplusplus) && __cplusplus >= 201103L) || (defined(_MSC_VER) && _MSC_VER >= 1700)
+#define RAPIDJSON_HAS_CXX11_THREADS 1
+#else
+#define RAPIDJSON_HAS_CXX11_THREADS 0
+#endif
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
 //!@endcond
 
 //! Assertion (in non-throwing contexts).
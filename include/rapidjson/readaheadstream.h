@@ -0,0 +1,248 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef RAPIDJSON_READAHEADSTREAM_H_
+#define RAPIDJSON_READAHEADSTREAM_H_
+
+/*! \file readaheadstream.h */
+
+#include "stream.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include <condition_variable>
+#include <cstdio>
+#include <iosfwd>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#endif
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(padded)
+RAPIDJSON_DIAG_OFF(unreachable-code)
+RAPIDJSON_DIAG_OFF(missing-noreturn)
+#endif
+
+RAPIDJSON_NAMESPACE_BEGIN
+
+namespace internal {
+
+// Reads a block of a file, or of a std::basic_istream<char>.
+inline size_t ReadAheadBlock(std::FILE& fp, char* buffer, size_t size) {
+    return std::fread(buffer, 1, size, &fp);
+}
+
+template <typename StreamType>
+inline size_t ReadAheadBlock(StreamType& stream, char* buffer, size_t size) {
+    stream.read(buffer, static_cast<std::streamsize>(size));
+    return static_cast<size_t>(stream.gcount());
+}
+
+inline void AdviseSequential(std::FILE& fp) {
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fileno(&fp), 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+    (void)fp;
+#endif
+}
+
+template <typename StreamType>
+inline void AdviseSequential(StreamType&) {}
+
+} // namespace internal
+
+//! Byte stream for input which reads ahead on a background thread.
+/*! Like FileReadStream and IStreamWrapper, but a thread fills the next buffers
+    while the current one is parsed, so the parser does not wait for each read
+    of a slow disk. The buffers are used in turn; with more of them, the thread
+    can read further ahead of the parser.
+
+    \code
+    FILE* fp = fopen("big.json", "rb");
+    FileReadAheadStream is(fp);
+    Document d;
+    d.ParseStream(is);
+    fclose(fp);
+    \endcode
+
+    The source must not be used by anything else until the stream is destroyed,
+    which may read past the end of the JSON text.
+
+    \tparam Source \c std::FILE, or a class derived from \c std::basic_istream<char>.
+    \note implements Stream concept
+*/
+template <typename Source>
+class GenericReadAheadStream {
+public:
+    typedef char Ch;    //!< Character type (byte).
+
+    //! Constructor.
+    /*!
+        \param source The file or input stream to read from.
+        \param bufferSize Size of each buffer in bytes. Must >=4 bytes.
+        \param bufferCount Number of buffers. Must >=2.
+    */
+    GenericReadAheadStream(Source& source, size_t bufferSize = kDefaultBufferSize, size_t bufferCount = kDefaultBufferCount) :
+        source_(source), buffers_((bufferSize + 1) * bufferCount), lengths_(bufferCount), bufferSize_(bufferSize), bufferCount_(bufferCount),
+        buffer_(), bufferLast_(), current_(), readCount_(0), count_(0), eof_(false),
+        head_(0), filled_(0), stop_(false), mutex_(), notFull_(), notEmpty_(), thread_()
+    {
+        RAPIDJSON_ASSERT(bufferSize >= 4);
+        RAPIDJSON_ASSERT(bufferCount >= 2);
+        internal::AdviseSequential(source_);
+        thread_ = std::thread(&GenericReadAheadStream::ReadAhead, this);
+        Next();
+    }
+
+    //! Constructor from a file pointer.
+    /*! \see GenericReadAheadStream(Source&, size_t, size_t) */
+    GenericReadAheadStream(Source* source, size_t bufferSize = kDefaultBufferSize, size_t bufferCount = kDefaultBufferCount) :
+        GenericReadAheadStream(*source, bufferSize, bufferCount) {}
+
+    ~GenericReadAheadStream() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        notFull_.notify_one();
+        thread_.join();
+    }
+
+    Ch Peek() const { return *current_; }
+    Ch Take() {
+        Ch c = *current_;
+        if (current_ < bufferLast_)
+            ++current_;
+        else if (!eof_) {
+            Release();
+            Next();
+        }
+        return c;
+    }
+    size_t Tell() const { return count_ + static_cast<size_t>(current_ - buffer_); }
+
+    // Not implemented
+    void Put(Ch) { RAPIDJSON_ASSERT(false); }
+    void Flush() { RAPIDJSON_ASSERT(false); }
+    Ch* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+    size_t PutEnd(Ch*) { RAPIDJSON_ASSERT(false); return 0; }
+
+    // For encoding detection only.
+    const Ch* Peek4() const {
+        return (current_ + 4 <= bufferLast_) ? current_ : 0;
+    }
+
+private:
+    // Prohibit copy constructor & assignment operator.
+    GenericReadAheadStream(const GenericReadAheadStream&);
+    GenericReadAheadStream& operator=(const GenericReadAheadStream&);
+
+    Ch* Buffer(size_t i) { return &buffers_[i * (bufferSize_ + 1)]; }
+
+    // Hands the current buffer back to the thread.
+    void Release() {
+        count_ += readCount_;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            filled_--;
+            head_ = (head_ + 1) % bufferCount_;
+        }
+        notFull_.notify_one();
+    }
+
+    // Waits for the next buffer, as FileReadStream reads it.
+    void Next() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            notEmpty_.wait(lock, [this]() { return filled_ != 0; });
+            readCount_ = lengths_[head_];
+        }
+        buffer_ = current_ = Buffer(head_);
+        bufferLast_ = buffer_ + readCount_ - 1;
+
+        if (readCount_ < bufferSize_) {
+            buffer_[readCount_] = '\0';
+            ++bufferLast_;
+            eof_ = true;
+        }
+    }
+
+    // Fills the free buffers in turn, until the end of the source.
+    void ReadAhead() {
+        for (size_t tail = 0; ; tail = (tail + 1) % bufferCount_) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                notFull_.wait(lock, [this]() { return stop_ || filled_ != bufferCount_; });
+                if (stop_)
+                    return;
+            }
+            const size_t readCount = internal::ReadAheadBlock(source_, Buffer(tail), bufferSize_);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                lengths_[tail] = readCount;
+                filled_++;
+            }
+            notEmpty_.notify_one();
+            if (readCount < bufferSize_)
+                return;
+        }
+    }
+
+    static const size_t kDefaultBufferSize = 65536;
+    static const size_t kDefaultBufferCount = 4;
+
+    Source& source_;
+    std::vector<Ch> buffers_;       //!< bufferCount_ buffers, each with room for a terminator.
+    std::vector<size_t> lengths_;   //!< Number of bytes read into each buffer.
+    size_t bufferSize_;
+    size_t bufferCount_;
+
+    // Used by the parser only
+    Ch *buffer_;
+    Ch *bufferLast_;
+    Ch *current_;
+    size_t readCount_;
+    size_t count_;  //!< Number of characters read
+    bool eof_;
+
+    // Shared with the thread
+    size_t head_;       //!< Buffer being parsed.
+    size_t filled_;     //!< Number of buffers read and not released, including the head.
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+    std::thread thread_;
+};
+
+//! File byte stream for input, reading ahead with fread().
+typedef GenericReadAheadStream<std::FILE> FileReadAheadStream;
+
+//! \c std::istream byte stream for input, reading ahead.
+typedef GenericReadAheadStream<std::istream> IStreamReadAheadStream;
+
+RAPIDJSON_NAMESPACE_END
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // RAPIDJSON_READAHEADSTREAM_H_
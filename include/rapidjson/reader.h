@@ -23,6 +23,7 @@
 #include "internal/meta.h"
 #include "internal/stack.h"
 #include "internal/strtod.h"
+#include "internal/simd.h"
 #include <limits>
 
 #if defined(RAPIDJSON_SIMD) && defined(_MSC_VER)
@@ -163,6 +164,9 @@ enum ParseFlag {
     \brief Concept for receiving events from GenericReader upon parsing.
     The functions return true if no error occurs. If they return false,
     the event publisher should terminate the process.
+
+    StartObject(), StartArray() and Key() may return a HandlerResult instead,
+    to have GenericReader skip a value without generating its events.
 \code
 concept Handler {
     typename Ch;
@@ -185,6 +189,24 @@ concept Handler {
 };
 \endcode
 */
+//! Result of a handler function, for handlers which skip values.
+/*! StartObject(), StartArray() and Key() may return this instead of bool.
+    With kHandlerSkipValue from StartObject() or StartArray(), GenericReader
+    skips the rest of that object or array, without calling EndObject() or
+    EndArray(). From Key(), the value of that member is skipped. The skipped
+    value still counts in the member or element count of its parent.
+
+    Skipped values are scanned by balancing brackets and quotation marks only,
+    so numbers are not converted, strings are not unescaped, and neither is
+    validated.
+    \see GenericReader::SkipValue
+*/
+enum HandlerResult {
+    kHandlerAbort = 0,      //!< Terminate parsing, as returning false.
+    kHandlerContinue = 1,   //!< Continue parsing, as returning true.
+    kHandlerSkipValue = 2   //!< Skip the value started by StartObject()/StartArray(), or the value of the member named by Key().
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // BaseReaderHandler
 
@@ -276,7 +298,29 @@ inline const char* SkipWhitespace(const char* p, const char* end) {
     return p;
 }
 
-#ifdef RAPIDJSON_SSE42
+#ifdef RAPIDJSON_SIMD_KERNELS
+//! Skip whitespace with the AVX2/AVX-512BW kernels or the kernel selected for the running CPU.
+inline const char *SkipWhitespace_SIMD(const char* p) {
+    // Fast return for single non-whitespace
+    if (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+        ++p;
+    else
+        return p;
+
+    return internal::SimdSkipWhitespace(p);
+}
+
+inline const char *SkipWhitespace_SIMD(const char* p, const char* end) {
+    // Fast return for single non-whitespace
+    if (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+    else
+        return p;
+
+    return internal::SimdSkipWhitespace(p, end);
+}
+
+#elif defined(RAPIDJSON_SSE42)
 //! Skip whitespace with SSE 4.2 pcmpistrm instruction, testing 16 8-byte characters at once.
 inline const char *SkipWhitespace_SIMD(const char* p) {
     // Fast return for single non-whitespace
@@ -514,6 +558,35 @@ template<> inline void SkipWhitespace(EncodedInputStream<UTF8<>, MemoryStream>&
 }
 #endif // RAPIDJSON_SIMD
 
+namespace internal {
+
+template <typename Ch>
+inline const Ch* SkipWhitespaceInBlock(const Ch* p, const Ch* end) {
+    while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+    return p;
+}
+
+inline const char* SkipWhitespaceInBlock(const char* p, const char* end) {
+#ifdef RAPIDJSON_SIMD
+    return SkipWhitespace_SIMD(p, end);
+#else
+    return SkipWhitespace(p, end);
+#endif
+}
+
+} // namespace internal
+
+template <typename StreamType>
+class BasicBufferedIStreamWrapper;
+
+//! Template function overload for BasicBufferedIStreamWrapper, which skips the white spaces of each block in place.
+template<typename StreamType>
+inline void SkipWhitespace(BasicBufferedIStreamWrapper<StreamType>& is) {
+    while (is.Consume(internal::SkipWhitespaceInBlock(is.BlockBegin(), is.BlockEnd())))
+        ;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // GenericReader
 
@@ -549,12 +622,13 @@ public:
     /*! \tparam parseFlags Combination of \ref ParseFlag.
         \tparam InputStream Type of input stream, implementing Stream concept.
         \tparam Handler Type of handler, implementing Handler concept.
-        \param is Input stream to be parsed.
+        \param stream Input stream to be parsed.
         \param handler The handler to receive events.
         \return Whether the parsing is successful.
     */
     template <unsigned parseFlags, typename InputStream, typename Handler>
-    ParseResult Parse(InputStream& is, Handler& handler) {
+    ParseResult Parse(InputStream& stream, Handler& handler) {
+        typename StreamParsedAs<InputStream>::Type& is = StreamParsedAs<InputStream>::Get(stream);
         if (parseFlags & kParseIterativeFlag)
             return IterativeParse<parseFlags>(is, handler);
 
@@ -599,11 +673,38 @@ public:
         return Parse<kParseDefaultFlags>(is, handler);
     }
 
+    //! Skip one JSON value without generating events.
+    /*! Leading whitespace is skipped and the stream is left right after the value.
+        Only the structure is checked: brackets must be balanced and strings
+        terminated. Strings are neither unescaped nor validated, and numbers and
+        literals are passed over without conversion or validation.
+        \tparam parseFlags Combination of \ref ParseFlag. Only kParseCommentsFlag makes a difference.
+        \tparam InputStream Type of input stream, implementing Stream concept.
+        \param is Input stream positioned at the value.
+        \return Whether a value was skipped.
+    */
+    template <unsigned parseFlags, typename InputStream>
+    ParseResult SkipValue(InputStream& is) {
+        parseResult_.Clear();
+        ClearStackOnExit scope(*this);
+        SkipWhitespaceAndComments<parseFlags & kParseCommentsFlag>(is);
+        RAPIDJSON_PARSE_ERROR_EARLY_RETURN(parseResult_);
+        SkipBalancedValue<parseFlags & kParseCommentsFlag>(is);
+        return parseResult_;
+    }
+
+    //! Skip one JSON value without generating events (with \ref kParseDefaultFlags)
+    template <typename InputStream>
+    ParseResult SkipValue(InputStream& is) {
+        return SkipValue<kParseDefaultFlags>(is);
+    }
+
     //! Initialize JSON text token-by-token parsing
     /*!
      */
     void IterativeParseInit() {
         parseResult_.Clear();
+        stack_.Clear();
         state_ = IterativeParsingStartState;
     }
 
@@ -669,6 +770,47 @@ public:
         return true;
     }
 
+    //! Parse all tokens of a JSON text received so far
+    /*! Unlike IterativeParseNext(), the end of the stream is not taken as the
+        end of the JSON text: parsing resumes from there on the next call, with
+        a stream of the text that follows. The stream must therefore end
+        between two tokens. IterativeParseNext() on an empty stream completes
+        the parsing.
+        \tparam InputStream Type of input stream, implementing Stream concept
+        \tparam Handler Type of handler, implementing Handler concept.
+        \param is Input stream to be parsed.
+        \param handler The handler to receive events.
+        \return Whether the parsing is successful so far.
+        \see GenericPushParser
+     */
+    template <unsigned parseFlags, typename InputStream, typename Handler>
+    bool IterativeParsePartial(InputStream& is, Handler& handler) {
+        for (;;) {
+            SkipWhitespaceAndComments<parseFlags>(is);
+            if (RAPIDJSON_UNLIKELY(HasParseError()))
+                return false;
+            if (is.Peek() == '\0')
+                return true;
+
+            // Anything after the root is left unread or is an error.
+            if (state_ == IterativeParsingFinishState) {
+                if (parseFlags & kParseStopWhenDoneFlag)
+                    return true;
+                HandleError(state_, is);
+                return false;
+            }
+
+            Token t = Tokenize(is.Peek());
+            IterativeParsingState n = Predict(state_, t);
+            IterativeParsingState d = Transit<parseFlags>(state_, t, n, is, handler);
+            if (RAPIDJSON_UNLIKELY(d == IterativeParsingErrorState)) {
+                HandleError(state_, is);
+                return false;
+            }
+            state_ = d;
+        }
+    }
+
     //! Check if token-by-token parsing JSON text is complete
     /*! \return Whether the JSON has been fully decoded.
      */
@@ -705,6 +847,130 @@ private:
         ClearStackOnExit& operator=(const ClearStackOnExit&);
     };
 
+    // Eight-digit number conversion: the next eight code units when the stream can expose them in memory, else null.
+    template<typename InputStream>
+    static const char* NumberChars8(InputStream&) { return 0; }
+    static const char* NumberChars8(StringStream& is) { return internal::IsDigits8(is.src_) ? is.src_ : 0; }
+    static const char* NumberChars8(InsituStringStream& is) { return internal::IsDigits8(is.src_) ? is.src_ : 0; }
+    static const char* NumberChars8(MemoryStream& is) { return is.end_ - is.src_ >= 8 ? is.src_ : 0; }
+
+    template<typename InputStream>
+    static void SkipNumberChars8(InputStream& is) { for (int i = 0; i < 8; i++) is.Take(); }
+    static void SkipNumberChars8(StringStream& is) { is.src_ += 8; }
+    static void SkipNumberChars8(InsituStringStream& is) { is.src_ += 8; }
+    static void SkipNumberChars8(MemoryStream& is) { is.src_ += 8; }
+
+    // Value skipping: advance past code units that need no attention inside a string.
+    template<typename InputStream>
+    static void SkipUnescapedChars(InputStream&) {}
+    static void SkipUnescapedChars(StringStream& is) { is.src_ = ScanUnescaped(is.src_); }
+    static void SkipUnescapedChars(InsituStringStream& is) { is.src_ = const_cast<char*>(ScanUnescaped(is.src_)); }
+
+    static const char* ScanUnescaped(const char* p) {
+#ifdef RAPIDJSON_SIMD_KERNELS
+        return internal::SimdScanUnescaped(p);
+#else
+        return internal::ScanUnescaped_Scalar(p);
+#endif
+    }
+
+    // Whitespace, '"', ',', ':', '[', ']', '{', '}' and '\0' end a number or literal.
+    static bool IsSkipDelimiter(Ch c) {
+#define Z16 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
+        static const char delimiter[256] = {
+            1,0,0,0,0,0,0,0,0,1,1,0,0,1,0,0, Z16,
+            1,0,1,0,0,0,0,0,0,0,0,0,1,0,0,0, 0,0,0,0,0,0,0,0,0,0,1,0,0,0,0,0,
+            Z16, 0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,0,
+            Z16, 0,0,0,0,0,0,0,0,0,0,0,1,0,1,0,0,
+            Z16, Z16, Z16, Z16, Z16, Z16, Z16, Z16
+        };
+#undef Z16
+        return static_cast<unsigned>(c) < 256 && delimiter[static_cast<unsigned char>(c)];
+    }
+
+    template<typename InputStream>
+    void SkipQuotedString(InputStream& is) {
+        is.Take();  // Skip '\"'
+        for (;;) {
+            SkipUnescapedChars(is);
+            const Ch c = is.Peek();
+            if (c == '"')
+                break;
+            if (RAPIDJSON_UNLIKELY(c == '\0'))
+                RAPIDJSON_PARSE_ERROR(kParseErrorStringMissQuotationMark, is.Tell());
+            is.Take();
+            if (c == '\\' && is.Peek() != '\0')
+                is.Take();
+        }
+        is.Take();  // Skip '\"'
+    }
+
+    // Skip a value by balancing brackets and quotation marks, with the open brackets on stack_.
+    // With open, the rest of an object or array whose bracket has been taken from the stream.
+    template<unsigned parseFlags, typename InputStream>
+    void SkipBalancedValue(InputStream& is, char open = '\0') {
+        const size_t base = stack_.GetSize();
+        if (open) {
+            *stack_.template Push<char>() = open;
+            SkipWhitespaceAndComments<parseFlags>(is);
+            RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+        }
+        for (;;) {
+            const Ch c = is.Peek();
+            switch (c) {
+            case '"':
+                SkipQuotedString(is);
+                RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+                break;
+
+            case '{':
+            case '[':
+                *stack_.template Push<char>() = static_cast<char>(c);
+                is.Take();
+                SkipWhitespaceAndComments<parseFlags>(is);
+                RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+                continue;
+
+            case '}':
+            case ']':
+                if (RAPIDJSON_UNLIKELY(stack_.GetSize() == base))
+                    RAPIDJSON_PARSE_ERROR(kParseErrorValueInvalid, is.Tell());
+                if (RAPIDJSON_UNLIKELY((*stack_.template Pop<char>(1) == '{') != (c == '}')))
+                    RAPIDJSON_PARSE_ERROR(c == ']' ? kParseErrorObjectMissCommaOrCurlyBracket : kParseErrorArrayMissCommaOrSquareBracket, is.Tell());
+                is.Take();
+                break;
+
+            case ',':
+            case ':':
+                if (RAPIDJSON_UNLIKELY(stack_.GetSize() == base))
+                    RAPIDJSON_PARSE_ERROR(kParseErrorValueInvalid, is.Tell());
+                is.Take();
+                SkipWhitespaceAndComments<parseFlags>(is);
+                RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+                continue;
+
+            case '\0':
+                if (stack_.GetSize() == base)
+                    RAPIDJSON_PARSE_ERROR(kParseErrorValueInvalid, is.Tell());
+                RAPIDJSON_PARSE_ERROR(*stack_.template Top<char>() == '{' ? kParseErrorObjectMissCommaOrCurlyBracket : kParseErrorArrayMissCommaOrSquareBracket, is.Tell());
+                break; // This useless break is only for making warning and coverage happy
+
+            default:
+                // Number or literal
+                if (RAPIDJSON_UNLIKELY(IsSkipDelimiter(c)))
+                    RAPIDJSON_PARSE_ERROR(kParseErrorValueInvalid, is.Tell());
+                do {
+                    is.Take();
+                } while (!IsSkipDelimiter(is.Peek()) && !((parseFlags & kParseCommentsFlag) && is.Peek() == '/'));
+                break;
+            }
+            if (stack_.GetSize() == base)
+                return;
+            SkipWhitespaceAndComments<parseFlags>(is);
+            RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+        }
+    }
+
     template<unsigned parseFlags, typename InputStream>
     void SkipWhitespaceAndComments(InputStream& is) {
         SkipWhitespace(is);
@@ -739,8 +1005,13 @@ private:
         RAPIDJSON_ASSERT(is.Peek() == '{');
         is.Take();  // Skip '{'
 
-        if (RAPIDJSON_UNLIKELY(!handler.StartObject()))
+        const HandlerResult hr = ToHandlerResult(handler.StartObject());
+        if (RAPIDJSON_UNLIKELY(hr == kHandlerAbort))
             RAPIDJSON_PARSE_ERROR(kParseErrorTermination, is.Tell());
+        if (RAPIDJSON_UNLIKELY(hr == kHandlerSkipValue)) {
+            SkipBalancedValue<parseFlags>(is, '{');
+            return;
+        }
 
         SkipWhitespaceAndComments<parseFlags>(is);
         RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
@@ -755,7 +1026,7 @@ private:
             if (RAPIDJSON_UNLIKELY(is.Peek() != '"'))
                 RAPIDJSON_PARSE_ERROR(kParseErrorObjectMissName, is.Tell());
 
-            ParseString<parseFlags>(is, handler, true);
+            const bool skip = ParseString<parseFlags>(is, handler, true);
             RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
 
             SkipWhitespaceAndComments<parseFlags>(is);
@@ -767,7 +1038,10 @@ private:
             SkipWhitespaceAndComments<parseFlags>(is);
             RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
 
-            ParseValue<parseFlags>(is, handler);
+            if (RAPIDJSON_UNLIKELY(skip))
+                SkipBalancedValue<parseFlags>(is);
+            else
+                ParseValue<parseFlags>(is, handler);
             RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
 
             SkipWhitespaceAndComments<parseFlags>(is);
@@ -807,8 +1081,13 @@ private:
         RAPIDJSON_ASSERT(is.Peek() == '[');
         is.Take();  // Skip '['
 
-        if (RAPIDJSON_UNLIKELY(!handler.StartArray()))
+        const HandlerResult hr = ToHandlerResult(handler.StartArray());
+        if (RAPIDJSON_UNLIKELY(hr == kHandlerAbort))
             RAPIDJSON_PARSE_ERROR(kParseErrorTermination, is.Tell());
+        if (RAPIDJSON_UNLIKELY(hr == kHandlerSkipValue)) {
+            SkipBalancedValue<parseFlags>(is, '[');
+            return;
+        }
 
         SkipWhitespaceAndComments<parseFlags>(is);
         RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
@@ -953,34 +1232,62 @@ private:
     };
 
     // Parse string and generate String event. Different code paths for kParseInsituFlag.
+    // Returns whether Key() asked for the value of the member to be skipped.
     template<unsigned parseFlags, typename InputStream, typename Handler>
-    void ParseString(InputStream& is, Handler& handler, bool isKey = false) {
+    bool ParseString(InputStream& is, Handler& handler, bool isKey = false) {
         internal::StreamLocalCopy<InputStream> copy(is);
         InputStream& s(copy.s);
 
         RAPIDJSON_ASSERT(s.Peek() == '\"');
+        HandlerResult hr = kHandlerAbort;
         s.Take();  // Skip '\"'
 
-        bool success = false;
         if (parseFlags & kParseInsituFlag) {
             typename InputStream::Ch *head = s.PutBegin();
             ParseStringToStream<parseFlags, SourceEncoding, SourceEncoding>(s, s);
-            RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+            RAPIDJSON_PARSE_ERROR_EARLY_RETURN(false);
             size_t length = s.PutEnd(head) - 1;
             RAPIDJSON_ASSERT(length <= 0xFFFFFFFF);
             const typename TargetEncoding::Ch* const str = reinterpret_cast<typename TargetEncoding::Ch*>(head);
-            success = (isKey ? handler.Key(str, SizeType(length), false) : handler.String(str, SizeType(length), false));
+            hr = StringEvent(handler, str, SizeType(length), false, isKey);
         }
         else {
             StackStream<typename TargetEncoding::Ch> stackStream(stack_);
             ParseStringToStream<parseFlags, SourceEncoding, TargetEncoding>(s, stackStream);
-            RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+            RAPIDJSON_PARSE_ERROR_EARLY_RETURN(false);
             SizeType length = static_cast<SizeType>(stackStream.Length()) - 1;
             const typename TargetEncoding::Ch* const str = stackStream.Pop();
-            success = (isKey ? handler.Key(str, length, true) : handler.String(str, length, true));
+            hr = StringEvent(handler, str, length, true, isKey);
+        }
+        if (RAPIDJSON_UNLIKELY(hr == kHandlerAbort)) {
+            RAPIDJSON_PARSE_ERROR_NORETURN(kParseErrorTermination, s.Tell());
+            return false;
         }
-        if (RAPIDJSON_UNLIKELY(!success))
-            RAPIDJSON_PARSE_ERROR(kParseErrorTermination, s.Tell());
+        return hr == kHandlerSkipValue;
+    }
+
+    // After a key whose value the handler skips: the colon and the value.
+    template<unsigned parseFlags, typename InputStream>
+    void SkipMemberValue(InputStream& is) {
+        SkipWhitespaceAndComments<parseFlags>(is);
+        RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+        if (RAPIDJSON_UNLIKELY(!Consume(is, ':')))
+            RAPIDJSON_PARSE_ERROR(kParseErrorObjectMissColon, is.Tell());
+        SkipWhitespaceAndComments<parseFlags>(is);
+        RAPIDJSON_PARSE_ERROR_EARLY_RETURN_VOID;
+        SkipBalancedValue<parseFlags>(is);
+    }
+
+    // Handler results: bool, or HandlerResult from handlers which skip values.
+    static HandlerResult ToHandlerResult(bool b) { return b ? kHandlerContinue : kHandlerAbort; }
+    static HandlerResult ToHandlerResult(HandlerResult r) { return r; }
+
+    // Key() or String() event. Only Key() can skip a value.
+    template<typename Handler>
+    static HandlerResult StringEvent(Handler& handler, const typename TargetEncoding::Ch* str, SizeType length, bool copy, bool isKey) {
+        if (isKey)
+            return ToHandlerResult(handler.Key(str, length, copy));
+        return handler.String(str, length, copy) ? kHandlerContinue : kHandlerAbort;
     }
 
     // Parse string to an output is
@@ -1003,6 +1310,8 @@ private:
             // Scan and copy string before "\\\"" or < 0x20. This is an optional optimzation.
             if (!(parseFlags & kParseValidateEncodingFlag))
                 ScanCopyUnescapedString(is, os);
+            else if (internal::IsSame<SEncoding, UTF8<> >::Value && internal::IsSame<TEncoding, UTF8<> >::Value)
+                ScanCopyValidUnescapedString(is, os);   // Also stops before the first ill-formed UTF-8 sequence
 
             Ch c = is.Peek();
             if (RAPIDJSON_UNLIKELY(c == '\\')) {    // Escape
@@ -1058,7 +1367,55 @@ private:
             // Do nothing for generic version
     }
 
-#if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
+    template<typename InputStream, typename OutputStream>
+    static RAPIDJSON_FORCEINLINE void ScanCopyValidUnescapedString(InputStream&, OutputStream&) {
+            // Do nothing for generic version
+    }
+
+#ifdef RAPIDJSON_SIMD_SSE42_KERNELS
+    // Copy [src_, q), found by a kernel, to os
+    static RAPIDJSON_FORCEINLINE void CopyUnescapedString(StringStream& is, StackStream<char>& os, const char* q) {
+        const char* p = is.src_;
+        SizeType length = static_cast<SizeType>(q - p);
+        if (length != 0)
+            std::memcpy(os.Push(length), p, length);
+        is.src_ = q;
+    }
+
+    // Move [src_, q) down to dst_; when read/write pointers are the same, just skip it
+    static RAPIDJSON_FORCEINLINE void CopyUnescapedString(InsituStringStream& is, const char* q) {
+        char* p = is.src_;
+        size_t length = static_cast<size_t>(q - p);
+        if (is.dst_ != p)
+            std::memmove(is.dst_, p, length);   // dst_ trails src_, the ranges may overlap
+        is.src_ += length;
+        is.dst_ += length;
+    }
+#endif
+
+#ifdef RAPIDJSON_SIMD_KERNELS
+    // StringStream -> StackStream<char>
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
+        CopyUnescapedString(is, os, internal::SimdScanUnescaped(is.src_));
+    }
+
+    static RAPIDJSON_FORCEINLINE void ScanCopyValidUnescapedString(StringStream& is, StackStream<char>& os) {
+        CopyUnescapedString(is, os, internal::SimdScanValidUnescaped(is.src_));
+    }
+
+    // InsituStringStream -> InsituStringStream
+    static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(InsituStringStream& is, InsituStringStream& os) {
+        RAPIDJSON_ASSERT(&is == &os);
+        (void)os;
+        CopyUnescapedString(is, internal::SimdScanUnescaped(is.src_));
+    }
+
+    static RAPIDJSON_FORCEINLINE void ScanCopyValidUnescapedString(InsituStringStream& is, InsituStringStream& os) {
+        RAPIDJSON_ASSERT(&is == &os);
+        (void)os;
+        CopyUnescapedString(is, internal::SimdScanValidUnescaped(is.src_));
+    }
+#elif defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
     // StringStream -> StackStream<char>
     static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
         const char* p = is.src_;
@@ -1215,6 +1572,19 @@ private:
 
         is.src_ = is.dst_ = p;
     }
+
+#ifdef RAPIDJSON_SSE42
+    // With kParseValidateEncodingFlag, the SSE4.2 kernel also validates UTF-8
+    static RAPIDJSON_FORCEINLINE void ScanCopyValidUnescapedString(StringStream& is, StackStream<char>& os) {
+        CopyUnescapedString(is, os, internal::ScanValidUnescaped_SSE42(is.src_));
+    }
+
+    static RAPIDJSON_FORCEINLINE void ScanCopyValidUnescapedString(InsituStringStream& is, InsituStringStream& os) {
+        RAPIDJSON_ASSERT(&is == &os);
+        (void)os;
+        CopyUnescapedString(is, internal::ScanValidUnescaped_SSE42(is.src_));
+    }
+#endif
 #elif defined(RAPIDJSON_NEON)
     // StringStream -> StackStream<char>
     static RAPIDJSON_FORCEINLINE void ScanCopyUnescapedString(StringStream& is, StackStream<char>& os) {
@@ -1405,6 +1775,15 @@ private:
         RAPIDJSON_FORCEINLINE Ch Take() { return is.Take(); }
 		  RAPIDJSON_FORCEINLINE void Push(char) {}
 
+        //! Take eight digits at once if the stream is contiguous in memory and they are all digits.
+        RAPIDJSON_FORCEINLINE bool TakePushDigits8(uint32_t* value) {
+            const char* p = NumberChars8(is);
+            if (!p || !internal::ParseDigits8(p, value))
+                return false;
+            SkipNumberChars8(is);
+            return true;
+        }
+
         size_t Tell() { return is.Tell(); }
         size_t Length() { return 0; }
         const char* Pop() { return 0; }
@@ -1430,6 +1809,15 @@ private:
             stackStream.Put(c);
         }
 
+        RAPIDJSON_FORCEINLINE bool TakePushDigits8(uint32_t* value) {
+            const char* p = NumberChars8(Base::is);
+            if (!p || !internal::ParseDigits8(p, value))
+                return false;
+            std::memcpy(stackStream.Push(8), p, 8);
+            SkipNumberChars8(Base::is);
+            return true;
+        }
+
         size_t Length() { return stackStream.Length(); }
 
         const char* Pop() {
@@ -1479,6 +1867,13 @@ private:
         else if (RAPIDJSON_LIKELY(s.Peek() >= '1' && s.Peek() <= '9')) {
             i = static_cast<unsigned>(s.TakePush() - '0');
 
+            // Nine digits always fit, whatever the sign
+            uint32_t digits8;
+            if (s.TakePushDigits8(&digits8)) {
+                i = i * 100000000u + digits8;
+                significandDigit += 8;
+            }
+
             if (minus)
                 while (RAPIDJSON_LIKELY(s.Peek() >= '0' && s.Peek() <= '9')) {
                     if (RAPIDJSON_UNLIKELY(i >= 214748364)) { // 2^31 = 2147483648
@@ -1534,6 +1929,14 @@ private:
         // Parse 64bit int
         bool useDouble = false;
         if (use64bit) {
+            // Eight more digits at once while they cannot overflow, e.g. for 19-digit IDs
+            uint32_t digits8;
+            if (i64 <= (minus ? RAPIDJSON_UINT64_C2(0x00000015, 0x798EE22F) : RAPIDJSON_UINT64_C2(0x0000002A, 0xF31DC460)) && // (2^63 - 99999999) / 10^8, (2^64 - 1 - 99999999) / 10^8
+                s.TakePushDigits8(&digits8)) {
+                i64 = i64 * 100000000u + digits8;
+                significandDigit += 8;
+            }
+
             if (minus)
                 while (RAPIDJSON_LIKELY(s.Peek() >= '0' && s.Peek() <= '9')) {
                      if (RAPIDJSON_UNLIKELY(i64 >= RAPIDJSON_UINT64_C2(0x0CCCCCCC, 0xCCCCCCCC))) // 2^63 = 9223372036854775808
@@ -1580,6 +1983,14 @@ private:
                 if (!use64bit)
                     i64 = i;
 
+                // Eight digits at once while the significand stays within 2^53 - 1; leading zeros go the scalar way
+                uint32_t digits8;
+                if (i64 != 0 && i64 <= 90071991 && s.TakePushDigits8(&digits8)) {
+                    i64 = i64 * 100000000u + digits8;
+                    expFrac -= 8;
+                    significandDigit += 8;
+                }
+
                 while (RAPIDJSON_LIKELY(s.Peek() >= '0' && s.Peek() <= '9')) {
                     if (i64 > RAPIDJSON_UINT64_C2(0x1FFFFF, 0xFFFFFFFF)) // 2^53 - 1 for fast path
                         break;
@@ -2014,12 +2425,20 @@ private:
             // Initialize and push the member/element count.
             *stack_.template Push<SizeType>(1) = 0;
             // Call handler
-            bool hr = (dst == IterativeParsingObjectInitialState) ? handler.StartObject() : handler.StartArray();
+            HandlerResult hr = (dst == IterativeParsingObjectInitialState) ? ToHandlerResult(handler.StartObject()) : ToHandlerResult(handler.StartArray());
             // On handler short circuits the parsing.
-            if (!hr) {
+            if (hr == kHandlerAbort) {
                 RAPIDJSON_PARSE_ERROR_NORETURN(kParseErrorTermination, is.Tell());
                 return IterativeParsingErrorState;
             }
+            else if (hr == kHandlerSkipValue) {
+                // The value is complete once skipped, as if finished.
+                stack_.template Pop<SizeType>(2);
+                SkipBalancedValue<parseFlags>(is, static_cast<char>(is.Take()));
+                if (HasParseError())
+                    return IterativeParsingErrorState;
+                return n == IterativeParsingStartState ? IterativeParsingFinishState : n;
+            }
             else {
                 is.Take();
                 return dst;
@@ -2027,7 +2446,11 @@ private:
         }
 
         case IterativeParsingMemberKeyState:
-            ParseString<parseFlags>(is, handler, true);
+            if (ParseString<parseFlags>(is, handler, true)) {
+                // The colon and the value are skipped along with the key.
+                SkipMemberValue<parseFlags>(is);
+                return HasParseError() ? IterativeParsingErrorState : IterativeParsingMemberValueState;
+            }
             if (HasParseError())
                 return IterativeParsingErrorState;
             else
@@ -79,6 +79,19 @@ struct StreamTraits {
     enum { copyOptimization = 0 };
 };
 
+//! Provides the type of stream which the reader parses a stream as.
+/*!
+    A stream over a zero-terminated string in memory, such as MmapReadStream,
+    can derive from GenericStringStream and specialize this with its base, so
+    that the reader uses the optimizations for string streams. A wrapper, such
+    as LazyCursorStreamWrapper, can specialize this to parse the wrapped stream.
+*/
+template<typename Stream>
+struct StreamParsedAs {
+    typedef Stream Type;
+    static Type& Get(Stream& stream) { return stream; }
+};
+
 //! Reserve n characters for writing to a stream.
 template<typename Stream>
 inline void PutReserve(Stream& stream, size_t count) {
@@ -92,6 +105,13 @@ inline void PutUnsafe(Stream& stream, typename Stream::Ch c) {
     stream.Put(c);
 }
 
+//! Write n characters to a stream, presuming buffer is reserved.
+template<typename Stream>
+inline void PutBlockUnsafe(Stream& stream, const typename Stream::Ch* str, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        PutUnsafe(stream, str[i]);
+}
+
 //! Put N copies of a character to a stream.
 template<typename Stream, typename Ch>
 inline void PutN(Stream& stream, Ch c, size_t n) {
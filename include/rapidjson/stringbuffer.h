@@ -106,6 +106,12 @@ inline void PutUnsafe(GenericStringBuffer<Encoding, Allocator>& stream, typename
     stream.PutUnsafe(c);
 }
 
+//! Implement specialized version of PutBlockUnsafe() with memcpy() for better performance.
+template<typename Encoding, typename Allocator>
+inline void PutBlockUnsafe(GenericStringBuffer<Encoding, Allocator>& stream, const typename Encoding::Ch* str, size_t n) {
+    std::memcpy(stream.PushUnsafe(n), str, n * sizeof(*str));
+}
+
 //! Implement specialized version of PutN() with memset() for better performance.
 template<>
 inline void PutN(GenericStringBuffer<UTF8<> >& stream, char c, size_t n) {
@@ -20,7 +20,9 @@
 #include "internal/stack.h"
 #include "internal/strfunc.h"
 #include "internal/dtoa.h"
+#include "internal/schubfach.h"
 #include "internal/itoa.h"
+#include "internal/simd.h"
 #include "stringbuffer.h"
 #include <new>      // placement new
 
@@ -66,9 +68,57 @@ enum WriteFlag {
     kWriteNoFlags = 0,              //!< No flags are set.
     kWriteValidateEncodingFlag = 1, //!< Validate encoding of JSON strings.
     kWriteNanAndInfFlag = 2,        //!< Allow writing of Infinity, -Infinity and NaN.
+    kWriteShortestDoubleFlag = 4,   //!< Write doubles with the Schubfach algorithm, always the shortest digits that read back to the same double, instead of Grisu2.
     kWriteDefaultFlags = RAPIDJSON_WRITE_DEFAULT_FLAGS  //!< Default write flags. Can be customized by defining RAPIDJSON_WRITE_DEFAULT_FLAGS
 };
 
+namespace internal {
+
+//! Whether the writer copies the code units of SourceEncoding as they are to TargetEncoding, outside of escapes.
+template <typename SourceEncoding, typename TargetEncoding>
+struct WriteCopiesCodeUnits : FalseType {};
+
+template <typename CharType>
+struct WriteCopiesCodeUnits<UTF8<CharType>, UTF8<CharType> > : TrueType {};
+
+template <typename CharType>
+struct WriteCopiesCodeUnits<UTF16<CharType>, UTF16<CharType> > : TrueType {};
+
+template <typename CharType>
+struct WriteCopiesCodeUnits<UTF32<CharType>, UTF32<CharType> > : TrueType {};
+
+//! Find the end of the run of code units at p which the writer copies without escaping.
+/*! The run stops at '"', '\\' or a control character. When validating, it also
+    stops at an ill-formed UTF-8 sequence, and at any non-ASCII UTF-16 or UTF-32
+    code unit, which is validated one by one.
+*/
+template <typename Ch>
+inline const Ch* ScanWriteRun(const Ch* p, const Ch* end, bool validate) {
+    const uint32_t highMask = validate ? ~static_cast<uint32_t>(0x7F) : 0;
+#ifdef RAPIDJSON_SIMD_KERNELS
+    if (sizeof(Ch) == 2)
+        p += SimdScanUnescaped16(p, static_cast<size_t>(end - p), highMask);
+    else if (sizeof(Ch) == 4)
+        p += SimdScanUnescaped32(p, static_cast<size_t>(end - p), highMask);
+#endif
+    for (; p != end; ++p) {
+        const uint32_t c = static_cast<uint32_t>(*p);
+        if (c == '\"' || c == '\\' || c < 0x20 || (c & highMask) != 0)
+            break;
+    }
+    return p;
+}
+
+inline const char* ScanWriteRun(const char* p, const char* end, bool validate) {
+#ifdef RAPIDJSON_SIMD_KERNELS
+    return validate ? SimdScanValidUnescaped(p, end) : SimdScanUnescaped(p, end);
+#else
+    return validate ? ScanValidUnescaped_Scalar(p, end) : ScanUnescaped_Scalar(p, end);
+#endif
+}
+
+} // namespace internal
+
 //! JSON writer
 /*! Writer implements the concept Handler.
     It generates JSON text by events to an output os.
@@ -366,7 +416,7 @@ protected:
         }
 
         char buffer[25];
-        char* end = internal::dtoa(d, buffer, maxDecimalPlaces_);
+        char* end = (writeFlags & kWriteShortestDoubleFlag) ? internal::ShortestDtoa(d, buffer, maxDecimalPlaces_) : internal::dtoa(d, buffer, maxDecimalPlaces_);
         PutReserve(*os_, static_cast<size_t>(end - buffer));
         for (char* p = buffer; p != end; ++p)
             PutUnsafe(*os_, static_cast<typename OutputStream::Ch>(*p));
@@ -447,7 +497,30 @@ protected:
         return true;
     }
 
+    //! Whether characters are copied as they are, to a stream of the same character type.
+    typedef internal::BoolType<
+        internal::WriteCopiesCodeUnits<SourceEncoding, TargetEncoding>::Value && internal::IsSame<Ch, typename OutputStream::Ch>::Value> CopiesCodeUnits;
+
+    //! Copy the run of characters at \c is which need no escaping, as a block.
+    /*! Only when they are copied as they are, to a stream of the same character type.
+        \return Whether characters remain, starting with one to be escaped or transcoded.
+    */
     bool ScanWriteUnescapedString(GenericStringStream<SourceEncoding>& is, size_t length) {
+        return ScanWriteUnescapedString(is, length, CopiesCodeUnits());
+    }
+
+    bool ScanWriteUnescapedString(GenericStringStream<SourceEncoding>& is, size_t length, internal::TrueType) {
+        if (length >= 16 && is.Tell() < length) {
+            const Ch* p = is.src_;
+            const Ch* q = internal::ScanWriteRun(p, is.head_ + length, (writeFlags & kWriteValidateEncodingFlag) != 0);
+            if (q != p)
+                PutBlockUnsafe(*os_, p, static_cast<size_t>(q - p));
+            is.src_ = q;
+        }
+        return RAPIDJSON_LIKELY(is.Tell() < length);
+    }
+
+    bool ScanWriteUnescapedString(GenericStringStream<SourceEncoding>& is, size_t length, internal::FalseType) {
         return RAPIDJSON_LIKELY(is.Tell() < length);
     }
 
@@ -458,10 +531,11 @@ protected:
 
     bool WriteRawValue(const Ch* json, size_t length) {
         PutReserve(*os_, length);
+        if (!(writeFlags & kWriteValidateEncodingFlag) && CopyRawValue(json, length, CopiesCodeUnits()))
+            return true;
         GenericStringStream<SourceEncoding> is(json);
         while (RAPIDJSON_LIKELY(is.Tell() < length)) {
-            const Ch c = is.Peek();
-            RAPIDJSON_ASSERT(c != '\0');
+            RAPIDJSON_ASSERT(is.Peek() != '\0');
             if (RAPIDJSON_UNLIKELY(!(writeFlags & kWriteValidateEncodingFlag ? 
                 Transcoder<SourceEncoding, TargetEncoding>::Validate(is, *os_) :
                 Transcoder<SourceEncoding, TargetEncoding>::TranscodeUnsafe(is, *os_))))
@@ -470,6 +544,13 @@ protected:
         return true;
     }
 
+    bool CopyRawValue(const Ch* json, size_t length, internal::TrueType) {
+        PutBlockUnsafe(*os_, json, length);
+        return true;
+    }
+
+    bool CopyRawValue(const Ch*, size_t, internal::FalseType) { return false; }
+
     void Prefix(Type type) {
         (void)type;
         if (RAPIDJSON_LIKELY(level_stack_.GetSize() != 0)) { // this value is not at root
@@ -565,12 +646,14 @@ inline bool Writer<StringBuffer>::WriteDouble(double d) {
     }
     
     char *buffer = os_->Push(25);
-    char* end = internal::dtoa(d, buffer, maxDecimalPlaces_);
+    char* end = (kWriteDefaultFlags & kWriteShortestDoubleFlag) ? internal::ShortestDtoa(d, buffer, maxDecimalPlaces_) : internal::dtoa(d, buffer, maxDecimalPlaces_);
     os_->Pop(static_cast<size_t>(25 - (end - buffer)));
     return true;
 }
 
-#if defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
+#if defined(RAPIDJSON_SIMD_KERNELS)
+// The generic ScanWriteUnescapedString() uses the kernels of internal/simd.h.
+#elif defined(RAPIDJSON_SSE2) || defined(RAPIDJSON_SSE42)
 template<>
 inline bool Writer<StringBuffer>::ScanWriteUnescapedString(StringStream& is, size_t length) {
     if (length < 16)
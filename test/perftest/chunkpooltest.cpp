@@ -0,0 +1,74 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Documents created and destroyed on many threads, with chunks from malloc() or from a shared ChunkPool.
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/chunkpool.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/document.h"
+#include <thread>
+#include <vector>
+
+using namespace rapidjson;
+
+class RapidJsonChunkPool : public PerfTest {
+protected:
+    // Parses sample.json kChunkPoolTrialCount times in total, split over the threads.
+    template <typename DocumentType>
+    void ParseThreads(unsigned threadCount) {
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t < threadCount; t++)
+            threads.push_back(std::thread([this, threadCount]() {
+                for (size_t i = 0; i < kChunkPoolTrialCount / threadCount; i++) {
+                    DocumentType d;
+                    d.Parse(json_);
+                    EXPECT_TRUE(d.IsObject());
+                }
+            }));
+        for (size_t t = 0; t < threads.size(); t++)
+            threads[t].join();
+    }
+
+    static const size_t kChunkPoolTrialCount = 640;
+};
+
+typedef GenericDocument<UTF8<>, MemoryPoolAllocator<ChunkPoolAllocator> > PooledDocument;
+
+#define TEST_CHUNKPOOL(Threads) \
+TEST_F(RapidJsonChunkPool, DocumentParse_CrtAllocator_Threads##Threads) { ParseThreads<Document>(Threads); } \
+TEST_F(RapidJsonChunkPool, DocumentParse_ChunkPoolAllocator_Threads##Threads) { ParseThreads<PooledDocument>(Threads); }
+TEST_CHUNKPOOL(1)
+TEST_CHUNKPOOL(4)
+TEST_CHUNKPOOL(16)
+TEST_CHUNKPOOL(64)
+#undef TEST_CHUNKPOOL
+
+TEST_F(RapidJsonChunkPool, Stats) {
+    ParseThreads<PooledDocument>(16);
+    ChunkPoolStats stats = ChunkPool::Global().GetStats();
+    printf("ChunkPool: %u hits, %u misses, %u returns, %u releases, %u cached\n",
+        static_cast<unsigned>(stats.hits), static_cast<unsigned>(stats.misses), static_cast<unsigned>(stats.returns),
+        static_cast<unsigned>(stats.releases), static_cast<unsigned>(stats.cached));
+    EXPECT_GT(stats.hits, stats.misses);
+}
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // TEST_RAPIDJSON
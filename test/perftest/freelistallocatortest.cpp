@@ -0,0 +1,112 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// A long-lived document modified again and again, with the resident set size over time.
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/document.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace rapidjson;
+
+class RapidJsonFreeList : public PerfTest {
+protected:
+    // Resident set size of the process in KB, or 0 where unknown.
+    static size_t ResidentSize() {
+        size_t kb = 0;
+#ifdef __linux__
+        if (FILE* fp = fopen("/proc/self/statm", "r")) {
+            unsigned long size, resident;
+            if (fscanf(fp, "%lu %lu", &size, &resident) == 2)
+                kb = resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+            fclose(fp);
+        }
+#endif
+        return kb;
+    }
+
+    // Replaces strings, grows and clears arrays, and adds and removes members
+    // of records in a document, kChurnCount times.
+    template <typename DocumentType>
+    void Churn(const char* name) {
+        typedef typename DocumentType::ValueType ValueType;
+        const size_t rss = ResidentSize();
+
+        DocumentType d;
+        typename DocumentType::AllocatorType& a = d.GetAllocator();
+        d.SetArray();
+        for (unsigned i = 0; i < kRecordCount; i++) {
+            ValueType record(kObjectType);
+            record.AddMember("id", i, a);
+            record.AddMember("name", ValueType("a record of the document", a), a);
+            record.AddMember("tags", ValueType(kArrayType), a);
+            d.PushBack(record, a);
+        }
+
+        char text[256];
+        memset(text, 'x', sizeof(text));
+        uint32_t x = 2463534242u;
+        for (size_t i = 0; i < kChurnCount; i++) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            ValueType& record = d[x % kRecordCount];
+            switch ((x >> 16) % 4) {
+            case 0:
+                record["name"].SetString(text, (x >> 8) % 200 + 20, a);
+                break;
+            case 1:
+                if (record["tags"].Size() >= 32)
+                    record["tags"].SetArray();
+                record["tags"].PushBack(ValueType(text, (x >> 8) % 40 + 20, a), a);
+                break;
+            case 2:
+                if (!record.RemoveMember("extra"))
+                    record.AddMember("extra", ValueType(kObjectType).AddMember("text", ValueType(text, 100, a), a), a);
+                break;
+            default:
+                record.SetObject();
+                record.AddMember("id", i, a);
+                record.AddMember("name", ValueType(text, 30, a), a);
+                record.AddMember("tags", ValueType(kArrayType), a);
+                break;
+            }
+
+            if ((i + 1) % (kChurnCount / 4) == 0)
+                printf("%-20s %8u changes: RSS +%u KB\n", name, static_cast<unsigned>(i + 1), static_cast<unsigned>(ResidentSize() - rss));
+        }
+        EXPECT_EQ(static_cast<SizeType>(kRecordCount), d.Size());
+    }
+
+    static const unsigned kRecordCount = 10000;
+    static const size_t kChurnCount = 2000000;
+};
+
+TEST_F(RapidJsonFreeList, DocumentChurn_MemoryPoolAllocator) {
+    Churn<Document>("MemoryPoolAllocator");
+}
+
+TEST_F(RapidJsonFreeList, DocumentChurn_CrtAllocator) {
+    Churn<GenericDocument<UTF8<>, CrtAllocator> >("CrtAllocator");
+}
+
+TEST_F(RapidJsonFreeList, DocumentChurn_FreeListAllocator) {
+    Churn<GenericDocument<UTF8<>, FreeListAllocator<> > >("FreeListAllocator");
+}
+
+#endif // TEST_RAPIDJSON
@@ -0,0 +1,99 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Writing a document of long strings to a file descriptor with writev(), compared to StringBuffer and write().
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/iovecwritestream.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include <fcntl.h>
+#include <string>
+
+using namespace rapidjson;
+
+class RapidJsonIoVec : public PerfTest {
+public:
+    RapidJsonIoVec() : PerfTest(), d_(), fd_(-1) {}
+
+    virtual void SetUp() {
+        PerfTest::SetUp();
+        fd_ = open("/dev/null", O_WRONLY);
+        ASSERT_GE(fd_, 0);
+
+        // Records with a short name and a text of 1 to 4 KB, about 10 MB in all.
+        Document::AllocatorType& a = d_.GetAllocator();
+        std::string text;
+        for (size_t i = 0; i < 4096; i++)
+            text += static_cast<char>('a' + i % 26);
+        d_.SetArray();
+        for (unsigned i = 0; i < 4000; i++) {
+            Value record(kObjectType);
+            record.AddMember("id", i, a);
+            record.AddMember("name", "record", a);
+            record.AddMember("text", Value(text.c_str(), 1024 + i % 3072, a), a);
+            d_.PushBack(record, a);
+        }
+    }
+
+    virtual void TearDown() {
+        close(fd_);
+        d_.SetNull();
+        PerfTest::TearDown();
+    }
+
+protected:
+    void WriteIoVec(size_t minReferenceSize) {
+        size_t copied = 0, referenced = 0;
+        for (size_t i = 0; i < kWriteCount; i++) {
+            IoVecWriteStream os(fd_, minReferenceSize);
+            Writer<IoVecWriteStream> writer(os);
+            d_.Accept(writer);
+            EXPECT_FALSE(os.HasError());
+            copied = os.GetCopiedSize();
+            referenced = os.GetReferencedSize();
+        }
+        printf("%10u bytes copied, %10u bytes referenced\n", static_cast<unsigned>(copied), static_cast<unsigned>(referenced));
+    }
+
+    static const size_t kWriteCount = 100;
+
+    Document d_;
+    int fd_;
+};
+
+TEST_F(RapidJsonIoVec, Writer_StringBuffer_Write) {
+    for (size_t i = 0; i < kWriteCount; i++) {
+        StringBuffer sb;
+        Writer<StringBuffer> writer(sb);
+        d_.Accept(writer);
+        EXPECT_EQ(static_cast<ssize_t>(sb.GetSize()), write(fd_, sb.GetString(), sb.GetSize()));
+        if (i == 0)
+            printf("%10u bytes copied\n", static_cast<unsigned>(sb.GetSize()));
+    }
+}
+
+TEST_F(RapidJsonIoVec, Writer_IoVecWriteStream_Writev) { WriteIoVec(IoVecWriteStream::kDefaultMinReferenceSize); }
+TEST_F(RapidJsonIoVec, Writer_IoVecWriteStream_Writev_CopyAll) { WriteIoVec(~size_t(0)); }
+
+#endif // defined(__unix__) || defined(__APPLE__)
+
+#endif // TEST_RAPIDJSON
@@ -0,0 +1,117 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Parallel JSON Lines parsing, scaling from one thread to all hardware threads.
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/jsonlines.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include <atomic>
+#include <string>
+
+using namespace rapidjson;
+
+class RapidJsonLines : public PerfTest {
+public:
+    RapidJsonLines() : lines_() {}
+
+    virtual void SetUp() {
+        PerfTest::SetUp();
+
+        // The records of types/mixed.json, one per line, repeated to 32 MB.
+        ASSERT_TRUE(types_[4] != 0);
+        Document d;
+        d.Parse(types_[4]);
+        ASSERT_TRUE(d.IsArray());
+        std::string records;
+        for (Value::ConstValueIterator itr = d.Begin(); itr != d.End(); ++itr) {
+            StringBuffer sb;
+            Writer<StringBuffer> writer(sb);
+            itr->Accept(writer);
+            records += sb.GetString();
+            records += '\n';
+        }
+        while (lines_.size() < (32u << 20))
+            lines_ += records;
+    }
+
+    virtual void TearDown() {
+        lines_.clear();
+        PerfTest::TearDown();
+    }
+
+protected:
+    template <bool ordered>
+    void ParseLines(unsigned threadCount) {
+        JsonLinesParser parser(threadCount);
+        parser.SetOrdered(ordered);
+        for (size_t i = 0; i < kLinesTrialCount; i++) {
+            RecordCounter counter;
+            EXPECT_TRUE(parser.Parse(lines_.data(), lines_.size(), counter));
+            EXPECT_GT(counter.count, 0u);
+        }
+    }
+
+    struct RecordCounter {
+        RecordCounter() : count(0) {}
+        bool operator()(size_t, Document& d) { count++; return !d.HasParseError(); }
+        std::atomic<size_t> count;
+    };
+
+    static const size_t kLinesTrialCount = 10;
+    std::string lines_;
+};
+
+#define TEST_JSONLINES(Threads) \
+TEST_F(RapidJsonLines, JsonLinesParse_Threads##Threads) { ParseLines<true>(Threads); } \
+TEST_F(RapidJsonLines, JsonLinesParse_Unordered_Threads##Threads) { ParseLines<false>(Threads); }
+TEST_JSONLINES(1)
+TEST_JSONLINES(2)
+TEST_JSONLINES(4)
+TEST_JSONLINES(8)
+TEST_JSONLINES(16)
+#undef TEST_JSONLINES
+
+TEST_F(RapidJsonLines, JsonLinesParse_AllThreads) {
+    ParseLines<true>(0);
+}
+
+// The same lines parsed one after another on a single thread, as a baseline.
+TEST_F(RapidJsonLines, DocumentParse_Lines) {
+    std::string lines = lines_;
+    for (size_t i = 0; i < kLinesTrialCount; i++) {
+        size_t count = 0;
+        Document d;
+        for (char* p = &lines[0]; *p; count++) {
+            char* newline = strchr(p, '\n');
+            *newline = '\0';
+            d.Parse(p);
+            EXPECT_FALSE(d.HasParseError());
+            *newline = '\n';
+            p = newline + 1;
+        }
+        EXPECT_GT(count, 0u);
+    }
+}
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // TEST_RAPIDJSON
@@ -0,0 +1,40 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Member lookup with the hash index, against DocumentFindMember_* in rapidjsontest.cpp.
+
+#define RAPIDJSON_MEMBER_INDEX 1
+#define RAPIDJSON_NAMESPACE rapidjson_memberindex
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/document.h"
+
+class RapidJsonMemberIndex : public PerfTest {
+};
+
+#define TEST_FINDMEMBER(Count) \
+TEST_F(RapidJsonMemberIndex, DocumentFindMember_##Count) { \
+    FindMemberBenchmark<rapidjson_memberindex::Document>(Count, 1u << 17); \
+}
+TEST_FINDMEMBER(8)
+TEST_FINDMEMBER(32)
+TEST_FINDMEMBER(128)
+TEST_FINDMEMBER(1024)
+TEST_FINDMEMBER(4096)
+#undef TEST_FINDMEMBER
+
+#endif // TEST_RAPIDJSON
@@ -0,0 +1,106 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Parallel parsing of a large top-level array, scaling from one thread to all hardware threads.
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/document.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include <string>
+
+using namespace rapidjson;
+
+class RapidJsonParallel : public PerfTest {
+public:
+    RapidJsonParallel() : lines_(), minified_() {}
+
+    virtual void SetUp() {
+        PerfTest::SetUp();
+
+        // The records of types/mixed.json repeated to 32 MB, one per line or all on one line.
+        ASSERT_TRUE(types_[4] != 0);
+        Document d;
+        d.Parse(types_[4]);
+        ASSERT_TRUE(d.IsArray());
+        std::string records;
+        for (Value::ConstValueIterator itr = d.Begin(); itr != d.End(); ++itr) {
+            StringBuffer sb;
+            Writer<StringBuffer> writer(sb);
+            itr->Accept(writer);
+            records += sb.GetString();
+            records += ",\n";
+        }
+        lines_ = "[\n";
+        while (lines_.size() < (32u << 20))
+            lines_ += records;
+        lines_.replace(lines_.size() - 2, 2, "\n]");
+
+        minified_ = lines_;
+        for (size_t i = 0; i < minified_.size(); i++)
+            if (minified_[i] == '\n')
+                minified_[i] = ' ';
+    }
+
+    virtual void TearDown() {
+        lines_.clear();
+        minified_.clear();
+        PerfTest::TearDown();
+    }
+
+protected:
+    void ParseParallel(const std::string& json, unsigned threadCount) {
+        for (size_t i = 0; i < kParallelTrialCount; i++) {
+            Document d;
+            d.ParseParallel(json.c_str(), threadCount);
+            EXPECT_TRUE(d.IsArray());
+        }
+    }
+
+    static const size_t kParallelTrialCount = 10;
+    std::string lines_;
+    std::string minified_;
+};
+
+#define TEST_PARALLEL(Threads) \
+TEST_F(RapidJsonParallel, DocumentParseParallel_Threads##Threads) { ParseParallel(lines_, Threads); } \
+TEST_F(RapidJsonParallel, DocumentParseParallel_Minified_Threads##Threads) { ParseParallel(minified_, Threads); }
+TEST_PARALLEL(1)
+TEST_PARALLEL(2)
+TEST_PARALLEL(4)
+TEST_PARALLEL(8)
+#undef TEST_PARALLEL
+
+TEST_F(RapidJsonParallel, DocumentParseParallel_AllThreads) {
+    ParseParallel(lines_, 0);
+}
+
+// The same array parsed by Parse(), as a baseline.
+TEST_F(RapidJsonParallel, DocumentParse_Array) {
+    for (size_t i = 0; i < kParallelTrialCount; i++) {
+        Document d;
+        d.Parse(lines_.c_str());
+        EXPECT_TRUE(d.IsArray());
+    }
+}
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // TEST_RAPIDJSON
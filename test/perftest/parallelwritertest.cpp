@@ -0,0 +1,92 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Parallel writing of a large top-level array, scaling from one thread to all hardware threads.
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/parallelwriter.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/document.h"
+
+using namespace rapidjson;
+
+class RapidJsonParallelWriter : public PerfTest {
+public:
+    RapidJsonParallelWriter() : d_() {}
+
+    virtual void SetUp() {
+        PerfTest::SetUp();
+
+        // The records of types/mixed.json repeated to 32 MB of JSON.
+        ASSERT_TRUE(types_[4] != 0);
+        Document records;
+        records.Parse(types_[4]);
+        ASSERT_TRUE(records.IsArray());
+        d_.SetArray();
+        for (size_t size = 0; size < (32u << 20); size += typesLength_[4]) {
+            Value copy(records, d_.GetAllocator());
+            for (Value::ValueIterator itr = copy.Begin(); itr != copy.End(); ++itr)
+                d_.PushBack(*itr, d_.GetAllocator());
+        }
+    }
+
+    virtual void TearDown() {
+        d_.SetNull();
+        PerfTest::TearDown();
+    }
+
+protected:
+    template <typename WriterType>
+    void WriteParallel(unsigned threadCount) {
+        for (size_t i = 0; i < kParallelTrialCount; i++) {
+            StringBuffer sb;
+            WriterType writer(sb);
+            EXPECT_TRUE(AcceptParallel(d_, writer, threadCount));
+        }
+    }
+
+    static const size_t kParallelTrialCount = 10;
+    Document d_;
+};
+
+#define TEST_PARALLEL(Threads) \
+TEST_F(RapidJsonParallelWriter, AcceptParallel_Writer_Threads##Threads) { WriteParallel<Writer<StringBuffer> >(Threads); } \
+TEST_F(RapidJsonParallelWriter, AcceptParallel_PrettyWriter_Threads##Threads) { WriteParallel<PrettyWriter<StringBuffer> >(Threads); }
+TEST_PARALLEL(1)
+TEST_PARALLEL(2)
+TEST_PARALLEL(4)
+TEST_PARALLEL(8)
+#undef TEST_PARALLEL
+
+TEST_F(RapidJsonParallelWriter, AcceptParallel_Writer_AllThreads) {
+    WriteParallel<Writer<StringBuffer> >(0);
+}
+
+// The same array written by Accept(), as a baseline.
+TEST_F(RapidJsonParallelWriter, Accept_Writer) {
+    for (size_t i = 0; i < kParallelTrialCount; i++) {
+        StringBuffer sb;
+        Writer<StringBuffer> writer(sb);
+        EXPECT_TRUE(d_.Accept(writer));
+    }
+}
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // TEST_RAPIDJSON
@@ -22,10 +22,14 @@
 #define TEST_VERSION_CODE(x,y,z) \
   (((x)*100000) + ((y)*100) + (z))
 
-// __SSE2__ and __SSE4_2__ are recognized by gcc, clang, and the Intel compiler.
-// We use -march=native with gmake to enable -msse2 and -msse4.2, if supported.
+// __SSE2__, __SSE4_2__, __AVX2__ and __AVX512BW__ are recognized by gcc, clang, and the Intel compiler.
+// We use -march=native with gmake to enable -msse2, -msse4.2, -mavx2 and -mavx512bw, if supported.
 // Likewise, __ARM_NEON is used to detect Neon.
-#if defined(__SSE4_2__)
+#if defined(__AVX512BW__)
+#  define RAPIDJSON_AVX512
+#elif defined(__AVX2__)
+#  define RAPIDJSON_AVX2
+#elif defined(__SSE4_2__)
 #  define RAPIDJSON_SSE42
 #elif defined(__SSE2__)
 #  define RAPIDJSON_SSE2
@@ -53,6 +57,8 @@
 #endif
 
 #include "gtest/gtest.h"
+#include <cstdio>
+#include <vector>
 
 #if defined(__clang__) || defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))
 #pragma GCC diagnostic pop
@@ -67,7 +73,7 @@
 //! Base class for all performance tests
 class PerfTest : public ::testing::Test {
 public:
-    PerfTest() : filename_(), json_(), length_(), whitespace_(), whitespace_length_() {}
+    PerfTest() : filename_(), json_(), length_(), whitespace_(), whitespace_length_(), ids_(), ids_length_() {}
 
     virtual void SetUp() {
         {
@@ -113,6 +119,23 @@ public:
             *p++ = '\0';
         }
 
+        // 64-bit id test: an array of 19-digit integers, like database keys
+        {
+            const size_t kIdCount = 65536;
+            ids_length_ = kIdCount * 21 + 1;
+            ids_ = (char *)malloc(ids_length_ + 1);
+            char *p = ids_;
+            *p++ = '[';
+            uint64_t x = 88172645463325252ull;
+            for (size_t i = 0; i < kIdCount; i++) {
+                x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+                p += sprintf(p, "%019llu", (unsigned long long)(x % 9000000000000000000ull + 1000000000000000000ull));
+                *p++ = i + 1 < kIdCount ? ',' : ']';
+                *p++ = '\n';
+            }
+            *p = '\0';
+        }
+
         // types test
         {
             const char *typespaths[] = {
@@ -156,8 +179,10 @@ public:
     virtual void TearDown() {
         free(json_);
         free(whitespace_);
+        free(ids_);
         json_ = 0;
         whitespace_ = 0;
+        ids_ = 0;
         for (size_t i = 0; i < 7; i++) {
             free(types_[i]);
             types_[i] = 0;
@@ -174,12 +199,35 @@ protected:
     size_t length_;
     char *whitespace_;
     size_t whitespace_length_;
+    char *ids_;
+    size_t ids_length_;
     char *types_[7];
     size_t typesLength_[7];
 
     static const size_t kTrialCount = 1000;
 };
 
+//! Looks up every member of an object with \c memberCount members, \c lookupCount lookups in total.
+/*! Shared by the linear and the hash indexed member lookup, which live in different namespaces. */
+template <typename DocumentType>
+void FindMemberBenchmark(unsigned memberCount, unsigned lookupCount) {
+    typedef typename DocumentType::ValueType ValueType;
+    DocumentType d;
+    d.SetObject();
+    std::vector<ValueType> names(memberCount);
+    char name[32];
+    for (unsigned i = 0; i < memberCount; i++) {
+        sprintf(name, "member_name_%u", i * 2654435761u);
+        names[i].SetString(name, d.GetAllocator());
+        d.AddMember(ValueType(names[i], d.GetAllocator()), ValueType(i), d.GetAllocator());
+    }
+
+    unsigned sum = 0;
+    for (unsigned i = 0; i < lookupCount; i++)
+        sum += d.FindMember(names[i % memberCount])->value.GetUint();
+    EXPECT_EQ(lookupCount / memberCount * (memberCount * (memberCount - 1) / 2), sum);
+}
+
 #endif // __cplusplus
 
 #endif // PERFTEST_H_
@@ -18,13 +18,25 @@
 
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/document.h"
+#include "rapidjson/lazydocument.h"
+#include "rapidjson/pointer.h"
 #include "rapidjson/prettywriter.h"
+#include "rapidjson/pushparser.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/filereadstream.h"
+#include "rapidjson/istreamwrapper.h"
+#include "rapidjson/mmapreadstream.h"
 #include "rapidjson/encodedstream.h"
 #include "rapidjson/memorystream.h"
-
-#ifdef RAPIDJSON_SSE2
+#include "rapidjson/memorybuffer.h"
+#include "rapidjson/cursorstreamwrapper.h"
+#include <fstream>
+
+#ifdef RAPIDJSON_AVX512
+#define SIMD_SUFFIX(name) name##_AVX512
+#elif defined(RAPIDJSON_AVX2)
+#define SIMD_SUFFIX(name) name##_AVX2
+#elif defined(RAPIDJSON_SSE2)
 #define SIMD_SUFFIX(name) name##_SSE2
 #elif defined(RAPIDJSON_SSE42)
 #define SIMD_SUFFIX(name) name##_SSE42
@@ -97,6 +109,33 @@ TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler)) {
     }
 }
 
+// Skips the values of the top-level members, through the reader or by ignoring their events.
+struct SkipMembersHandler : BaseReaderHandler<UTF8<>, SkipMembersHandler> {
+    SkipMembersHandler() : depth() {}
+    bool StartObject() { depth++; return true; }
+    HandlerResult Key(const char*, SizeType, bool) { return depth == 1 ? kHandlerSkipValue : kHandlerContinue; }
+    bool EndObject(SizeType) { depth--; return true; }
+    unsigned depth;
+};
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_HandlerSkip)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringStream s(json_);
+        SkipMembersHandler h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse(s, h));
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_HandlerSkip_Iterative)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringStream s(json_);
+        SkipMembersHandler h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse<kParseIterativeFlag>(s, h));
+    }
+}
+
 #define TEST_TYPED(index, Name)\
 TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_##Name)) {\
     for (size_t i = 0; i < kTrialCount * 10; i++) {\
@@ -135,6 +174,75 @@ TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_FullPrecision)) {
     }
 }
 
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_Floats_FullPrecision)) {
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        StringStream s(types_[1]);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse<kParseFullPrecisionFlag>(s, h));
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParseInsitu_DummyHandler_Floats_FullPrecision)) {
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        memcpy(temp_, types_[1], typesLength_[1] + 1);
+        InsituStringStream s(temp_);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse<kParseInsituFlag | kParseFullPrecisionFlag>(s, h));
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_Ids)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringStream s(ids_);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse(s, h));
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParseInsitu_DummyHandler_Ids)) {
+    char* temp = (char*)malloc(ids_length_ + 1);
+    for (size_t i = 0; i < kTrialCount; i++) {
+        memcpy(temp, ids_, ids_length_ + 1);
+        InsituStringStream s(temp);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse<kParseInsituFlag>(s, h));
+    }
+    free(temp);
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_Ids_MemoryStream)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        MemoryStream ms(ids_, ids_length_);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse(ms, h));
+    }
+}
+
+// Same input through a stream the reader cannot see through, i.e. one digit at a time.
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_Ids_EncodedInputStream)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        MemoryStream ms(ids_, ids_length_);
+        EncodedInputStream<UTF8<>, MemoryStream> is(ms);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse(is, h));
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_Integers_MemoryStream)) {
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        MemoryStream ms(types_[3], typesLength_[3]);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse(ms, h));
+    }
+}
+
 TEST_F(RapidJson, SIMD_SUFFIX(ReaderParseIterative_DummyHandler)) {
     for (size_t i = 0; i < kTrialCount; i++) {
         StringStream s(json_);
@@ -183,6 +291,23 @@ TEST_F(RapidJson, SIMD_SUFFIX(ReaderParseIterativePullInsitu_DummyHandler)) {
     }
 }
 
+#define TEST_PUSHPARSER(ChunkSize) \
+TEST_F(RapidJson, SIMD_SUFFIX(PushParser_DummyHandler_Chunk##ChunkSize)) {\
+    for (size_t i = 0; i < kTrialCount; i++) {\
+        BaseReaderHandler<> h;\
+        PushParser parser;\
+        for (size_t j = 0; j < length_; j += ChunkSize)\
+            parser.Feed(json_ + j, std::min<size_t>(ChunkSize, length_ - j), h);\
+        EXPECT_TRUE(parser.Finish(h));\
+    }\
+}
+TEST_PUSHPARSER(1)
+TEST_PUSHPARSER(16)
+TEST_PUSHPARSER(256)
+TEST_PUSHPARSER(4096)
+TEST_PUSHPARSER(65536)
+#undef TEST_PUSHPARSER
+
 TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_ValidateEncoding)) {
     for (size_t i = 0; i < kTrialCount; i++) {
         StringStream s(json_);
@@ -218,6 +343,73 @@ TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_MemoryPoolAllocator)) {
     }
 }
 
+// The same small document parsed 100k times, as for requests, without and with recycling.
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_Requests)) {
+    for (size_t i = 0; i < 100000; i++) {
+        Document doc;
+        doc.Parse(types_[4]);
+        ASSERT_TRUE(doc.IsArray());
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_Requests_Recycle)) {
+    Document doc;
+    for (size_t i = 0; i < 100000; i++) {
+        doc.Recycle().Parse(types_[4]);
+        ASSERT_TRUE(doc.IsArray());
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(LazyDocumentParse)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        LazyDocument doc;
+        doc.Parse(json_);
+        ASSERT_TRUE(doc.Root().IsObject());
+    }
+}
+
+// Sparse access: one member of the root and the names of its members
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_SparseAccess)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        Document doc;
+        doc.Parse(json_);
+        const Value& a = doc["a"];
+        SizeType length = 0;
+        for (Value::ConstMemberIterator m = a.MemberBegin(); m != a.MemberEnd(); ++m)
+            length += m->name.GetStringLength();
+        EXPECT_NE(0u, length);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(LazyDocumentParse_SparseAccess)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        LazyDocument doc;
+        doc.Parse(json_);
+        const LazyValue a = doc.Root()["a"];
+        SizeType length = 0;
+        for (LazyValue::MemberIterator m = a.MemberBegin(); m != a.MemberEnd(); ++m)
+            length += m->name.GetStringLength();
+        EXPECT_NE(0u, length);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParseByPointers)) {
+    const Pointer pointers[] = { Pointer("/key"), Pointer("/a/obj/key") };
+    for (size_t i = 0; i < kTrialCount; i++) {
+        Document doc;
+        ASSERT_FALSE(ParseByPointers(doc, json_, pointers, 2).IsError());
+        EXPECT_TRUE(doc["a"]["obj"]["key"].IsString());
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderSkipValue)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringStream s(json_);
+        Reader reader;
+        EXPECT_FALSE(reader.SkipValue(s).IsError());
+    }
+}
+
 TEST_F(RapidJson, SIMD_SUFFIX(DocumentParseLength_MemoryPoolAllocator)) {
     for (size_t i = 0; i < kTrialCount; i++) {
         Document doc;
@@ -274,6 +466,28 @@ TEST_F(RapidJson, SIMD_SUFFIX(DocumentParseAutoUTFInputStream_MemoryStream)) {
     }
 }
 
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_CursorStreamWrapper)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringStream s(json_);
+        CursorStreamWrapper<StringStream> csw(s);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse(csw, h));
+        EXPECT_GT(csw.GetLine(), 1u);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_LazyCursorStreamWrapper)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringStream s(json_);
+        LazyCursorStreamWrapper<StringStream> csw(s);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_TRUE(reader.Parse(csw, h));
+        EXPECT_GT(csw.GetLine(), 1u);
+    }
+}
+
 template<typename T>
 size_t Traverse(const T& value) {
     size_t count = 1;
@@ -332,6 +546,18 @@ TEST_F(RapidJson, DocumentAccept) {
     }
 }
 
+// Linear member lookup, see memberindextest.cpp for the hash indexed one
+#define TEST_FINDMEMBER(Count) \
+TEST_F(RapidJson, DocumentFindMember_##Count) { \
+    FindMemberBenchmark<Document>(Count, 1u << 17); \
+}
+TEST_FINDMEMBER(8)
+TEST_FINDMEMBER(32)
+TEST_FINDMEMBER(128)
+TEST_FINDMEMBER(1024)
+TEST_FINDMEMBER(4096)
+#undef TEST_FINDMEMBER
+
 struct NullStream {
     typedef char Ch;
 
@@ -384,6 +610,86 @@ TEST_TYPED(6, Paragraphs)
 
 #undef TEST_TYPED
 
+TEST_F(RapidJson, SIMD_SUFFIX(Writer_StringBuffer_Paragraphs_ValidateEncoding)) {
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        StringBuffer s(0, 1024 * 1024);
+        Writer<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteValidateEncodingFlag> writer(s);
+        typesDoc_[6].Accept(writer);
+        const char* str = s.GetString();
+        (void)str;
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(Writer_MemoryBuffer_Paragraphs)) {
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        MemoryBuffer s(0, 1024 * 1024);
+        Writer<MemoryBuffer> writer(s);
+        typesDoc_[6].Accept(writer);
+        const char* str = s.GetBuffer();
+        (void)str;
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(Writer_UTF16_Paragraphs)) {
+    typedef UTF16<uint16_t> UTF16Type;
+    GenericDocument<UTF16Type> d;
+    d.Parse<0, UTF8<> >(types_[6]);
+    ASSERT_FALSE(d.HasParseError());
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        GenericStringBuffer<UTF16Type> s(0, 2 * 1024 * 1024);
+        Writer<GenericStringBuffer<UTF16Type>, UTF16Type, UTF16Type> writer(s);
+        d.Accept(writer);
+        const UTF16Type::Ch* str = s.GetString();
+        (void)str;
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(Writer_StringBuffer_Floats_Shortest)) {
+    for (size_t i = 0; i < kTrialCount * 10; i++) {
+        StringBuffer s(0, 1024 * 1024);
+        Writer<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteShortestDoubleFlag> writer(s);
+        typesDoc_[1].Accept(writer);
+        const char* str = s.GetString();
+        (void)str;
+    }
+}
+
+// Doubles from random bit patterns, which mostly need 16 or 17 digits
+static void RandomDoubles(Document& d) {
+    d.SetArray();
+    uint64_t x = RAPIDJSON_UINT64_C2(0x01393F0F, 0x2C48D734);
+    for (int i = 0; i < 100000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        d.PushBack(internal::Double(x & RAPIDJSON_UINT64_C2(0x7FEFFFFF, 0xFFFFFFFF)).Value(), d.GetAllocator());
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(Writer_StringBuffer_RandomDoubles)) {
+    Document d;
+    RandomDoubles(d);
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringBuffer s(0, 4 * 1024 * 1024);
+        Writer<StringBuffer> writer(s);
+        d.Accept(writer);
+        const char* str = s.GetString();
+        (void)str;
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(Writer_StringBuffer_RandomDoubles_Shortest)) {
+    Document d;
+    RandomDoubles(d);
+    for (size_t i = 0; i < kTrialCount; i++) {
+        StringBuffer s(0, 4 * 1024 * 1024);
+        Writer<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteShortestDoubleFlag> writer(s);
+        d.Accept(writer);
+        const char* str = s.GetString();
+        (void)str;
+    }
+}
+
 TEST_F(RapidJson, SIMD_SUFFIX(PrettyWriter_StringBuffer)) {
     for (size_t i = 0; i < kTrialCount; i++) {
         StringBuffer s(0, 2048 * 1024);
@@ -463,6 +769,78 @@ TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_FileReadStream)) {
     }
 }
 
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_IStreamWrapper)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        std::ifstream is(filename_, std::ios::in | std::ios::binary);
+        IStreamWrapper s(is);
+        BaseReaderHandler<> h;
+        Reader reader;
+        reader.Parse(s, h);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_BufferedIStreamWrapper)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        std::ifstream is(filename_, std::ios::in | std::ios::binary);
+        BufferedIStreamWrapper s(is);
+        BaseReaderHandler<> h;
+        Reader reader;
+        reader.Parse(s, h);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_MemoryPoolAllocator_IStreamWrapper)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        std::ifstream is(filename_, std::ios::in | std::ios::binary);
+        IStreamWrapper s(is);
+        Document doc;
+        doc.ParseStream(s);
+        ASSERT_TRUE(doc.IsObject());
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_MemoryPoolAllocator_BufferedIStreamWrapper)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        std::ifstream is(filename_, std::ios::in | std::ios::binary);
+        BufferedIStreamWrapper s(is);
+        Document doc;
+        doc.ParseStream(s);
+        ASSERT_TRUE(doc.IsObject());
+    }
+}
+
+TEST_F(RapidJson, MmapReadStream) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        FILE *fp = fopen(filename_, "rb");
+        MmapReadStream s(fp);
+        while (s.Take() != '\0')
+            ;
+        fclose(fp);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(ReaderParse_DummyHandler_MmapReadStream)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        FILE *fp = fopen(filename_, "rb");
+        MmapReadStream s(fp);
+        BaseReaderHandler<> h;
+        Reader reader;
+        reader.Parse(s, h);
+        fclose(fp);
+    }
+}
+
+TEST_F(RapidJson, SIMD_SUFFIX(DocumentParse_MemoryPoolAllocator_MmapReadStream)) {
+    for (size_t i = 0; i < kTrialCount; i++) {
+        FILE *fp = fopen(filename_, "rb");
+        MmapReadStream s(fp);
+        Document doc;
+        doc.ParseStream(s);
+        ASSERT_TRUE(doc.IsObject());
+        fclose(fp);
+    }
+}
+
 TEST_F(RapidJson, StringBuffer) {
     StringBuffer sb;
     for (int i = 0; i < 32 * 1024 * 1024; i++)
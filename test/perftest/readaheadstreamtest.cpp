@@ -0,0 +1,93 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Parsing a large file with read-ahead on a background thread, compared to FileReadStream.
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/readaheadstream.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/reader.h"
+
+using namespace rapidjson;
+
+class RapidJsonReadAhead : public PerfTest {
+public:
+    // An array of copies of sample.json, of 256 MB, written once.
+    static void SetUpTestCase() {
+        struct Sample : public PerfTest {
+            virtual void TestBody() {}
+            void Write(FILE* fp) {
+                fputc('[', fp);
+                for (size_t size = 0; size < (256u << 20); size += length_ + 1) {
+                    if (size)
+                        fputc(',', fp);
+                    fwrite(json_, 1, length_, fp);
+                }
+                fputc(']', fp);
+            }
+        } sample;
+        sample.SetUp();
+        fp_ = tmpfile();
+        if (fp_)
+            sample.Write(fp_);
+        sample.TearDown();
+    }
+
+    virtual void SetUp() {
+        PerfTest::SetUp();
+        ASSERT_TRUE(fp_ != 0);
+        rewind(fp_);
+    }
+
+    static void TearDownTestCase() {
+        if (fp_)
+            fclose(fp_);
+        fp_ = 0;
+    }
+
+protected:
+    void ParseReadAhead(size_t bufferSize, size_t bufferCount) {
+        FileReadAheadStream s(fp_, bufferSize, bufferCount);
+        BaseReaderHandler<> h;
+        Reader reader;
+        EXPECT_FALSE(reader.Parse(s, h).IsError());
+    }
+
+    static FILE* fp_;
+};
+
+FILE* RapidJsonReadAhead::fp_;
+
+TEST_F(RapidJsonReadAhead, ReaderParse_DummyHandler_FileReadStream_Large) {
+    char buffer[65536];
+    FileReadStream s(fp_, buffer, sizeof(buffer));
+    BaseReaderHandler<> h;
+    Reader reader;
+    EXPECT_FALSE(reader.Parse(s, h).IsError());
+}
+
+TEST_F(RapidJsonReadAhead, ReaderParse_DummyHandler_FileReadAheadStream_2x64K) { ParseReadAhead(65536, 2); }
+TEST_F(RapidJsonReadAhead, ReaderParse_DummyHandler_FileReadAheadStream_4x64K) { ParseReadAhead(65536, 4); }
+TEST_F(RapidJsonReadAhead, ReaderParse_DummyHandler_FileReadAheadStream_8x64K) { ParseReadAhead(65536, 8); }
+TEST_F(RapidJsonReadAhead, ReaderParse_DummyHandler_FileReadAheadStream_4x1M) { ParseReadAhead(1 << 20, 4); }
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
+#endif // TEST_RAPIDJSON
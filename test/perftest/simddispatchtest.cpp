@@ -0,0 +1,133 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Runs every kernel family selectable at run time on the same data.
+
+#define RAPIDJSON_SIMD_DISPATCH
+#define RAPIDJSON_NAMESPACE rapidjson_dispatch
+
+#include "perftest.h"
+
+#if TEST_RAPIDJSON
+
+#include "rapidjson/document.h"
+#include "rapidjson/writer.h"
+#include "rapidjson/stringbuffer.h"
+
+#ifdef RAPIDJSON_SIMD_DISPATCH
+
+using namespace rapidjson_dispatch;
+using namespace rapidjson_dispatch::internal;
+
+class RapidJsonDispatch : public PerfTest {
+public:
+    RapidJsonDispatch() : temp_(), strings_(), stringsLength_() {}
+
+    virtual void SetUp() {
+        PerfTest::SetUp();
+
+        // Array of long strings, like the message fields of a log.
+        std::string s = "[";
+        for (size_t i = 0; i < 1024; i++) {
+            if (i != 0)
+                s += ',';
+            s += '\"';
+            for (size_t j = 0; j < 1000 + i % 64; j++)
+                s += "Lorem ipsum dolor sit amet "[j % 27];
+            s += (i % 8 == 0) ? "\\n\"" : "\"";
+        }
+        s += ']';
+        stringsLength_ = s.size();
+        strings_ = (char *)malloc(stringsLength_ + 1);
+        memcpy(strings_, s.c_str(), stringsLength_ + 1);
+
+        // temp buffer for insitu parsing.
+        temp_ = (char *)malloc((length_ > stringsLength_ ? length_ : stringsLength_) + 1);
+    }
+
+    virtual void TearDown() {
+        SetSimdLevel(DetectSimdLevel());
+        PerfTest::TearDown();
+        free(temp_);
+        free(strings_);
+    }
+
+protected:
+    bool Bind(SimdLevel level) {
+        if (!SetSimdLevel(level)) {
+            printf("[  SKIPPED ] %s kernels are not supported by this CPU\n", GetSimdLevelName(level));
+            return false;
+        }
+        return true;
+    }
+
+    void SkipWhitespace() {
+        for (size_t i = 0; i < kTrialCount; i++) {
+            StringStream s(whitespace_);
+            rapidjson_dispatch::SkipWhitespace(s);
+            ASSERT_EQ('[', s.Peek());
+        }
+    }
+
+    void ScanUnescaped() {
+        for (size_t i = 0; i < kTrialCount; i++) {
+            size_t count = 0;
+            for (const char* p = strings_; *(p = SimdDispatch<>::Kernels().scanUnescaped(p)) != '\0'; ++p)
+                count++;
+            ASSERT_EQ(1024u * 2 + 128, count);
+        }
+    }
+
+    void ReaderParse(const char* json, size_t length) {
+        for (size_t i = 0; i < kTrialCount; i++) {
+            memcpy(temp_, json, length + 1);
+            InsituStringStream s(temp_);
+            BaseReaderHandler<> h;
+            Reader reader;
+            EXPECT_TRUE(reader.Parse<kParseInsituFlag>(s, h));
+        }
+    }
+
+    void Writer_StringBuffer() {
+        Document doc;
+        doc.Parse(strings_);
+        for (size_t i = 0; i < kTrialCount; i++) {
+            StringBuffer sb(0, 1024 * 1024);
+            Writer<StringBuffer> writer(sb);
+            doc.Accept(writer);
+            ASSERT_EQ(stringsLength_, sb.GetSize());
+        }
+    }
+
+    char* temp_;
+    char* strings_;
+    size_t stringsLength_;
+};
+
+#define TEST_SIMD_DISPATCH(suffix, level) \
+TEST_F(RapidJsonDispatch, SkipWhitespace_##suffix) { if (Bind(level)) SkipWhitespace(); } \
+TEST_F(RapidJsonDispatch, ScanUnescaped_##suffix) { if (Bind(level)) ScanUnescaped(); } \
+TEST_F(RapidJsonDispatch, ReaderParseInsitu_DummyHandler_##suffix) { if (Bind(level)) ReaderParse(json_, length_); } \
+TEST_F(RapidJsonDispatch, ReaderParseInsitu_Strings_##suffix) { if (Bind(level)) ReaderParse(strings_, stringsLength_); } \
+TEST_F(RapidJsonDispatch, Writer_StringBuffer_Strings_##suffix) { if (Bind(level)) Writer_StringBuffer(); }
+
+TEST_SIMD_DISPATCH(Scalar, kSimdScalar)
+TEST_SIMD_DISPATCH(SSE2, kSimdSSE2)
+TEST_SIMD_DISPATCH(SSE42, kSimdSSE42)
+TEST_SIMD_DISPATCH(AVX2, kSimdAVX2)
+TEST_SIMD_DISPATCH(AVX512BW, kSimdAVX512BW)
+
+#endif // RAPIDJSON_SIMD_DISPATCH
+
+#endif // TEST_RAPIDJSON
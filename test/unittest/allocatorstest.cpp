@@ -62,6 +62,232 @@ TEST(Allocator, MemoryPoolAllocator) {
     }
 }
 
+TEST(Allocator, MemoryPoolAllocator_AdoptChunks) {
+    MemoryPoolAllocator<> a(64);
+    MemoryPoolAllocator<> b(64);
+    char* p = static_cast<char*>(b.Malloc(100));
+    std::memset(p, 'x', 100);
+    b.Malloc(10);
+    const size_t size = b.Size();
+    const size_t capacity = b.Capacity();
+
+    a.AdoptChunks(b);
+    EXPECT_EQ(size, a.Size());
+    EXPECT_EQ(capacity, a.Capacity());
+    EXPECT_EQ(0u, b.Size());
+    EXPECT_EQ(0u, b.Capacity());
+    EXPECT_EQ('x', p[99]);
+    EXPECT_TRUE(b.Malloc(10) != 0);
+
+    // Allocation continues in the current chunk, and the user buffer stays last.
+    char buffer[256];
+    MemoryPoolAllocator<> c(buffer, sizeof(buffer));
+    void* q = c.Malloc(8);
+    c.AdoptChunks(a);
+    EXPECT_EQ(size + 8, c.Size());
+    c.Clear();
+    EXPECT_EQ(q, c.Malloc(8));
+}
+
+TEST(Allocator, MemoryPoolAllocator_Reset) {
+    MemoryPoolAllocator<> a(64);
+    void* p = a.Malloc(32);
+    void* q = a.Malloc(48);
+    a.Malloc(200);
+    const size_t capacity = a.Capacity();
+    EXPECT_EQ(280u, a.Size());
+
+    // The chunks are kept, and reused for the same allocations.
+    a.Reset();
+    EXPECT_EQ(0u, a.Size());
+    EXPECT_EQ(capacity, a.Capacity());
+    EXPECT_EQ(p, a.Malloc(32));
+    EXPECT_EQ(q, a.Malloc(48));
+    a.Reset();
+    for (int i = 0; i < 3; i++) {
+        a.Malloc(32);
+        a.Malloc(48);
+        a.Malloc(200);
+        EXPECT_EQ(capacity, a.Capacity());
+        a.Reset();
+    }
+    // Chunks beyond the capacity limit are freed.
+    a.Reset(150);
+    EXPECT_LE(a.Capacity(), 150u);
+    a.Reset(0);
+    EXPECT_EQ(0u, a.Capacity());
+    a.Malloc(8);
+    a.Clear();
+    EXPECT_EQ(0u, a.Capacity());
+
+    // The user buffer is rewound too.
+    char buffer[256];
+    MemoryPoolAllocator<> b(buffer, sizeof(buffer), 64);
+    void* r = b.Malloc(8);
+    b.Malloc(1000);
+    b.Reset();
+    EXPECT_EQ(r, b.Malloc(8));
+    EXPECT_EQ(sizeof(buffer) - sizeof(size_t) * 3 + 1000, b.Capacity());
+}
+
+TEST(Allocator, MemoryPoolAllocator_Stats) {
+    MemoryPoolAllocator<> a(64);
+    AllocatorStats stats = a.GetStats();
+    EXPECT_EQ(0u, stats.usedBytes);
+    EXPECT_EQ(0u, stats.chunkCount);
+    EXPECT_EQ(0u, stats.reservedBytes);
+
+    void* p = a.Malloc(40);
+    a.Malloc(100);
+    p = a.Realloc(p, 40, 60);
+    stats = a.GetStats();
+    EXPECT_EQ(a.Size(), stats.usedBytes);
+    EXPECT_EQ(208u, stats.usedBytes);
+    EXPECT_EQ(208u, stats.peakUsedBytes);
+    EXPECT_EQ(40u, stats.reallocWasteBytes);
+    EXPECT_EQ(3u, stats.chunkCount);
+    EXPECT_EQ(3u, stats.chunkAllocations);
+    EXPECT_EQ(64u + 104 + 64, stats.reservedBytes);
+    EXPECT_EQ(stats.reservedBytes, a.Capacity());
+    EXPECT_EQ(0u, stats.mallocCount);
+
+    // The peak is kept by Reset(), and spare chunks are still reserved.
+    a.Reset(128);
+    a.Malloc(8);
+    stats = a.GetStats();
+    EXPECT_EQ(8u, stats.usedBytes);
+    EXPECT_EQ(208u, stats.peakUsedBytes);
+    EXPECT_EQ(2u, stats.chunkCount);
+    EXPECT_EQ(3u, stats.chunkAllocations);
+    EXPECT_EQ(128u, stats.reservedBytes);
+
+    MemoryPoolAllocator<> b(64);
+    b.Malloc(50);
+    b.Malloc(30);
+    a.AdoptChunks(b);
+    EXPECT_EQ(88u + 8, a.Size());
+    EXPECT_EQ(4u, a.GetStats().chunkCount);
+    EXPECT_EQ(0u, b.Size());
+    EXPECT_EQ(0u, b.Capacity());
+    EXPECT_EQ(88u, b.GetStats().peakUsedBytes);
+
+    a.Clear();
+    stats = a.GetStats();
+    EXPECT_EQ(0u, stats.usedBytes);
+    EXPECT_EQ(0u, stats.chunkCount);
+    EXPECT_EQ(0u, stats.reservedBytes);
+    EXPECT_EQ(3u, stats.chunkAllocations);
+}
+
+TEST(Allocator, InstrumentedAllocator) {
+    {
+        InstrumentedAllocator<> a;
+        TestAllocator(a);
+        AllocatorStats stats = a.GetStats();
+        EXPECT_EQ(2u, stats.mallocCount);
+        EXPECT_EQ(2u, stats.reallocCount);
+        EXPECT_EQ(0u, stats.freeCount);
+        EXPECT_EQ(201u, stats.requestedBytes);
+        EXPECT_EQ(151u, stats.usedBytes);
+        EXPECT_EQ(200u, stats.peakUsedBytes);
+        EXPECT_EQ(0u, stats.reallocWasteBytes);
+        EXPECT_EQ(1u, stats.chunkCount);
+        EXPECT_EQ(a.GetBaseAllocator().Capacity(), stats.reservedBytes);
+        EXPECT_EQ(1u, stats.sizeHistogram[0]);
+        EXPECT_EQ(2u, stats.sizeHistogram[AllocatorStats::Bucket(200)]);
+        EXPECT_EQ(1u, stats.sizeHistogram[AllocatorStats::Bucket(100)]);
+
+        // The block is moved, as it is not the last one.
+        void* p = a.Malloc(10);
+        a.Malloc(10);
+        a.Realloc(p, 10, 100);
+        EXPECT_EQ(10u, a.GetStats().reallocWasteBytes);
+
+        a.ResetStats();
+        stats = a.GetStats();
+        EXPECT_EQ(0u, stats.mallocCount);
+        EXPECT_EQ(stats.usedBytes, stats.peakUsedBytes);
+    }
+    {
+        InstrumentedAllocator<CrtAllocator> a;
+        TestAllocator(a);
+        AllocatorStats stats = a.GetStats();
+        EXPECT_EQ(2u, stats.freeCount);
+        EXPECT_EQ(0u, stats.usedBytes);
+        EXPECT_EQ(200u, stats.peakUsedBytes);
+        EXPECT_EQ(0u, stats.reallocWasteBytes);
+        EXPECT_EQ(0u, stats.chunkCount);
+    }
+    EXPECT_EQ(0u, AllocatorStats::Bucket(1));
+    EXPECT_EQ(0u, AllocatorStats::Bucket(8));
+    EXPECT_EQ(1u, AllocatorStats::Bucket(9));
+    EXPECT_EQ(AllocatorStats::kBucketCount - 1, AllocatorStats::Bucket(~static_cast<size_t>(0)));
+}
+
+TEST(Allocator, FreeListAllocator) {
+    FreeListAllocator<> a;
+    TestAllocator(a);
+    EXPECT_EQ(0u, a.Size());
+
+    for (size_t i = 1; i < 1000; i++) {
+        void* p = a.Malloc(i);
+        EXPECT_TRUE(p != 0);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(p) % RAPIDJSON_ALIGN(1));
+        EXPECT_LE(i, a.Size());
+        EXPECT_LE(a.Size(), a.Capacity());
+        FreeListAllocator<>::Free(p);
+    }
+    EXPECT_EQ(0u, a.Size());
+
+    // Freed blocks are reused by the same size class.
+    void* p = a.Malloc(100);
+    void* q = a.Malloc(100);
+    EXPECT_EQ(256u, a.Size());
+    FreeListAllocator<>::Free(p);
+    EXPECT_EQ(p, a.Malloc(120));
+    FreeListAllocator<>::Free(q);
+    EXPECT_EQ(q, a.Malloc(97));
+    EXPECT_EQ(q, a.Realloc(q, 97, 128));
+    EXPECT_NE(q, a.Realloc(q, 128, 129));
+
+    // Allocating and freeing again does not grow the capacity.
+    size_t capacity = 0;
+    for (int n = 0; n < 100; n++) {
+        void* blocks[64];
+        for (size_t i = 0; i < 64; i++)
+            blocks[i] = a.Malloc(i * 37 + 1);
+        for (size_t i = 0; i < 64; i++)
+            FreeListAllocator<>::Free(blocks[i]);
+        if (n == 0)
+            capacity = a.Capacity();
+    }
+    EXPECT_EQ(capacity, a.Capacity());
+
+    // Large blocks are allocated and freed by the base allocator.
+    char* large = static_cast<char*>(a.Malloc(100000));
+    std::memset(large, 'x', 100000);
+    EXPECT_EQ(capacity + 100000, a.Capacity());
+    large = static_cast<char*>(a.Realloc(large, 100000, 200000));
+    EXPECT_EQ('x', large[99999]);
+    EXPECT_EQ(capacity + 200000, a.Capacity());
+    char* small = static_cast<char*>(a.Realloc(large, 200000, 10));
+    EXPECT_EQ('x', small[9]);
+    EXPECT_EQ(capacity, a.Capacity());
+    a.Malloc(50000);
+    a.Clear();
+    EXPECT_EQ(0u, a.Size());
+    EXPECT_EQ(0u, a.Capacity());
+
+    // The rest of a chunk is not lost.
+    FreeListAllocator<> b(1000);
+    b.Malloc(600);
+    const size_t chunk = b.Capacity();
+    b.Malloc(600);
+    b.Malloc(150);
+    b.Malloc(10);
+    EXPECT_EQ(2 * chunk, b.Capacity());
+}
+
 TEST(Allocator, Alignment) {
     if (sizeof(size_t) >= 8) {
         EXPECT_EQ(RAPIDJSON_UINT64_C2(0x00000000, 0x00000000), RAPIDJSON_ALIGN(0));
@@ -0,0 +1,122 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+
+#include "rapidjson/chunkpool.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/document.h"
+#include <limits>
+#include <thread>
+#include <vector>
+
+using namespace rapidjson;
+
+TEST(ChunkPool, Allocator) {
+    ChunkPool pool(1024, 4, 1);
+    ChunkPoolAllocator a(&pool);
+    EXPECT_EQ(&pool, &a.GetPool());
+    EXPECT_TRUE(a.Malloc(0) == 0);
+
+    // Blocks about the block size are pooled, others are not.
+    void* p = a.Malloc(1000);
+    void* small = a.Malloc(100);
+    void* large = a.Malloc(2000);
+    std::memset(p, 1, 1000);
+    std::memset(small, 2, 100);
+    std::memset(large, 3, 2000);
+    ChunkPoolAllocator::Free(small);
+    ChunkPoolAllocator::Free(large);
+    ChunkPoolAllocator::Free(p);
+    ChunkPoolAllocator::Free(0);
+
+    ChunkPoolStats stats = pool.GetStats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.returns);
+    EXPECT_EQ(1u, stats.cached);
+
+    EXPECT_EQ(p, a.Malloc(600));
+    EXPECT_EQ(1u, pool.GetStats().hits);
+    EXPECT_EQ(0u, pool.GetStats().cached);
+
+    // Realloc keeps the content, across pooled and non-pooled sizes
+    char* q = static_cast<char*>(a.Realloc(p, 600, 2000));
+    for (size_t i = 0; i < 600; i++)
+        ASSERT_EQ(1, q[i]);
+    q = static_cast<char*>(a.Realloc(q, 2000, 800));
+    EXPECT_EQ(1, q[599]);
+
+    // A pooled block is kept while it has room, and on failure
+    EXPECT_EQ(q, a.Realloc(q, 800, 1024));
+    if (sizeof(size_t) == 8) {
+        EXPECT_TRUE(a.Realloc(q, 1024, (std::numeric_limits<size_t>::max)() / 4) == 0);
+        EXPECT_EQ(1, q[599]);
+    }
+    EXPECT_TRUE(a.Realloc(q, 1024, 0) == 0);
+}
+
+TEST(ChunkPool, MaxBlocks) {
+    ChunkPool pool(1024, 2, 1);
+    ChunkPoolAllocator a(&pool);
+    void* blocks[3] = { a.Malloc(1024), a.Malloc(1024), a.Malloc(1024) };
+    for (int i = 0; i < 3; i++)
+        ChunkPoolAllocator::Free(blocks[i]);
+
+    ChunkPoolStats stats = pool.GetStats();
+    EXPECT_EQ(3u, stats.misses);
+    EXPECT_EQ(2u, stats.returns);
+    EXPECT_EQ(1u, stats.releases);
+    EXPECT_EQ(2u, stats.cached);
+
+    pool.Trim();
+    EXPECT_EQ(0u, pool.GetStats().cached);
+}
+
+TEST(ChunkPool, Document) {
+    typedef GenericDocument<UTF8<>, MemoryPoolAllocator<ChunkPoolAllocator> > PooledDocument;
+    std::string json = "[";
+    for (int i = 0; i < 10000; i++)
+        json += "\"a string which does not fit in a value\",";
+    json += "0]";
+
+    ChunkPool pool;
+    ChunkPoolAllocator base(&pool);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.push_back(std::thread([&]() {
+            for (int i = 0; i < 20; i++) {
+                MemoryPoolAllocator<ChunkPoolAllocator> allocator(RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY, &base);
+                PooledDocument d(&allocator);
+                d.Parse(json.c_str());
+                EXPECT_EQ(10001u, d.Size());
+            }
+        }));
+    for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    ChunkPoolStats stats = pool.GetStats();
+    EXPECT_GT(stats.hits, 0u);
+    EXPECT_EQ(stats.hits + stats.misses, stats.returns + stats.releases);
+    EXPECT_EQ(stats.returns - stats.hits, stats.cached);
+
+    // The global pool by default
+    PooledDocument d;
+    d.Parse(json.c_str());
+    EXPECT_EQ(10001u, d.Size());
+}
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
@@ -113,3 +113,73 @@ TEST(CursorStreamWrapper, MissingLastBracket) {
     EXPECT_EQ(line, 4u);
     EXPECT_EQ(col, 16u);
 }
+
+TEST(LazyCursorStreamWrapper, SameAsCursorStreamWrapper) {
+    const char* jsons[] = {
+        "\"string\"\n\n:\"my string\",\"array\"\n:[\"1\", \"2\", \"3\"]}",
+        "{\"string\n\n:\"my string\",\"array\"\n:[\"1\", \"2\", \"3\"]}",
+        "{\"string\"\n\n\"my string\",\"array\"\n:[\"1\", \"2\", \"3\"]}",
+        "{\"string\"\n\n:my string\",\"array\"\n:[\"1\", \"2\", \"3\"]}",
+        "{\"string\"\n\n:\"my string\"\"array\"\n:[\"1\", \"2\", \"3\"]}",
+        "{\"string\"\n\n:\"my string\",\"array\"\n:\"1\", \"2\", \"3\"]}",
+        "{\"string\"\n\n:\"my string\",\"array\"\n:[\"1\" \"2\", \"3\"]}",
+        "{\"string\"\n\n:\"my string\",\"array\"\n:[\"1\", \"2\", \"3\"}",
+        "{\"string\"\n\n:\"my string\",\"array\"\n:[\"1\", \"2\", \"3\"]",
+        "[\n  1,\n  2,\n  \"a\\nb\"\n  x]",
+        "\n\n\n\n   \n\n\n {\"a\":\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n ]"
+    };
+    for (size_t i = 0; i < sizeof(jsons) / sizeof(jsons[0]); i++) {
+        size_t line, col;
+        EXPECT_TRUE(testJson(jsons[i], line, col));
+
+        StringStream ss(jsons[i]);
+        LazyCursorStreamWrapper<StringStream> csw(ss);
+        Document document;
+        EXPECT_TRUE(document.ParseStream(csw).HasParseError());
+        EXPECT_EQ(document.GetErrorOffset(), csw.Tell());
+        EXPECT_EQ(line, csw.GetLine());
+        EXPECT_EQ(col, csw.GetColumn());
+    }
+}
+
+TEST(LazyCursorStreamWrapper, MemoryStream) {
+    const char json[] = "{\"string\"\n\n:\"my string\",\"array\"\n:[\"1\" \"2\", \"3\"]}";
+    MemoryStream ms(json, sizeof(json) - 1);
+    LazyCursorStreamWrapper<MemoryStream> csw(ms);
+    Document document;
+    EXPECT_TRUE(document.ParseStream(csw).HasParseError());
+    EXPECT_EQ(4u, csw.GetLine());
+    EXPECT_EQ(6u, csw.GetColumn());
+}
+
+TEST(LazyCursorStreamWrapper, UTF16) {
+    const wchar_t json[] = L"{\"string\"\n\n:\"my string\",\"array\"\n:[\"1\" \"2\", \"3\"]}";
+    GenericStringStream<UTF16<> > ss(json);
+    LazyCursorStreamWrapper<GenericStringStream<UTF16<> >, UTF16<> > csw(ss);
+    GenericDocument<UTF16<> > document;
+    EXPECT_TRUE(document.ParseStream(csw).HasParseError());
+    EXPECT_EQ(4u, csw.GetLine());
+    EXPECT_EQ(6u, csw.GetColumn());
+}
+
+TEST(LazyCursorStreamWrapper, Incremental) {
+    StringStream ss("ab\ncd\n\nef");
+    LazyCursorStreamWrapper<StringStream> csw(ss);
+    const size_t lines[] = { 1, 1, 1, 2, 2, 2, 3, 4, 4, 4 };
+    const size_t columns[] = { 0, 1, 2, 0, 1, 2, 0, 0, 1, 2 };
+    for (size_t i = 0; i < 10; i++) {
+        EXPECT_EQ(lines[i], csw.GetLine());
+        EXPECT_EQ(columns[i], csw.GetColumn());
+        csw.Take();
+    }
+
+    // Going back counts again from the start.
+    StringStream ss2("ab\ncd");
+    LazyCursorStreamWrapper<StringStream> csw2(ss2);
+    ss2.src_ += 4;
+    EXPECT_EQ(2u, csw2.GetLine());
+    EXPECT_EQ(1u, csw2.GetColumn());
+    ss2.src_ -= 3;
+    EXPECT_EQ(1u, csw2.GetLine());
+    EXPECT_EQ(1u, csw2.GetColumn());
+}
@@ -384,6 +384,77 @@ TEST(Document, UserBuffer) {
     EXPECT_LE(parseAllocator.Size(), parseAllocator.Capacity());
 }
 
+TEST(Document, Recycle) {
+    const char* json = "{\"hello\":\"world\",\"a\":[1,2,3,4],\"o\":{\"s\":\"a string longer than the short string optimization\"}}";
+    Document d;
+    d.Parse(json);
+    const size_t capacity = d.GetAllocator().Capacity();
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(d.Recycle().IsNull());
+        EXPECT_EQ(0u, d.GetAllocator().Size());
+        d.Parse(json);
+        EXPECT_FALSE(d.HasParseError());
+        EXPECT_STREQ("world", d["hello"].GetString());
+        EXPECT_EQ(capacity, d.GetAllocator().Capacity());
+    }
+    d.Recycle(0);
+    EXPECT_EQ(0u, d.GetAllocator().Capacity());
+
+    GenericDocument<UTF8<>, CrtAllocator> c;
+    for (int i = 0; i < 3; i++) {
+        c.Recycle().Parse(json);
+        EXPECT_EQ(4u, c["a"].Size());
+    }
+}
+
+TEST(Document, FreeListAllocator) {
+    typedef GenericDocument<UTF8<>, FreeListAllocator<> > MutableDocument;
+    MutableDocument d;
+    d.Parse("{\"a\":[1,2,3],\"s\":\"a string longer than the short string optimization\"}");
+    ASSERT_FALSE(d.HasParseError());
+    MutableDocument::AllocatorType& a = d.GetAllocator();
+
+    // Changing the values again and again reuses the freed memory.
+    size_t capacity = 0;
+    for (int i = 0; i < 1000; i++) {
+        d["s"].SetString(std::string(static_cast<size_t>(i % 200), 'x').c_str(), a);
+        d["a"].PushBack(i, a);
+        if (d["a"].Size() > 100)
+            d["a"].SetArray();
+        d.AddMember(MutableDocument::ValueType("tmp", a), MutableDocument::ValueType().SetObject(), a);
+        d["tmp"].AddMember("x", i, a);
+        d.RemoveMember("tmp");
+        if (i == 500)
+            capacity = a.Capacity();
+    }
+    EXPECT_EQ(capacity, a.Capacity());
+    EXPECT_EQ(199u, d["s"].GetStringLength());
+
+    d.SetNull();
+    EXPECT_EQ(0u, a.Size());
+}
+
+TEST(Document, InstrumentedAllocator) {
+    const char* json = "{\"hello\":\"world\",\"a\":[1,2,3,4],\"o\":{\"s\":\"a string longer than the short string optimization\"}}";
+    GenericDocument<UTF8<>, InstrumentedAllocator<> > d;
+    d.Parse(json);
+    AllocatorStats stats = d.GetAllocator().GetStats();
+    EXPECT_EQ(4u, stats.mallocCount);
+    EXPECT_EQ(stats.requestedBytes, stats.usedBytes);
+    EXPECT_LE(stats.usedBytes, d.GetAllocator().GetBaseAllocator().Size());
+    EXPECT_EQ(1u, stats.chunkCount);
+    EXPECT_EQ(d.GetAllocator().GetBaseAllocator().Capacity(), stats.reservedBytes);
+
+    GenericDocument<UTF8<>, InstrumentedAllocator<CrtAllocator> > c;
+    c.Parse(json);
+    c["a"].PushBack(5, c.GetAllocator());
+    EXPECT_EQ(1u, c.GetAllocator().GetStats().reallocCount);
+    c.SetNull();
+    stats = c.GetAllocator().GetStats();
+    EXPECT_EQ(stats.mallocCount, stats.freeCount);
+    EXPECT_EQ(0u, stats.usedBytes);
+}
+
 // Issue 226: Value of string type should not point to NULL
 TEST(Document, AssertAcceptInvalidNameType) {
     Document doc;
@@ -659,6 +730,74 @@ TYPED_TEST(DocumentMove, MoveAssignmentStack) {
 
 #endif // RAPIDJSON_HAS_CXX11_RVALUE_REFS
 
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+// Records with strings which look like the structure around them.
+static std::string MakeRecords(unsigned count, const char* separator) {
+    std::string json = "[";
+    char record[128];
+    for (unsigned i = 0; i < count; i++) {
+        sprintf(record, "%s{\"id\":%u,\"s\":\"a, b\\\"],[{\",\"a\":[%u,[],{},\"}\"],\"n\":null}", i ? separator : "", i, i % 7);
+        json += record;
+    }
+    return json + "]";
+}
+
+template <typename DocumentType>
+static void TestParseParallel(DocumentType& d, const std::string& json) {
+    DocumentType expected;
+    expected.Parse(json.c_str());
+    for (unsigned threadCount = 1; threadCount <= 5; threadCount++) {
+        d.SetObject();
+        d.ParseParallel(json.c_str(), threadCount);
+        EXPECT_EQ(expected.GetParseError(), d.GetParseError()) << threadCount << " threads";
+        EXPECT_EQ(expected.GetErrorOffset(), d.GetErrorOffset()) << threadCount << " threads";
+        if (!expected.HasParseError()) {
+            EXPECT_TRUE(expected == d) << threadCount << " threads";
+        }
+    }
+}
+
+template <typename DocumentType>
+static void TestParseParallel(const std::string& json) {
+    DocumentType d;
+    TestParseParallel(d, json);
+}
+
+TEST(Document, ParseParallel) {
+    const std::string lines = MakeRecords(20000, ",\n");
+    const std::string line = MakeRecords(20000, ", ");
+    TestParseParallel<Document>(lines);
+    TestParseParallel<Document>(line);
+    TestParseParallel<GenericDocument<UTF8<>, CrtAllocator> >(lines);
+    TestParseParallel<GenericDocument<UTF8<>, CrtAllocator> >(line);
+
+    // Nested arrays, and not an array
+    TestParseParallel<Document>("[" + line + ",\n" + lines + "]");
+    TestParseParallel<Document>("{\"a\":" + lines + "}");
+
+    // Empty, and large strings without a comma outside
+    TestParseParallel<Document>("\n[" + std::string(1 << 20, ' ') + "]\n");
+    TestParseParallel<Document>("[\"" + std::string(1 << 20, ',') + "\"]");
+
+    // User buffer
+    char buffer[1024];
+    MemoryPoolAllocator<> allocator(buffer, sizeof(buffer));
+    Document d(&allocator);
+    TestParseParallel(d, lines);
+}
+
+TEST(Document, ParseParallel_Error) {
+    std::string json = MakeRecords(20000, ",\n");
+    TestParseParallel<Document>(json + " 1");
+    TestParseParallel<Document>(json.substr(0, json.size() - 1));
+
+    json.insert(json.find('\n', json.size() * 3 / 4) + 1, "tru");
+    TestParseParallel<Document>(json);
+}
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
+
 // Issue 22: Memory corruption via operator=
 // Fixed by making unimplemented assignment operator private.
 //TEST(Document, Assignment) {
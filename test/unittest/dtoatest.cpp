@@ -14,6 +14,7 @@
 
 #include "unittest.h"
 #include "rapidjson/internal/dtoa.h"
+#include "rapidjson/internal/schubfach.h"
 
 #ifdef __GNUC__
 RAPIDJSON_DIAG_PUSH
@@ -22,11 +23,13 @@ RAPIDJSON_DIAG_OFF(type-limits)
 
 using namespace rapidjson::internal;
 
-TEST(dtoa, normal) {
+typedef char* (*DtoaFunction)(double, char*, int);
+
+static void TestDtoaNormal(DtoaFunction f) {
     char buffer[30];
 
 #define TEST_DTOA(d, a)\
-    *dtoa(d, buffer) = '\0';\
+    *f(d, buffer, 324) = '\0';\
     EXPECT_STREQ(a, buffer)
 
     TEST_DTOA(0.0, "0.0");
@@ -50,11 +53,11 @@ TEST(dtoa, normal) {
 #undef TEST_DTOA
 }
 
-TEST(dtoa, maxDecimalPlaces) {
+static void TestDtoaMaxDecimalPlaces(DtoaFunction f) {
     char buffer[30];
 
 #define TEST_DTOA(m, d, a)\
-    *dtoa(d, buffer, m) = '\0';\
+    *f(d, buffer, m) = '\0';\
     EXPECT_STREQ(a, buffer)
 
     TEST_DTOA(3, 0.0, "0.0");
@@ -92,6 +95,63 @@ TEST(dtoa, maxDecimalPlaces) {
 #undef TEST_DTOA
 }
 
+TEST(dtoa, normal) {
+    TestDtoaNormal(dtoa);
+}
+
+TEST(dtoa, maxDecimalPlaces) {
+    TestDtoaMaxDecimalPlaces(dtoa);
+}
+
+TEST(dtoa, ShortestNormal) {
+    TestDtoaNormal(ShortestDtoa);
+}
+
+TEST(dtoa, ShortestMaxDecimalPlaces) {
+    TestDtoaMaxDecimalPlaces(ShortestDtoa);
+}
+
+TEST(dtoa, Shortest) {
+    char buffer[30];
+
+#define TEST_DTOA(d, a)\
+    *ShortestDtoa(d, buffer) = '\0';\
+    EXPECT_STREQ(a, buffer)
+
+    // Grisu2 writes one digit more for these
+    TEST_DTOA(1.830525276903402e208, "1.830525276903402e208");
+    TEST_DTOA(5.074532568575482e-164, "5.074532568575482e-164");
+    TEST_DTOA(4.356003652470639e260, "4.356003652470639e260");
+    // and not the closest 17th digit for these
+    TEST_DTOA(2.8662131333270925e162, "2.8662131333270925e162");
+    TEST_DTOA(3.6328849280611267e-206, "3.6328849280611267e-206");
+    // Powers of two, whose lower neighbour is closer
+    TEST_DTOA(5.960464477539063e-8, "5.960464477539063e-8");
+    TEST_DTOA(9007199254740992.0, "9007199254740992.0");
+    TEST_DTOA(8.98846567431158e307, "8.98846567431158e307");
+    TEST_DTOA(1e23, "1e23");
+    TEST_DTOA(123456789012345680.0, "123456789012345680.0");
+    TEST_DTOA(0.3, "0.3");
+
+#undef TEST_DTOA
+}
+
+TEST(dtoa, ShortestRoundTrip) {
+    // Random bit patterns must read back to the same double with no more digits than Grisu2
+    uint64_t x = RAPIDJSON_UINT64_C2(0x01393F0F, 0x2C48D734);
+    for (int i = 0; i < 1000000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        const double d = Double(x & RAPIDJSON_UINT64_C2(0x7FEFFFFF, 0xFFFFFFFF)).Value();
+
+        char shortest[30], grisu2[30];
+        *ShortestDtoa(d, shortest) = '\0';
+        *dtoa(d, grisu2) = '\0';
+        ASSERT_EQ(d, strtod(shortest, 0)) << shortest;
+        ASSERT_LE(strlen(shortest), strlen(grisu2)) << shortest << " " << grisu2;
+    }
+}
 
 #ifdef __GNUC__
 RAPIDJSON_DIAG_POP
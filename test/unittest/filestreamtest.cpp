@@ -15,6 +15,8 @@
 #include "unittest.h"
 #include "rapidjson/filereadstream.h"
 #include "rapidjson/filewritestream.h"
+#include "rapidjson/mmapreadstream.h"
+#include "rapidjson/document.h"
 #include "rapidjson/encodedstream.h"
 
 using namespace rapidjson;
@@ -86,6 +88,86 @@ TEST_F(FileStreamTest, FileReadStream) {
     fclose(fp);
 }
 
+TEST_F(FileStreamTest, MmapReadStream) {
+    FILE *fp = fopen(filename_, "rb");
+    ASSERT_TRUE(fp != 0);
+    MmapReadStream s(fp);
+#if defined(__unix__) || defined(__APPLE__)
+    EXPECT_TRUE(s.IsMapped());
+#endif
+    EXPECT_EQ(length_, s.GetSize());
+    ASSERT_TRUE(s.Peek4() != 0);
+
+    for (size_t i = 0; i < length_; i++) {
+        EXPECT_EQ(json_[i], s.Peek());
+        EXPECT_EQ(json_[i], s.Take());
+    }
+
+    EXPECT_EQ(length_, s.Tell());
+    EXPECT_EQ('\0', s.Peek());
+    EXPECT_TRUE(s.Peek4() == 0);
+    fclose(fp);
+
+    // Parsed as a string stream
+    fp = fopen(filename_, "rb");
+    MmapReadStream is(fp);
+    Document d1, d2;
+    d1.ParseStream(is);
+    d2.Parse(json_);
+    EXPECT_FALSE(d1.HasParseError());
+    EXPECT_TRUE(d1 == d2);
+    fclose(fp);
+}
+
+TEST_F(FileStreamTest, MmapReadStream_Position) {
+    // Files of whole pages are still terminated, and the stream starts at the file position.
+    for (size_t length = 4095; length <= 8193; length++) {
+        FILE* fp = tmpfile();
+        ASSERT_TRUE(fp != 0);
+        std::string json = "[" + std::string(length - 4, ' ') + "1]\n";
+        fwrite(json.data(), 1, json.size(), fp);
+        fseek(fp, 1, SEEK_SET);
+        {
+            MmapReadStream s(fp);
+            EXPECT_EQ(length - 1, s.GetSize());
+            Document d;
+            d.ParseStream<kParseStopWhenDoneFlag>(s);
+            EXPECT_TRUE(d.IsInt());
+            EXPECT_EQ(length - 3, s.Tell());
+        }
+        fclose(fp);
+        if (length == 4097)
+            length = 8190;
+    }
+}
+
+TEST_F(FileStreamTest, MmapReadStream_Read) {
+    // An empty file is read, not mapped.
+    FILE* fp = tmpfile();
+    ASSERT_TRUE(fp != 0);
+    {
+        MmapReadStream s(fp);
+        EXPECT_FALSE(s.IsMapped());
+        EXPECT_EQ(0u, s.GetSize());
+        EXPECT_EQ('\0', s.Peek());
+    }
+    fclose(fp);
+
+#if defined(__unix__) || defined(__APPLE__)
+    fp = popen("echo '[1, 2]'", "r");
+    ASSERT_TRUE(fp != 0);
+    {
+        MmapReadStream s(fp);
+        EXPECT_FALSE(s.IsMapped());
+        EXPECT_EQ(7u, s.GetSize());
+        Document d;
+        d.ParseStream(s);
+        EXPECT_EQ(2u, d.Size());
+    }
+    pclose(fp);
+#endif
+}
+
 TEST_F(FileStreamTest, FileWriteStream) {
     char filename[L_tmpnam];
     FILE* fp = TempFile(filename);
@@ -0,0 +1,189 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+
+#include "rapidjson/iovecwritestream.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include "rapidjson/document.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+#include <string>
+
+using namespace rapidjson;
+
+namespace {
+
+// A document with short strings, long strings, and long strings with characters to escape.
+void MakeDocument(Document& d, unsigned count) {
+    Document::AllocatorType& a = d.GetAllocator();
+    const std::string text(300, 'x');
+    d.SetArray();
+    for (unsigned i = 0; i < count; i++) {
+        Value record(kObjectType);
+        record.AddMember("id", i, a);
+        record.AddMember("name", "short", a);
+        record.AddMember("text", Value(text.c_str(), static_cast<SizeType>(text.size() - i % 7), a), a);
+        record.AddMember("quoted", Value((text + "\"\n" + text).c_str(), a), a);
+        d.PushBack(record, a);
+    }
+}
+
+// Reads what the stream wrote to fp.
+std::string ReadAll(FILE* fp) {
+    std::string s;
+    char buffer[4096];
+    rewind(fp);
+    for (size_t n; (n = fread(buffer, 1, sizeof(buffer), fp)) > 0; )
+        s.append(buffer, n);
+    return s;
+}
+
+template <typename Allocator>
+std::string Gather(GenericIoVecWriteStream<Allocator>& os) {
+    std::string s;
+    const struct iovec* iov = os.GetIoVecs();
+    for (size_t i = 0; i < os.GetIoVecCount(); i++)
+        s.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+    return s;
+}
+
+} // namespace
+
+TEST(IoVecWriteStream, Writer) {
+    Document d;
+    MakeDocument(d, 100);
+    StringBuffer sb;
+    Writer<StringBuffer> sbWriter(sb);
+    d.Accept(sbWriter);
+
+    FILE* fp = tmpfile();
+    ASSERT_TRUE(fp != 0);
+    {
+        IoVecWriteStream os(fileno(fp));
+        Writer<IoVecWriteStream> writer(os);
+        d.Accept(writer);
+        EXPECT_FALSE(os.HasError());
+        EXPECT_EQ(0u, os.GetSize());
+        EXPECT_EQ(sb.GetSize(), os.GetCopiedSize() + os.GetReferencedSize());
+        EXPECT_GT(os.GetReferencedSize(), os.GetCopiedSize());
+    }
+    EXPECT_EQ(std::string(sb.GetString(), sb.GetSize()), ReadAll(fp));
+    fclose(fp);
+}
+
+TEST(IoVecWriteStream, PrettyWriter) {
+    Document d;
+    MakeDocument(d, 10);
+    StringBuffer sb;
+    PrettyWriter<StringBuffer> sbWriter(sb);
+    d.Accept(sbWriter);
+
+    IoVecWriteStream os;
+    PrettyWriter<IoVecWriteStream> writer(os);
+    d.Accept(writer);
+    EXPECT_EQ(sb.GetSize(), os.GetSize());
+    EXPECT_EQ(std::string(sb.GetString(), sb.GetSize()), Gather(os));
+}
+
+TEST(IoVecWriteStream, Reference) {
+    const std::string text(200, 'a');
+    const std::string raw = "[" + text + "]";
+    IoVecWriteStream os;
+    Writer<IoVecWriteStream> writer(os);
+    writer.StartArray();
+    writer.String(text.c_str(), static_cast<SizeType>(text.size()));
+    writer.String("short");
+    writer.RawValue(raw.c_str(), raw.size(), kArrayType);
+    writer.EndArray();
+
+    // The long string and the raw value are referred to where they are.
+    const struct iovec* iov = os.GetIoVecs();
+    ASSERT_EQ(5u, os.GetIoVecCount());
+    EXPECT_EQ(2u, iov[0].iov_len);
+    EXPECT_EQ(text.c_str(), iov[1].iov_base);
+    EXPECT_EQ(text.size(), iov[1].iov_len);
+    EXPECT_EQ(10u, iov[2].iov_len);
+    EXPECT_EQ(raw.c_str(), iov[3].iov_base);
+    EXPECT_EQ(raw.size(), iov[3].iov_len);
+    EXPECT_EQ(1u, iov[4].iov_len);
+    EXPECT_EQ(text.size() + raw.size(), os.GetReferencedSize());
+    EXPECT_EQ("[\"" + text + "\",\"short\"," + raw + "]", Gather(os));
+}
+
+TEST(IoVecWriteStream, Blocks) {
+    // Blocks of 8 bytes, and no references.
+    IoVecWriteStream os(-1, 1000, 8);
+    const std::string text(100, 'b');
+    os.Put('[');
+    PutN(os, ' ', 20);
+    PutBlockUnsafe(os, text.c_str(), text.size());
+    os.Put(']');
+    EXPECT_EQ(122u, os.GetSize());
+    EXPECT_EQ(122u, os.GetCopiedSize());
+    EXPECT_EQ(0u, os.GetReferencedSize());
+    EXPECT_EQ(16u, os.GetIoVecCount());
+    EXPECT_EQ("[" + std::string(20, ' ') + text + "]", Gather(os));
+
+    // The blocks are used again after Clear().
+    const void* first = os.GetIoVecs()[0].iov_base;
+    os.Clear();
+    EXPECT_EQ(0u, os.GetSize());
+    EXPECT_EQ(0u, os.GetIoVecCount());
+    os.Put('x');
+    EXPECT_EQ(first, os.GetIoVecs()[0].iov_base);
+    EXPECT_EQ("x", Gather(os));
+    EXPECT_EQ(123u, os.GetCopiedSize());
+}
+
+TEST(IoVecWriteStream, ManyIoVecs) {
+    // More buffers than one writev() takes.
+    Document d;
+    MakeDocument(d, 3000);
+    StringBuffer sb;
+    Writer<StringBuffer> sbWriter(sb);
+    d.Accept(sbWriter);
+
+    FILE* fp = tmpfile();
+    ASSERT_TRUE(fp != 0);
+    GenericIoVecWriteStream<MemoryPoolAllocator<> > os(fileno(fp), 64, 256);
+    Writer<GenericIoVecWriteStream<MemoryPoolAllocator<> > > writer(os);
+    d.Accept(writer);
+    EXPECT_FALSE(os.HasError());
+
+    // Output of a second document reuses the blocks.
+    writer.Reset(os);
+    d.Accept(writer);
+    EXPECT_FALSE(os.HasError());
+    const std::string json(sb.GetString(), sb.GetSize());
+    EXPECT_EQ(json + json, ReadAll(fp));
+    fclose(fp);
+}
+
+TEST(IoVecWriteStream, Error) {
+    // The read end of a pipe cannot be written.
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    IoVecWriteStream os(fds[0]);
+    os.Put('x');
+    os.Flush();
+    EXPECT_TRUE(os.HasError());
+    EXPECT_EQ(0u, os.GetSize());
+    close(fds[0]);
+    close(fds[1]);
+}
+
+#endif // defined(__unix__) || defined(__APPLE__)
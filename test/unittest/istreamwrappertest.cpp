@@ -19,6 +19,7 @@
 #include "rapidjson/document.h"
 #include <sstream>
 #include <fstream>
+#include <vector>
 
 #if defined(_MSC_VER) && !defined(__clang__)
 RAPIDJSON_DIAG_PUSH
@@ -28,13 +29,13 @@ RAPIDJSON_DIAG_OFF(4702) // unreachable code
 using namespace rapidjson;
 using namespace std;
 
-template <typename StringStreamType>
+template <typename StringStreamType, typename IStreamWrapperType>
 static void TestStringStream() {
     typedef typename StringStreamType::char_type Ch;
 
     {
         StringStreamType iss;
-        BasicIStreamWrapper<StringStreamType> is(iss);
+        IStreamWrapperType is(iss);
         EXPECT_EQ(0u, is.Tell());
         if (sizeof(Ch) == 1) {
             EXPECT_EQ(0, is.Peek4());
@@ -48,7 +49,7 @@ static void TestStringStream() {
     {
         Ch s[] = { 'A', 'B', 'C', '\0' };
         StringStreamType iss(s);
-        BasicIStreamWrapper<StringStreamType> is(iss);
+        IStreamWrapperType is(iss);
         EXPECT_EQ(0u, is.Tell());
         if (sizeof(Ch) == 1) {
             EXPECT_EQ(0, is.Peek4()); // less than 4 bytes
@@ -67,7 +68,7 @@ static void TestStringStream() {
     {
         Ch s[] = { 'A', 'B', 'C', 'D', 'E', '\0' };
         StringStreamType iss(s);
-        BasicIStreamWrapper<StringStreamType> is(iss);
+        IStreamWrapperType is(iss);
         if (sizeof(Ch) == 1) {
             const Ch* c = is.Peek4();
             for (int i = 0; i < 4; i++)
@@ -87,19 +88,23 @@ static void TestStringStream() {
 }
 
 TEST(IStreamWrapper, istringstream) {
-    TestStringStream<istringstream>();
+    TestStringStream<istringstream, BasicIStreamWrapper<istringstream> >();
+    TestStringStream<istringstream, BasicBufferedIStreamWrapper<istringstream> >();
 }
 
 TEST(IStreamWrapper, stringstream) {
-    TestStringStream<stringstream>();
+    TestStringStream<stringstream, BasicIStreamWrapper<stringstream> >();
+    TestStringStream<stringstream, BasicBufferedIStreamWrapper<stringstream> >();
 }
 
 TEST(IStreamWrapper, wistringstream) {
-    TestStringStream<wistringstream>();
+    TestStringStream<wistringstream, BasicIStreamWrapper<wistringstream> >();
+    TestStringStream<wistringstream, BasicBufferedIStreamWrapper<wistringstream> >();
 }
 
 TEST(IStreamWrapper, wstringstream) {
-    TestStringStream<wstringstream>();
+    TestStringStream<wstringstream, BasicIStreamWrapper<wstringstream> >();
+    TestStringStream<wstringstream, BasicBufferedIStreamWrapper<wstringstream> >();
 }
 
 template <typename FileStreamType>
@@ -143,6 +148,52 @@ TEST(IStreamWrapper, fstream) {
     EXPECT_EQ(5u, d.MemberCount());
 }
 
+TEST(IStreamWrapper, Buffered) {
+    const std::string json = "  {\"a\" : [1, 2.5,  \"xyz\", \"\\u00e9\"],\n\t\"b\":  {  }  , \"c\" : \"" + std::string(100, 'c') + "\"}  ";
+    Document expected;
+    expected.Parse(json.c_str());
+    ASSERT_FALSE(expected.HasParseError());
+
+    // Blocks of any size, with white spaces across them
+    for (size_t bufferSize = 5; bufferSize < 40; bufferSize++) {
+        istringstream iss(json);
+        std::vector<char> buffer(bufferSize);
+        BufferedIStreamWrapper isw(iss, &buffer[0], bufferSize);
+        Document d;
+        d.ParseStream<kParseStopWhenDoneFlag>(isw);
+        EXPECT_FALSE(d.HasParseError()) << bufferSize;
+        EXPECT_TRUE(d == expected) << bufferSize;
+        EXPECT_EQ(json.size() - 2, isw.Tell()) << bufferSize;
+
+        SkipWhitespace(isw);
+        EXPECT_EQ(json.size(), isw.Tell());
+        EXPECT_EQ('\0', isw.Take());
+        EXPECT_TRUE(iss.eof());
+    }
+
+    // Errors are at the same offsets
+    istringstream iss("[1, 2,   ]");
+    BufferedIStreamWrapper isw(iss, 5);
+    Document d;
+    EXPECT_TRUE(d.ParseStream(isw).HasParseError());
+    EXPECT_EQ(9u, d.GetErrorOffset());
+}
+
+TEST(IStreamWrapper, Buffered_ifstream) {
+    const char* filenames[] = { "utf8.json", "utf8bom.json", "utf16lebom.json", "utf32bebom.json" };
+    for (size_t i = 0; i < sizeof(filenames) / sizeof(filenames[0]); i++) {
+        ifstream ifs;
+        ASSERT_TRUE(Open(ifs, filenames[i]));
+        BufferedIStreamWrapper isw(ifs, 7);
+        AutoUTFInputStream<unsigned, BufferedIStreamWrapper> eis(isw);
+        Document d;
+        d.ParseStream<0, AutoUTF<unsigned> >(eis);
+        EXPECT_FALSE(d.HasParseError()) << filenames[i];
+        EXPECT_TRUE(d.IsObject());
+        EXPECT_EQ(5u, d.MemberCount());
+    }
+}
+
 // wifstream/wfstream only works on C++11 with codecvt_utf16
 // But many C++11 library still not have it.
 #if 0
@@ -0,0 +1,215 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+
+#include "rapidjson/jsonlines.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+using namespace rapidjson;
+
+namespace {
+
+typedef std::pair<size_t, std::string> Record;
+
+// Collects each record as its offset and its JSON, or the parse error.
+struct RecordCollector {
+    RecordCollector() : records(), mutex(), stopAfter(0) {}
+
+    bool operator()(size_t offset, Document& d) {
+        std::string text;
+        if (d.HasParseError()) {
+            char buffer[32];
+            sprintf(buffer, "error %d at %u", static_cast<int>(d.GetParseError()), static_cast<unsigned>(d.GetErrorOffset()));
+            text = buffer;
+        }
+        else {
+            StringBuffer sb;
+            Writer<StringBuffer> writer(sb);
+            d.Accept(writer);
+            text = sb.GetString();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        records.push_back(Record(offset, text));
+        return stopAfter == 0 || records.size() < stopAfter;
+    }
+
+    std::vector<Record> records;
+    std::mutex mutex;
+    size_t stopAfter;
+};
+
+std::string MakeLines(unsigned count) {
+    std::string json;
+    char line[128];
+    for (unsigned i = 0; i < count; i++) {
+        sprintf(line, "{\"id\":%u,\"name\":\"record %u\",\"tags\":[\"a\",\"b\\n\"],\"score\":%u.5}\n", i, i, i % 100);
+        json += line;
+    }
+    return json;
+}
+
+// Every non-blank line parsed on its own.
+std::vector<Record> SerialRecords(const std::string& json) {
+    RecordCollector collector;
+    size_t begin = 0;
+    while (begin < json.size()) {
+        size_t end = json.find('\n', begin);
+        if (end == std::string::npos)
+            end = json.size();
+        std::string line = json.substr(begin, end - begin);
+        if (line.find_first_not_of(" \t\r") != std::string::npos) {
+            Document d;
+            d.Parse(line.c_str());
+            collector(begin, d);
+        }
+        begin = end + 1;
+    }
+    return collector.records;
+}
+
+void TestLines(const std::string& json, unsigned threadCount, size_t chunkSize) {
+    const std::vector<Record> expected = SerialRecords(json);
+
+    JsonLinesParser parser(threadCount, chunkSize);
+    EXPECT_EQ(threadCount, parser.GetThreadCount());
+    EXPECT_TRUE(parser.IsOrdered());
+    RecordCollector ordered;
+    EXPECT_TRUE(parser.Parse(json.data(), json.size(), ordered));
+    EXPECT_TRUE(expected == ordered.records) << threadCount << " threads, chunks of " << chunkSize;
+
+    RecordCollector unordered;
+    EXPECT_TRUE(parser.SetOrdered(false).Parse(json.data(), json.size(), unordered));
+    std::sort(unordered.records.begin(), unordered.records.end());
+    EXPECT_TRUE(expected == unordered.records) << threadCount << " threads, chunks of " << chunkSize;
+}
+
+} // namespace
+
+TEST(JsonLines, Parse) {
+    const std::string json = MakeLines(1000);
+    for (unsigned threadCount = 1; threadCount <= 4; threadCount++) {
+        TestLines(json, threadCount, 1);
+        TestLines(json, threadCount, 100);
+        TestLines(json, threadCount, 4096);
+        TestLines(json, threadCount, 1 << 20);
+    }
+}
+
+TEST(JsonLines, Lines) {
+    // Blank lines, CRLF, no newline at the end, and scalars
+    TestLines("", 2, 16);
+    RecordCollector none;
+    EXPECT_TRUE(JsonLinesParser(2).Parse(0, 0, none));
+    EXPECT_TRUE(none.records.empty());
+    TestLines("\n\n \r\n", 2, 16);
+    TestLines("[1]", 2, 16);
+    TestLines("1\r\n\r\n\"a\"\r\n  {\"b\":null}  \r\n\n[true, false]", 2, 4);
+    TestLines("{\"long\":\"" + std::string(1000, 'x') + "\"}\n[]\n", 3, 16);
+
+    // Lines which are not complete documents
+    TestLines("{\"a\":1\n}\n[1, 2]\n", 2, 16);
+    TestLines("[1] [2]\n{\"a\" 1}\ntru\n[\"\\u00e9\"]\n", 2, 8);
+}
+
+TEST(JsonLines, Offsets) {
+    const char json[] = "[1]\n\n  {\"a\":2}\r\n\"x\n";
+    JsonLinesParser parser(2, 1);
+    RecordCollector collector;
+    EXPECT_TRUE(parser.Parse(json, sizeof(json) - 1, collector));
+    ASSERT_EQ(3u, collector.records.size());
+    EXPECT_EQ(Record(0, "[1]"), collector.records[0]);
+    EXPECT_EQ(Record(5, "{\"a\":2}"), collector.records[1]);
+    EXPECT_EQ(16u, collector.records[2].first);
+
+    // Error offsets are relative to the line
+    char error[32];
+    sprintf(error, "error %d at %u", static_cast<int>(kParseErrorStringMissQuotationMark), 2u);
+    EXPECT_EQ(error, collector.records[2].second);
+}
+
+TEST(JsonLines, Stop) {
+    const std::string json = MakeLines(1000);
+    for (unsigned threadCount = 1; threadCount <= 4; threadCount++) {
+        JsonLinesParser parser(threadCount, 256);
+        RecordCollector collector;
+        collector.stopAfter = 10;
+        EXPECT_FALSE(parser.Parse(json.data(), json.size(), collector));
+        EXPECT_EQ(10u, collector.records.size());
+        EXPECT_EQ(0u, collector.records[0].first);
+
+        // The parser can be used again
+        RecordCollector all;
+        EXPECT_TRUE(parser.Parse(json.data(), json.size(), all));
+        EXPECT_EQ(1000u, all.records.size());
+
+        RecordCollector unordered;
+        unordered.stopAfter = 10;
+        EXPECT_FALSE(parser.SetOrdered(false).Parse(json.data(), json.size(), unordered));
+        EXPECT_GE(unordered.records.size(), 10u);
+        EXPECT_LT(unordered.records.size(), 1000u);
+    }
+}
+
+TEST(JsonLines, ParseFile) {
+    const std::string json = MakeLines(500) + "{\"last\":[\"no newline\"]}";
+    const std::vector<Record> expected = SerialRecords(json);
+
+    for (unsigned threadCount = 1; threadCount <= 3; threadCount++) {
+        for (size_t chunkSize = 1; chunkSize <= 65536; chunkSize *= 16) {
+            FILE* fp = tmpfile();
+            ASSERT_TRUE(fp != 0);
+            fwrite(json.data(), 1, json.size(), fp);
+            rewind(fp);
+
+            JsonLinesParser parser(threadCount, chunkSize);
+            RecordCollector collector;
+            EXPECT_TRUE(parser.ParseFile(fp, collector));
+            EXPECT_FALSE(parser.HasReadError());
+            EXPECT_TRUE(expected == collector.records) << threadCount << " threads, chunks of " << chunkSize;
+            fclose(fp);
+        }
+    }
+}
+
+TEST(JsonLines, ParseFlags) {
+    const char json[] = "[1.0, 2] // one\n{\"a\": \"\\u0000b\"} /* two */\n";
+    JsonLinesParser parser(2, 8);
+    RecordCollector collector;
+    EXPECT_TRUE(parser.Parse<kParseCommentsFlag | kParseFullPrecisionFlag>(json, sizeof(json) - 1, collector));
+    ASSERT_EQ(2u, collector.records.size());
+    EXPECT_EQ("[1.0,2]", collector.records[0].second);
+    EXPECT_EQ(std::string("{\"a\":\"\\u0000b\"}"), collector.records[1].second);
+}
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
@@ -0,0 +1,46 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// The bound of the tape of GenericLazyDocument, lowered so that it is reached.
+
+#define RAPIDJSON_LAZYDOCUMENT_MAX_TOKENS 8
+#define RAPIDJSON_NAMESPACE rapidjson_lazylimit
+
+#include "unittest.h"
+
+#include "rapidjson/lazydocument.h"
+
+using namespace rapidjson_lazylimit;
+
+TEST(LazyDocument, MaxTokens) {
+    // The null token at position 0, the array, its elements and its end
+    LazyDocument d;
+    d.Parse("[0,1,2,3,4]");
+    EXPECT_FALSE(d.HasParseError());
+    EXPECT_EQ(4, d.Root()[4].GetInt());
+
+    d.Parse("[0,1,2,3,4,5]");
+    EXPECT_EQ(kParseErrorTermination, d.GetParseError());
+    EXPECT_EQ(12u, d.GetErrorOffset());
+    EXPECT_TRUE(d.Root().IsNull());
+
+    // Containers that end in time, in one that does not
+    d.Parse("{\"a\":[[]],\"b\":{}}");
+    EXPECT_EQ(kParseErrorTermination, d.GetParseError());
+    EXPECT_EQ(15u, d.GetErrorOffset());
+
+    // Scalars take no position of an end
+    d.Parse("12345678");
+    EXPECT_FALSE(d.HasParseError());
+}
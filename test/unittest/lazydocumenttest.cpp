@@ -0,0 +1,286 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+#include "rapidjson/lazydocument.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include <string>
+
+#ifdef __clang__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(c++98-compat)
+#endif
+
+using namespace rapidjson;
+
+static const char kLazyJson[] =
+    "{\n"
+    "  \"hello\": \"world\",\n"
+    "  \"t\": true, \"f\": false, \"n\": null,\n"
+    "  \"i\": 123, \"neg\": -5, \"big\": 12345678901234, \"u64\": 18446744073709551615,\n"
+    "  \"pi\": 3.1416, \"exp\": -1.5e-3,\n"
+    "  \"a\": [1, 2, 3, [4, [5]], {}, []],\n"
+    "  \"escaped\": \"tab\\tquote\\\"\\u00e9\\ud834\\udd1e\",\n"
+    "  \"k\\u0065y\": \"decoded name\",\n"
+    "  \"nested\": {\"x\": {\"y\": {\"z\": [\"deep\"]}}},\n"
+    "  \"empty\": \"\"\n"
+    "}";
+
+static std::string WriteLazy(const LazyDocument& d) {
+    StringBuffer buffer;
+    Writer<StringBuffer> writer(buffer);
+    EXPECT_TRUE(d.Accept(writer));
+    return buffer.GetString();
+}
+
+static std::string WriteDocument(const char* json) {
+    Document d;
+    d.Parse(json);
+    EXPECT_FALSE(d.HasParseError());
+    StringBuffer buffer;
+    Writer<StringBuffer> writer(buffer);
+    d.Accept(writer);
+    return buffer.GetString();
+}
+
+static void DecodeStrings(const LazyValue& v) {
+    if (v.IsString())
+        v.GetString();
+    else if (v.IsArray())
+        for (LazyValue::ValueIterator e = v.Begin(); e != v.End(); ++e)
+            DecodeStrings(*e);
+    else if (v.IsObject())
+        for (LazyValue::MemberIterator m = v.MemberBegin(); m != v.MemberEnd(); ++m) {
+            m->name.GetString();
+            DecodeStrings(m->value);
+        }
+}
+
+TEST(LazyDocument, Accept) {
+    static const char* jsons[] = {
+        kLazyJson,
+        "null", "true", " false ", "0", "-0", "1.5", "\"s\"", "[]", "{}", "[[[]]]",
+        "[-2147483648, 4294967295, -9223372036854775808, 1e308, 5e-324, 0.1]",
+        "{\"a\":{\"b\":[{\"c\":1},{\"c\":[2,{}]}]},\"d\":\"\\n\"}"
+    };
+    for (size_t i = 0; i < sizeof(jsons) / sizeof(jsons[0]); i++) {
+        LazyDocument d;
+        d.Parse(jsons[i]);
+        ASSERT_FALSE(d.HasParseError()) << jsons[i];
+        EXPECT_EQ(WriteDocument(jsons[i]), WriteLazy(d)) << jsons[i];
+
+        // Again after decoding every string into the cache
+        DecodeStrings(d.Root());
+        EXPECT_EQ(WriteDocument(jsons[i]), WriteLazy(d)) << jsons[i];
+    }
+}
+
+TEST(LazyDocument, Access) {
+    LazyDocument d;
+    d.Parse(kLazyJson);
+    ASSERT_FALSE(d.HasParseError());
+    const LazyValue root = d.Root();
+
+    ASSERT_TRUE(root.IsObject());
+    EXPECT_EQ(15u, root.MemberCount());
+    EXPECT_FALSE(root.ObjectEmpty());
+    EXPECT_STREQ("world", root["hello"].GetString());
+    EXPECT_EQ(5u, root["hello"].GetStringLength());
+    EXPECT_TRUE(root["t"].IsTrue());
+    EXPECT_TRUE(root["t"].GetBool());
+    EXPECT_TRUE(root["f"].IsFalse());
+    EXPECT_FALSE(root["f"].GetBool());
+    EXPECT_TRUE(root["n"].IsNull());
+
+    EXPECT_TRUE(root["i"].IsInt());
+    EXPECT_TRUE(root["i"].IsUint());
+    EXPECT_EQ(123, root["i"].GetInt());
+    EXPECT_FALSE(root["neg"].IsUint());
+    EXPECT_EQ(-5, root["neg"].GetInt());
+    EXPECT_FALSE(root["big"].IsInt());
+    EXPECT_TRUE(root["big"].IsInt64());
+    EXPECT_EQ(12345678901234, root["big"].GetInt64());
+    EXPECT_TRUE(root["u64"].IsUint64());
+    EXPECT_FALSE(root["u64"].IsInt64());
+    EXPECT_EQ(18446744073709551615u, root["u64"].GetUint64());
+    EXPECT_TRUE(root["pi"].IsDouble());
+    EXPECT_DOUBLE_EQ(3.1416, root["pi"].GetDouble());
+    EXPECT_DOUBLE_EQ(-1.5e-3, root["exp"].GetDouble());
+    EXPECT_FALSE(root["hello"].IsInt());
+
+    // Strings with escapes
+    const LazyValue escaped = root["escaped"];
+    EXPECT_EQ(16u, escaped.GetStringLength());
+    EXPECT_STREQ("tab\tquote\"\xC3\xA9\xF0\x9D\x84\x9E", escaped.GetString());
+    EXPECT_TRUE(root.HasMember("key"));
+    EXPECT_STREQ("decoded name", root["key"].GetString());
+    EXPECT_EQ(0u, root["empty"].GetStringLength());
+    EXPECT_STREQ("", root["empty"].GetString());
+    EXPECT_FALSE(root.HasMember("k\\u0065y"));
+    EXPECT_FALSE(root.HasMember("missing"));
+    EXPECT_TRUE(root.FindMember("missing") == root.MemberEnd());
+
+    // Arrays
+    const LazyValue a = root["a"];
+    ASSERT_TRUE(a.IsArray());
+    EXPECT_EQ(6u, a.Size());
+    EXPECT_EQ(1, a[0].GetInt());
+    EXPECT_EQ(3, a[2].GetInt());
+    EXPECT_EQ(2u, a[3].Size());
+    EXPECT_EQ(5, a[3][1][0].GetInt());
+    EXPECT_TRUE(a[4].ObjectEmpty());
+    EXPECT_TRUE(a[5].Empty());
+    int sum = 0;
+    for (LazyValue::ValueIterator v = a.Begin(); v != a.End(); ++v)
+        if (v->IsInt())
+            sum += v->GetInt();
+    EXPECT_EQ(6, sum);
+
+    EXPECT_STREQ("deep", root["nested"]["x"]["y"]["z"][0].GetString());
+
+    // Member iteration follows the text
+    LazyValue::MemberIterator m = root.MemberBegin();
+    EXPECT_STREQ("hello", m->name.GetString());
+    EXPECT_STREQ("world", (m++)->value.GetString());
+    EXPECT_STREQ("t", m->name.GetString());
+    SizeType count = 0;
+    for (m = root.MemberBegin(); m != root.MemberEnd(); ++m)
+        count++;
+    EXPECT_EQ(root.MemberCount(), count);
+
+#if RAPIDJSON_HAS_STDSTRING
+    EXPECT_TRUE(root["hello"] == std::string("world"));
+    EXPECT_TRUE(root["hello"] != std::string("worlds"));
+    EXPECT_TRUE(root.HasMember(std::string("nested")));
+    EXPECT_EQ(123, root[std::string("i")].GetInt());
+#endif
+
+    // Root and its end, 15 names, 15 values, 14 more in "a" and 11 more in "nested"
+    EXPECT_EQ(57u, d.GetTokenCount());
+}
+
+TEST(LazyDocument, Reparse) {
+    LazyDocument d;
+    EXPECT_TRUE(d.Root().IsNull());
+    d.Parse("{\"a\\n\":\"b\\n\"}");
+    EXPECT_STREQ("b\n", d.Root()["a\n"].GetString());
+    d.Parse("[\"c\\n\"]");
+    EXPECT_STREQ("c\n", d.Root()[0].GetString());
+    d.Parse("[1,");
+    EXPECT_TRUE(d.HasParseError());
+    EXPECT_TRUE(d.Root().IsNull());
+}
+
+TEST(LazyDocument, ParseError) {
+    static const char* jsons[] = {
+        "", "  ", "nul", "tru", "fals", "x", "-", "01", "1.", "1.e1", "1e", "1e+", "--1",
+        "[", "[1", "[1,", "[1,]", "[1 2]", "[1}", "{", "{1:2}", "{\"a\" 1}", "{\"a\":}", "{\"a\":1,}",
+        "{\"a\":1 \"b\":2}", "{\"a\":1]", "\"abc", "\"\\x\"", "\"\\u12G4\"", "\"a\x01\"", "[1]x", "{} {}"
+    };
+    for (size_t i = 0; i < sizeof(jsons) / sizeof(jsons[0]); i++) {
+        Document expected;
+        expected.Parse(jsons[i]);
+        ASSERT_TRUE(expected.HasParseError()) << jsons[i];
+        LazyDocument d;
+        d.Parse(jsons[i]);
+        EXPECT_TRUE(d.HasParseError()) << jsons[i];
+        EXPECT_EQ(expected.GetParseError(), d.GetParseError()) << jsons[i];
+        EXPECT_EQ(expected.GetErrorOffset(), d.GetErrorOffset()) << jsons[i];
+        EXPECT_TRUE(d.Root().IsNull());
+    }
+}
+
+TEST(LazyDocument, NumberRange) {
+    // Numbers that may overflow are decoded by Parse(), which fails like Document on those that do
+    const std::string digits(308, '9');
+    const std::string jsons[] = {
+        "[1e400]", "-1e309", "0e309", "[0.5, 1E+999999999999]", "{\"a\":" + digits + "0}", digits + "e1",
+        "1.7976931348623157e308", "0.0001e310", digits, digits + ".5", "1e-400", "1" + digits + "e-10", "1e308"
+    };
+    for (size_t i = 0; i < sizeof(jsons) / sizeof(jsons[0]); i++) {
+        Document expected;
+        expected.Parse(jsons[i].c_str());
+        LazyDocument d;
+        d.Parse(jsons[i].c_str());
+        EXPECT_EQ(expected.GetParseError(), d.GetParseError()) << jsons[i];
+        EXPECT_EQ(expected.GetErrorOffset(), d.GetErrorOffset()) << jsons[i];
+        if (!d.HasParseError() && d.Root().IsNumber()) {
+            EXPECT_EQ(expected.GetDouble(), d.Root().GetDouble()) << jsons[i];
+        }
+    }
+}
+
+TEST(LazyDocument, StopWhenDone) {
+    LazyDocument d;
+    d.Parse<kParseStopWhenDoneFlag>("[1] [2]");
+    EXPECT_FALSE(d.HasParseError());
+    EXPECT_EQ(1u, d.Root().Size());
+}
+
+TEST(LazyDocument, DeferredErrors) {
+    // Checks that need decoding happen on access
+    LazyDocument d;
+    d.Parse("[1, \"\\ud800\"]");
+    ASSERT_FALSE(d.HasParseError());
+    EXPECT_STREQ("", d.Root()[1].GetString());
+    StringBuffer buffer;
+    Writer<StringBuffer> writer(buffer);
+    EXPECT_FALSE(d.Accept(writer));     // Also once the string is cached
+
+    LazyDocument v;
+    v.Parse<kParseValidateEncodingFlag>("[\"\xC3\xA9\", \"\xC3\"]");
+    ASSERT_FALSE(v.HasParseError());
+    EXPECT_STREQ("\xC3\xA9", v.Root()[0].GetString());
+    EXPECT_EQ(0u, v.Root()[1].GetStringLength());
+}
+
+TEST(LazyDocument, FullPrecision) {
+    const char* json = "[0.9868011474609375000000000000000000001]";
+    LazyDocument normal, full;
+    normal.Parse(json);
+    full.Parse<kParseFullPrecisionFlag>(json);
+    Document expected;
+    expected.Parse<kParseFullPrecisionFlag>(json);
+    EXPECT_EQ(expected[0].GetDouble(), full.Root()[0].GetDouble());
+    EXPECT_NEAR(expected[0].GetDouble(), normal.Root()[0].GetDouble(), 1e-15);
+}
+
+TEST(LazyDocument, UTF16) {
+    typedef GenericLazyDocument<UTF16<> > LazyDocument16;
+    const UTF16<>::Ch json[] = { '{', '"', 'k', '"', ':', '[', '"', 'v', '\\', 'n', '"', ',', '4', '2', ']', '}', 0 };
+    LazyDocument16 d;
+    d.Parse(json);
+    ASSERT_FALSE(d.HasParseError());
+    const UTF16<>::Ch name[] = { 'k', 0 };
+    const LazyDocument16::ValueType v = d.Root()[name];
+    EXPECT_EQ(2u, v[0].GetStringLength());
+    EXPECT_EQ('\n', v[0].GetString()[1]);
+    EXPECT_EQ(42, v[1].GetInt());
+}
+
+TEST(LazyDocument, CrtAllocator) {
+    // Decoded strings are freed one by one
+    typedef GenericLazyDocument<UTF8<>, CrtAllocator> CrtLazyDocument;
+    CrtLazyDocument d;
+    d.Parse("[\"a\", \"b\\n\"]");
+    EXPECT_STREQ("a", d.Root()[0].GetString());
+    EXPECT_STREQ("b\n", d.Root()[1].GetString());
+    d.Parse("[\"c\"]");
+    EXPECT_STREQ("c", d.Root()[0].GetString());
+}
+
+#ifdef __clang__
+RAPIDJSON_DIAG_POP
+#endif
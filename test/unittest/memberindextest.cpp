@@ -0,0 +1,202 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Member lookup through the hash index of large objects. Every lookup is
+// checked against a linear search over the members.
+
+#define RAPIDJSON_MEMBER_INDEX 1
+#define RAPIDJSON_NAMESPACE rapidjson_memberindex
+
+#include "unittest.h"
+
+#include "rapidjson/document.h"
+#include <cstdio>
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+using namespace rapidjson_memberindex;
+
+namespace {
+
+template <typename ValueType>
+typename ValueType::ConstMemberIterator LinearFindMember(const ValueType& object, const char* name) {
+    typename ValueType::ConstMemberIterator m = object.MemberBegin();
+    for (; m != object.MemberEnd(); ++m)
+        if (m->name.GetStringLength() == strlen(name) && memcmp(m->name.GetString(), name, strlen(name)) == 0)
+            break;
+    return m;
+}
+
+template <typename ValueType>
+void ExpectLookups(const ValueType& object, unsigned maxKey) {
+    char name[32];
+    for (unsigned i = 0; i < maxKey; i++) {
+        sprintf(name, "key%u", i);
+        EXPECT_TRUE(object.FindMember(name) == LinearFindMember(object, name)) << name;
+    }
+}
+
+template <typename ObjectType, typename Allocator>
+void AddMembers(ObjectType& object, unsigned first, unsigned last, Allocator& allocator) {
+    typedef typename ObjectType::ValueType ValueType;
+    char name[32];
+    for (unsigned i = first; i < last; i++) {
+        sprintf(name, "key%u", i);
+        object.AddMember(ValueType(name, allocator), ValueType(i), allocator);
+    }
+}
+
+} // namespace
+
+TEST(MemberIndex, Lookup) {
+    Document d;
+    d.SetObject();
+    AddMembers(d, 0, 1000, d.GetAllocator());
+
+    EXPECT_EQ(0u, d["key0"].GetUint());
+    EXPECT_EQ(999u, d["key999"].GetUint());
+    EXPECT_TRUE(d.HasMember("key500"));
+    EXPECT_FALSE(d.HasMember("key1000"));
+    EXPECT_FALSE(d.HasMember(""));
+    ExpectLookups(d, 1100);
+
+    // Member order is unchanged
+    unsigned i = 0;
+    for (Value::ConstMemberIterator m = d.MemberBegin(); m != d.MemberEnd(); ++m, ++i)
+        EXPECT_EQ(i, m->value.GetUint());
+}
+
+TEST(MemberIndex, Threshold) {
+    // Below, at and above the threshold, on either side of growing the capacity
+    for (unsigned count = 1; count < 4 * RAPIDJSON_MEMBER_INDEX_THRESHOLD; count++) {
+        Document d;
+        d.SetObject();
+        AddMembers(d, 0, count, d.GetAllocator());
+        ExpectLookups(d, count + 1);
+    }
+}
+
+TEST(MemberIndex, AddAfterLookup) {
+    Document d;
+    d.SetObject();
+    for (unsigned i = 0; i < 500; i += 10) {
+        AddMembers(d, i, i + 10, d.GetAllocator());
+        ExpectLookups(d, i + 20);
+    }
+
+    Value v(kObjectType);
+    v.MemberReserve(100, d.GetAllocator());
+    AddMembers(v, 0, 60, d.GetAllocator());
+    ExpectLookups(v, 60);
+    v.MemberReserve(1000, d.GetAllocator());
+    AddMembers(v, 60, 120, d.GetAllocator());
+    ExpectLookups(v, 130);
+}
+
+TEST(MemberIndex, DuplicateNames) {
+    Document d;
+    d.SetObject();
+    AddMembers(d, 0, 100, d.GetAllocator());
+    EXPECT_EQ(5u, d["key5"].GetUint());
+    d.AddMember("key5", 1005, d.GetAllocator());
+    AddMembers(d, 100, 200, d.GetAllocator());
+    EXPECT_EQ(5u, d["key5"].GetUint());
+
+    // The first one is found, as by the linear search
+    d.EraseMember(d.MemberBegin() + 5);
+    EXPECT_EQ(1005u, d["key5"].GetUint());
+    ExpectLookups(d, 210);
+}
+
+TEST(MemberIndex, Remove) {
+    Document d;
+    d.SetObject();
+    AddMembers(d, 0, 300, d.GetAllocator());
+    ExpectLookups(d, 300);
+
+    EXPECT_TRUE(d.RemoveMember("key10"));
+    EXPECT_FALSE(d.RemoveMember("key10"));
+    EXPECT_FALSE(d.HasMember("key10"));
+    EXPECT_EQ(299u, d["key299"].GetUint());
+    ExpectLookups(d, 300);
+
+    EXPECT_TRUE(d.EraseMember("key20"));
+    EXPECT_FALSE(d.HasMember("key20"));
+    ExpectLookups(d, 300);
+
+    d.EraseMember(d.MemberBegin() + 50, d.MemberBegin() + 150);
+    EXPECT_EQ(198u, d.MemberCount());
+    ExpectLookups(d, 300);
+
+    // Down to below the threshold, then back up
+    d.EraseMember(d.MemberBegin() + 1, d.MemberEnd());
+    ExpectLookups(d, 300);
+    AddMembers(d, 1000, 1100, d.GetAllocator());
+    ExpectLookups(d, 1200);
+
+    d.RemoveAllMembers();
+    EXPECT_FALSE(d.HasMember("key0"));
+    AddMembers(d, 0, 100, d.GetAllocator());
+    ExpectLookups(d, 110);
+}
+
+TEST(MemberIndex, ParseAndCopy) {
+    std::string json = "{";
+    char member[32];
+    for (unsigned i = 0; i < 200; i++) {
+        sprintf(member, "%s\"key%u\":%u", i ? "," : "", i, i);
+        json += member;
+    }
+    json += ",\"nested\":{\"a\":1}}";
+
+    Document d;
+    d.Parse(json.c_str());
+    ASSERT_FALSE(d.HasParseError());
+    ExpectLookups(d, 210);
+    EXPECT_EQ(1, d["nested"]["a"].GetInt());
+
+    Document copy;
+    copy.CopyFrom(d, copy.GetAllocator());
+    ExpectLookups(copy, 210);
+    EXPECT_TRUE(copy == d);
+
+    // Insitu strings and const lookups
+    std::vector<char> buffer(json.begin(), json.end());
+    buffer.push_back('\0');
+    Document insitu;
+    insitu.ParseInsitu(&buffer[0]);
+    const Document& c = insitu;
+    ExpectLookups(c, 210);
+    EXPECT_EQ(199u, c["key199"].GetUint());
+}
+
+TEST(MemberIndex, CrtAllocator) {
+    // Reallocation and freeing go through the system heap
+    typedef GenericValue<UTF8<>, CrtAllocator> CrtValue;
+    CrtAllocator allocator;
+    CrtValue v(kObjectType);
+    AddMembers(v, 0, 500, allocator);
+    ExpectLookups(v, 510);
+    CrtValue copy(v, allocator);
+    v.RemoveMember("key3");
+    ExpectLookups(v, 510);
+    ExpectLookups(copy, 510);
+}
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
@@ -17,6 +17,7 @@
 #include "rapidjson/ostreamwrapper.h"
 #include "rapidjson/encodedstream.h"
 #include "rapidjson/document.h"
+#include "rapidjson/writer.h"
 #include <sstream>
 #include <fstream>
 
@@ -37,6 +38,24 @@ static void TestStringStream() {
         EXPECT_EQ(s[i], oss.str()[i]);
 }
 
+TEST(OStreamWrapper, Writer) {
+    std::string str(1000, 'a');
+    for (size_t i = 0; i < str.size(); i += 37)
+        str[i] = '\"';
+    std::string expected = "[\"";
+    for (size_t i = 0; i < str.size(); i++)
+        expected += str[i] == '\"' ? "\\\"" : std::string(1, str[i]);
+    expected += "\"]";
+
+    std::ostringstream oss;
+    OStreamWrapper os(oss);
+    Writer<OStreamWrapper> writer(os);
+    writer.StartArray();
+    writer.String(str.c_str(), static_cast<SizeType>(str.size()));
+    writer.EndArray();
+    EXPECT_EQ(expected, oss.str());
+}
+
 TEST(OStreamWrapper, ostringstream) {
     TestStringStream<ostringstream>();
 }
@@ -0,0 +1,155 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+
+#include "rapidjson/parallelwriter.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/document.h"
+#include <limits>
+#include <string>
+
+using namespace rapidjson;
+
+namespace {
+
+// An array or object of count records, with nested values and strings to escape.
+void MakeDocument(Document& d, unsigned count, bool object) {
+    Document::AllocatorType& a = d.GetAllocator();
+    if (object)
+        d.SetObject();
+    else
+        d.SetArray();
+    for (unsigned i = 0; i < count; i++) {
+        Value record(kObjectType);
+        record.AddMember("id", i, a);
+        record.AddMember("ratio", i / 7.0, a);
+        record.AddMember("tags", Value(kArrayType).PushBack(i % 3 == 0, a).PushBack(Value(kArrayType), a), a);
+        record.AddMember("empty", Value(kObjectType), a);
+        record.AddMember("text", "line\n\"quoted\"", a);
+
+        if (object) {
+            const std::string name = "record " + std::to_string(i);
+            d.AddMember(Value(name.c_str(), a), record, a);
+        }
+        else if (i % 5 == 0)
+            d.PushBack(i, a);   // Elements of other types than the first
+        else
+            d.PushBack(record, a);
+    }
+}
+
+template <typename WriterType>
+std::string Write(const Document& d, unsigned threadCount, bool parallel) {
+    StringBuffer sb;
+    WriterType writer(sb);
+    if (parallel)
+        EXPECT_TRUE(AcceptParallel(d, writer, threadCount));
+    else
+        EXPECT_TRUE(d.Accept(writer));
+    EXPECT_TRUE(writer.IsComplete());
+    return sb.GetString();
+}
+
+template <typename WriterType>
+void TestAcceptParallel(unsigned count, bool object) {
+    Document d;
+    MakeDocument(d, count, object);
+    const std::string expected = Write<WriterType>(d, 0, false);
+    for (unsigned threadCount = 1; threadCount <= 8; threadCount++)
+        EXPECT_EQ(expected, Write<WriterType>(d, threadCount, true));
+}
+
+} // namespace
+
+TEST(AcceptParallel, Writer) {
+    for (unsigned count = 0; count < 1000; count = count * 3 + 7) {
+        TestAcceptParallel<Writer<StringBuffer> >(count, false);
+        TestAcceptParallel<Writer<StringBuffer> >(count, true);
+    }
+}
+
+TEST(AcceptParallel, PrettyWriter) {
+    for (unsigned count = 0; count < 1000; count = count * 3 + 7) {
+        TestAcceptParallel<PrettyWriter<StringBuffer> >(count, false);
+        TestAcceptParallel<PrettyWriter<StringBuffer> >(count, true);
+    }
+}
+
+TEST(AcceptParallel, PrettyWriterFormat) {
+    Document d;
+    MakeDocument(d, 500, false);
+    StringBuffer expected;
+    PrettyWriter<StringBuffer> serial(expected);
+    serial.SetIndent('\t', 1).SetFormatOptions(kFormatSingleLineArray);
+    serial.SetMaxDecimalPlaces(2);
+    d.Accept(serial);
+
+    StringBuffer sb;
+    PrettyWriter<StringBuffer> writer(sb);
+    writer.SetIndent('\t', 1).SetFormatOptions(kFormatSingleLineArray);
+    writer.SetMaxDecimalPlaces(2);
+    EXPECT_TRUE(AcceptParallel(d, writer, 4));
+    EXPECT_STREQ(expected.GetString(), sb.GetString());
+}
+
+TEST(AcceptParallel, UTF16) {
+    typedef GenericStringBuffer<UTF16<> > StringBufferType;
+    Document records;
+    MakeDocument(records, 500, true);
+    StringBuffer json;
+    Writer<StringBuffer> jsonWriter(json);
+    records.Accept(jsonWriter);
+    GenericDocument<UTF16<> > d;
+    d.Parse<kParseDefaultFlags, UTF8<> >(json.GetString());
+    ASSERT_TRUE(d.IsObject());
+
+    StringBufferType expected;
+    PrettyWriter<StringBufferType, UTF16<>, UTF16<> > serial(expected);
+    d.Accept(serial);
+
+    StringBufferType sb;
+    PrettyWriter<StringBufferType, UTF16<>, UTF16<> > writer(sb);
+    EXPECT_TRUE(AcceptParallel(d, writer, 4));
+    EXPECT_EQ(expected.GetLength(), sb.GetLength());
+    EXPECT_EQ(0, memcmp(expected.GetString(), sb.GetString(), expected.GetSize()));
+}
+
+TEST(AcceptParallel, Transcoding) {
+    // Written by the calling thread only, as the writer transcodes.
+    Document d;
+    MakeDocument(d, 500, false);
+    GenericStringBuffer<UTF16<> > expected;
+    Writer<GenericStringBuffer<UTF16<> >, UTF8<>, UTF16<> > serial(expected);
+    d.Accept(serial);
+
+    GenericStringBuffer<UTF16<> > sb;
+    Writer<GenericStringBuffer<UTF16<> >, UTF8<>, UTF16<> > writer(sb);
+    EXPECT_TRUE(AcceptParallel(d, writer, 4));
+    EXPECT_EQ(0, memcmp(expected.GetString(), sb.GetString(), expected.GetSize()));
+}
+
+TEST(AcceptParallel, Failure) {
+    Document d;
+    MakeDocument(d, 500, false);
+    d[400].SetDouble(std::numeric_limits<double>::quiet_NaN());
+    StringBuffer sb;
+    Writer<StringBuffer> writer(sb);
+    EXPECT_FALSE(AcceptParallel(d, writer, 4));
+    EXPECT_FALSE(writer.IsComplete());
+}
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
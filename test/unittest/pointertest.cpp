@@ -15,6 +15,8 @@
 #include "unittest.h"
 #include "rapidjson/pointer.h"
 #include "rapidjson/stringbuffer.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/writer.h"
 #include <sstream>
 
 using namespace rapidjson;
@@ -1527,3 +1529,111 @@ TEST(Pointer, Issue483) {
     value.SetString(mystr.c_str(), static_cast<SizeType>(mystr.length()), document.GetAllocator());
     myjson::Pointer(path.c_str()).Set(document, value, document.GetAllocator());
 }
+
+static const char kProjectionJson[] =
+"{"
+"  \"id\": 42, \"name\": \"x\\\"y\", \"skip\": {\"deep\": [1, 2, {\"a\": \"}\"}]},"
+"  \"user\": {\"name\": \"alice\", \"tags\": [\"a\", \"b\", \"c\"], \"age\": 30.5},"
+"  \"items\": [ {\"v\": 1}, 17, {\"v\": 3, \"w\": [true]}, {\"v\": 4} ],"
+"  \"scalar\": 1"
+"}";
+
+TEST(Pointer, ParseByPointers) {
+    const Pointer pointers[] = { Pointer("/id"), Pointer("/user/tags/1"), Pointer("/items/2/v"), Pointer("/missing/a"), Pointer("/scalar/a") };
+    Document d;
+    ParseResult r = ParseByPointers(d, kProjectionJson, pointers, sizeof(pointers) / sizeof(pointers[0]));
+    ASSERT_FALSE(r.IsError()) << r.Code() << " at " << r.Offset();
+
+    StringBuffer buffer;
+    Writer<StringBuffer> writer(buffer);
+    d.Accept(writer);
+    EXPECT_STREQ("{\"id\":42,\"user\":{\"tags\":[null,\"b\"]},\"items\":[null,null,{\"v\":3}]}", buffer.GetString());
+
+    // The pointers resolve as in the full document
+    Document full;
+    full.Parse(kProjectionJson);
+    for (size_t i = 0; i < 3; i++)
+        EXPECT_TRUE(*pointers[i].Get(d) == *pointers[i].Get(full));
+    EXPECT_TRUE(pointers[3].Get(d) == 0);
+    EXPECT_TRUE(pointers[4].Get(d) == 0);
+}
+
+TEST(Pointer, ParseByPointers_Subtrees) {
+    // Whole subtrees, overlapping pointers, and pointers matching several elements
+    const Pointer pointers[] = { Pointer("/user"), Pointer("/user/name"), Pointer("/items/0/v"), Pointer("/items/3/v"), Pointer("/items/0") };
+    Document d;
+    EXPECT_FALSE(ParseByPointers<kParseFullPrecisionFlag>(d, kProjectionJson, pointers, 5).IsError());
+
+    StringBuffer buffer;
+    Writer<StringBuffer> writer(buffer);
+    d.Accept(writer);
+    EXPECT_STREQ("{\"user\":{\"name\":\"alice\",\"tags\":[\"a\",\"b\",\"c\"],\"age\":30.5},\"items\":[{\"v\":1},null,null,{\"v\":4}]}", buffer.GetString());
+
+    // The root pointer selects everything
+    const Pointer root[] = { Pointer("/id"), Pointer("") };
+    Document full;
+    full.Parse(kProjectionJson);
+    EXPECT_FALSE(ParseByPointers(d, kProjectionJson, root, 2).IsError());
+    EXPECT_TRUE(d == full);
+
+    // No pointers, or a scalar root
+    EXPECT_FALSE(ParseByPointers(d, kProjectionJson, root, 0).IsError());
+    EXPECT_TRUE(d.IsObject());
+    EXPECT_EQ(0u, d.MemberCount());
+    EXPECT_FALSE(ParseByPointers(d, " \"abc\" ", pointers, 5).IsError());
+    EXPECT_TRUE(d.IsNull());
+}
+
+TEST(Pointer, ParseByPointers_Streams) {
+    const Pointer pointers[] = { Pointer("/user/age"), Pointer("/items/1") };
+
+    MemoryStream ms(kProjectionJson, sizeof(kProjectionJson) - 1);
+    EncodedInputStream<UTF8<>, MemoryStream> is(ms);
+    Document d;
+    EXPECT_FALSE(ParseStreamByPointers(d, is, pointers, 2).IsError());
+    EXPECT_EQ(30.5, d["user"]["age"].GetDouble());
+    EXPECT_EQ(17, d["items"][1].GetInt());
+
+    // Trailing commas and multiple roots
+    const char json[] = "{\"items\": [1, [2, 3,],], \"a\": {},} {}";
+    StringStream s(json);
+    EXPECT_FALSE(ParseStreamByPointers<kParseTrailingCommasFlag | kParseStopWhenDoneFlag>(d, s, pointers, 2).IsError());
+    EXPECT_EQ(2u, d["items"][1].Size());
+    EXPECT_STREQ(" {}", s.src_);
+
+    // UTF-16 document from UTF-8 text
+    typedef GenericDocument<UTF16<> > Document16;
+    typedef GenericPointer<Document16::ValueType> Pointer16;
+    const Pointer16 pointers16[] = { Pointer16(L"/user/name") };
+    Document16 d16;
+    ParseResult r = ParseByPointers<kParseDefaultFlags, UTF8<> >(d16, kProjectionJson, pointers16, 1);
+    EXPECT_FALSE(r.IsError());
+    EXPECT_EQ(0, StrCmp(L"alice", d16[L"user"][L"name"].GetString()));
+}
+
+TEST(Pointer, ParseByPointers_Error) {
+    const Pointer pointers[] = { Pointer("/a/b") };
+    Document d;
+    d.Parse("[1]");
+
+#define TEST_PROJECTION_ERROR(json, code, offset) \
+    { \
+        ParseResult r = ParseByPointers(d, json, pointers, 1); \
+        EXPECT_EQ(code, r.Code()) << json; \
+        EXPECT_EQ(offset, r.Offset()) << json; \
+        EXPECT_TRUE(d.IsArray()) << json; \
+    }
+
+    TEST_PROJECTION_ERROR("", kParseErrorDocumentEmpty, 0u);
+    TEST_PROJECTION_ERROR("{} x", kParseErrorDocumentRootNotSingular, 3u);
+    TEST_PROJECTION_ERROR("{1}", kParseErrorObjectMissName, 1u);
+    TEST_PROJECTION_ERROR("{\"a\" 1}", kParseErrorObjectMissColon, 5u);
+    TEST_PROJECTION_ERROR("{\"a\": {\"b\": 1 \"c\": 2}}", kParseErrorObjectMissCommaOrCurlyBracket, 14u);
+    TEST_PROJECTION_ERROR("{\"a\": {\"b\": tru}}", kParseErrorValueInvalid, 15u);
+    TEST_PROJECTION_ERROR("{\"x\": [1, 2}", kParseErrorArrayMissCommaOrSquareBracket, 11u);
+    TEST_PROJECTION_ERROR("{\"a\": [1 2]}", kParseErrorArrayMissCommaOrSquareBracket, 9u);
+    TEST_PROJECTION_ERROR("{\"x\": \"abc}", kParseErrorStringMissQuotationMark, 11u);
+    TEST_PROJECTION_ERROR("{\"a\\x\": 1}", kParseErrorStringEscapeInvalid, 3u);
+
+#undef TEST_PROJECTION_ERROR
+}
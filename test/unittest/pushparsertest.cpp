@@ -0,0 +1,218 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+
+#include "rapidjson/pushparser.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include <sstream>
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+using namespace rapidjson;
+
+namespace {
+
+struct PushEventHandler : BaseReaderHandler<UTF8<>, PushEventHandler> {
+    std::ostringstream log;
+
+    bool Null() { log << 'n'; return true; }
+    bool Bool(bool b) { log << (b ? 't' : 'f'); return true; }
+    bool Int(int i) { log << 'i' << i; return true; }
+    bool Uint(unsigned u) { log << 'u' << u; return true; }
+    bool Int64(int64_t i) { log << 'I' << i; return true; }
+    bool Uint64(uint64_t u) { log << 'U' << u; return true; }
+    bool Double(double d) { log << 'd' << d; return true; }
+    bool RawNumber(const char* str, SizeType length, bool) { log << 'r' << std::string(str, length); return true; }
+    bool String(const char* str, SizeType length, bool) { log << 's' << std::string(str, length) << '|'; return true; }
+    bool StartObject() { log << '{'; return true; }
+    bool Key(const char* str, SizeType length, bool) { log << 'k' << std::string(str, length) << '|'; return true; }
+    bool EndObject(SizeType c) { log << '}' << c; return true; }
+    bool StartArray() { log << '['; return true; }
+    bool EndArray(SizeType c) { log << ']' << c; return true; }
+};
+
+template <unsigned parseFlags>
+std::string ReaderLog(const std::string& json, ParseResult& result) {
+    PushEventHandler h;
+    Reader reader;
+    StringStream s(json.c_str());
+    result = reader.Parse<parseFlags | kParseIterativeFlag>(s, h);
+    return h.log.str();
+}
+
+template <unsigned parseFlags>
+std::string PushLog(const std::string& json, size_t chunkSize, ParseResult& result) {
+    PushEventHandler h;
+    PushParser parser;
+    for (size_t i = 0; i < json.size() && parser.Feed<parseFlags>(json.data() + i, std::min(chunkSize, json.size() - i), h); i += chunkSize)
+        ;
+    if (!parser.HasParseError())
+        parser.Finish<parseFlags>(h);
+    result = parser.GetParseResult();
+    return h.log.str();
+}
+
+// Every chunk size gives the events and result of the reader.
+template <unsigned parseFlags>
+void TestChunks(const std::string& json) {
+    ParseResult expected;
+    const std::string log = ReaderLog<parseFlags>(json, expected);
+    for (size_t chunkSize = 1; chunkSize <= json.size() + 1; chunkSize += chunkSize < 64 ? 1 : chunkSize / 8) {
+        ParseResult r;
+        EXPECT_EQ(log, PushLog<parseFlags>(json, chunkSize, r)) << json << " in chunks of " << chunkSize;
+        EXPECT_EQ(expected.Code(), r.Code()) << json << " in chunks of " << chunkSize;
+        EXPECT_EQ(expected.Offset(), r.Offset()) << json << " in chunks of " << chunkSize;
+    }
+}
+
+} // namespace
+
+TEST(PushParser, Chunks) {
+    const char* json =
+        "{ \"a\" : [ 1, -2, 3.25e2, 12345678901234, -12345678901234, 1e300, 0.000001 ],\n"
+        "  \"s\\\"t\" : \"x\\\\y\\u0041\\ud834\\udd1e\\n\\\"\", \"\":\"\",\r\n"
+        "\t\"t\": true, \"f\": false, \"n\": null, \"o\": {\"p\": {}, \"q\": []}}";
+    TestChunks<kParseDefaultFlags>(json);
+    TestChunks<kParseFullPrecisionFlag | kParseValidateEncodingFlag>(json);
+    TestChunks<kParseNumbersAsStringsFlag>(json);
+
+    TestChunks<kParseDefaultFlags>("[\"\xE4\xB8\xAD\xE6\x96\x87\", 1]");
+    TestChunks<kParseValidateEncodingFlag>("[\"\xE4\xB8\xAD\xE6\x96\x87\", 1]");
+    TestChunks<kParseTrailingCommasFlag>("{\"a\": [1, 2, ], \"b\": 3, }");
+    TestChunks<kParseNanAndInfFlag>("[NaN, -Infinity, Inf]");
+}
+
+TEST(PushParser, Root) {
+    TestChunks<kParseDefaultFlags>("123");
+    TestChunks<kParseDefaultFlags>("  -1.5e-3  ");
+    TestChunks<kParseDefaultFlags>("true");
+    TestChunks<kParseDefaultFlags>("null\n");
+    TestChunks<kParseDefaultFlags>("\"abc\\n\"");
+    TestChunks<kParseDefaultFlags>("[]");
+
+    // A number at the root is only complete at the end
+    PushEventHandler h;
+    PushParser parser;
+    EXPECT_TRUE(parser.Feed("12", 2, h));
+    EXPECT_TRUE(parser.Feed("34", 2, h));
+    EXPECT_EQ("", h.log.str());
+    EXPECT_EQ(4u, parser.PendingLength());
+    EXPECT_FALSE(parser.IsComplete());
+    EXPECT_TRUE(parser.Finish(h));
+    EXPECT_TRUE(parser.IsComplete());
+    EXPECT_EQ("u1234", h.log.str());
+}
+
+TEST(PushParser, Incremental) {
+    // Events come as soon as their tokens are complete
+    PushEventHandler h;
+    PushParser parser;
+    EXPECT_TRUE(parser.Feed("{\"ab", 4, h));
+    EXPECT_EQ("{", h.log.str());
+    EXPECT_TRUE(parser.Feed("c\": [12", 7, h));
+    EXPECT_EQ("{kabc|[", h.log.str());
+    EXPECT_TRUE(parser.Feed("3, \"x\\", 6, h));
+    EXPECT_EQ("{kabc|[u123", h.log.str());
+    EXPECT_EQ(3u, parser.PendingLength());
+    EXPECT_TRUE(parser.Feed("\"\"]", 3, h));
+    EXPECT_EQ("{kabc|[u123sx\"|]2", h.log.str());
+    EXPECT_FALSE(parser.IsComplete());
+    EXPECT_TRUE(parser.Feed("}  ", 3, h));
+    EXPECT_TRUE(parser.IsComplete());
+    EXPECT_TRUE(parser.Finish(h));
+    EXPECT_EQ("{kabc|[u123sx\"|]2}1", h.log.str());
+
+    // Long strings over many chunks
+    std::string json = "[\"";
+    for (int i = 0; i < 1000; i++)
+        json += i % 100 == 99 ? "\\\\" : "abcdefghij";
+    json += "\"]";
+    TestChunks<kParseDefaultFlags>(json);
+}
+
+TEST(PushParser, Error) {
+    TestChunks<kParseDefaultFlags>("");
+    TestChunks<kParseDefaultFlags>("   ");
+    TestChunks<kParseDefaultFlags>("[1, 2");
+    TestChunks<kParseDefaultFlags>("[1, 2,]");
+    TestChunks<kParseDefaultFlags>("{\"a\" 1}");
+    TestChunks<kParseDefaultFlags>("{\"a\": 1,}");
+    TestChunks<kParseDefaultFlags>("{\"a\": tru}");
+    TestChunks<kParseDefaultFlags>("[1.]");
+    TestChunks<kParseDefaultFlags>("[\"abc]");
+    TestChunks<kParseDefaultFlags>("[\"a\\x\"]");
+    TestChunks<kParseDefaultFlags>("[\"a\\ud800\"]");
+    TestChunks<kParseDefaultFlags>("[1] [2]");
+    TestChunks<kParseDefaultFlags>("12 3");
+    TestChunks<kParseValidateEncodingFlag>("[\"\xC0\xAF\"]");
+
+    // Nothing more is parsed after an error
+    PushEventHandler h;
+    PushParser parser;
+    EXPECT_TRUE(parser.Feed("[1 2", 4, h));
+    EXPECT_FALSE(parser.Feed("]", 1, h));
+    EXPECT_FALSE(parser.Feed("]", 1, h));
+    EXPECT_FALSE(parser.Finish(h));
+    EXPECT_EQ(kParseErrorArrayMissCommaOrSquareBracket, parser.GetParseErrorCode());
+    EXPECT_EQ(3u, parser.GetErrorOffset());
+    EXPECT_EQ("[u1", h.log.str());
+
+    // Start over
+    parser.Reset();
+    EXPECT_TRUE(parser.Feed("[3]", 3, h));
+    EXPECT_TRUE(parser.Finish(h));
+    EXPECT_EQ("[u1[u3]1", h.log.str());
+}
+
+TEST(PushParser, StopWhenDone) {
+    PushEventHandler h;
+    PushParser parser;
+    EXPECT_TRUE(parser.Feed<kParseStopWhenDoneFlag>("[1] [", 5, h));
+    EXPECT_TRUE(parser.IsComplete());
+    EXPECT_TRUE(parser.Feed<kParseStopWhenDoneFlag>("x", 1, h));
+    EXPECT_TRUE(parser.Finish<kParseStopWhenDoneFlag>(h));
+    EXPECT_EQ("[u1]1", h.log.str());
+}
+
+TEST(PushParser, Writer) {
+    const char json[] = "{\"hello\":\"world\",\"t\":true,\"f\":false,\"n\":null,\"i\":123,\"pi\":3.1416,\"a\":[1,2,3,4]}";
+    StringBuffer buffer;
+    Writer<StringBuffer> writer(buffer);
+    PushParser parser;
+    for (size_t i = 0; i + 1 < sizeof(json); i += 5)
+        EXPECT_TRUE(parser.Feed(json + i, std::min<size_t>(5, sizeof(json) - 1 - i), writer));
+    EXPECT_TRUE(parser.Finish(writer));
+    EXPECT_STREQ(json, buffer.GetString());
+}
+
+TEST(PushParser, UTF16) {
+    typedef GenericPushParser<UTF16<>, UTF8<> > PushParser16;
+    const wchar_t json[] = L"{\"a\": [\"\\u00e9\u4e2d\", 12]}";
+    PushParser16 parser;
+    PushEventHandler h;
+    for (size_t i = 0; i + 1 < sizeof(json) / sizeof(json[0]); i++)
+        EXPECT_TRUE(parser.Feed(json + i, 1, h));
+    EXPECT_TRUE(parser.Finish(h));
+    EXPECT_EQ("{ka|[s\xC3\xA9\xE4\xB8\xAD|u12]2}1", h.log.str());
+}
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
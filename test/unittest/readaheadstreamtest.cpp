@@ -0,0 +1,118 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "unittest.h"
+
+#include "rapidjson/readaheadstream.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+
+#include "rapidjson/document.h"
+#include "rapidjson/encodedstream.h"
+#include <sstream>
+#include <string>
+
+using namespace rapidjson;
+
+namespace {
+
+std::string MakeJson() {
+    std::string json = "[";
+    char item[64];
+    for (unsigned i = 0; i < 5000; i++) {
+        sprintf(item, "%s{\"id\":%u,\"s\":\"item %u\"}", i ? "," : "", i, i * 7);
+        json += item;
+    }
+    return json + "]";
+}
+
+template <typename Stream>
+void TestTake(Stream& s, const std::string& json) {
+    for (size_t i = 0; i < json.size(); i++) {
+        ASSERT_EQ(json[i], s.Peek());
+        ASSERT_EQ(i, s.Tell());
+        ASSERT_EQ(json[i], s.Take());
+    }
+    EXPECT_EQ(json.size(), s.Tell());
+    EXPECT_EQ('\0', s.Peek());
+    EXPECT_EQ('\0', s.Take());
+    EXPECT_EQ(json.size(), s.Tell());
+}
+
+} // namespace
+
+TEST(ReadAheadStream, File) {
+    const std::string json = MakeJson();
+    FILE* fp = tmpfile();
+    ASSERT_TRUE(fp != 0);
+    fwrite(json.data(), 1, json.size(), fp);
+
+    // Buffer sizes which do and do not divide the file
+    const size_t sizes[] = { 4, 5, 1000, json.size() / 4, json.size(), json.size() + 1 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (size_t count = 2; count <= 5; count++) {
+            rewind(fp);
+            FileReadAheadStream s(fp, sizes[i], count);
+            TestTake(s, json);
+        }
+    }
+
+    rewind(fp);
+    FileReadAheadStream s(fp);
+    Document d;
+    d.ParseStream(s);
+    EXPECT_FALSE(d.HasParseError());
+    EXPECT_EQ(5000u, d.Size());
+    fclose(fp);
+}
+
+TEST(ReadAheadStream, IStream) {
+    const std::string json = MakeJson();
+    for (size_t size = 4; size <= 65536; size *= 8) {
+        std::istringstream is(json);
+        IStreamReadAheadStream s(is, size, 3);
+        TestTake(s, json);
+    }
+
+    std::istringstream empty("");
+    IStreamReadAheadStream s(empty);
+    EXPECT_EQ('\0', s.Peek());
+    EXPECT_EQ(0u, s.Tell());
+    EXPECT_TRUE(s.Peek4() == 0);
+}
+
+TEST(ReadAheadStream, AutoUTF) {
+    std::istringstream is(std::string("\xEF\xBB\xBF[\"a\"]", 8));
+    IStreamReadAheadStream s(is, 8, 2);
+    AutoUTFInputStream<unsigned, IStreamReadAheadStream> eis(s);
+    EXPECT_TRUE(eis.HasBOM());
+    EXPECT_EQ(kUTF8, eis.GetType());
+    Document d;
+    d.ParseStream<0, AutoUTF<unsigned> >(eis);
+    EXPECT_FALSE(d.HasParseError());
+    EXPECT_STREQ("a", d[0].GetString());
+}
+
+TEST(ReadAheadStream, Stop) {
+    // Destroyed before the end, while the thread waits for a free buffer
+    const std::string json = MakeJson();
+    for (size_t n = 0; n < 100; n += 10) {
+        std::istringstream is(json);
+        IStreamReadAheadStream s(is, 16, 2);
+        for (size_t i = 0; i < n; i++)
+            EXPECT_EQ(json[i], s.Take());
+    }
+}
+
+#endif // RAPIDJSON_HAS_CXX11_THREADS
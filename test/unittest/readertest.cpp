@@ -184,6 +184,113 @@ TEST(Reader, ParseNumber_Integer) {
 #undef TEST_INTEGER
 }
 
+// Same as StringStream, but not contiguous as far as the reader can tell.
+struct CharByCharStream {
+    typedef char Ch;
+    CharByCharStream(const char* src) : s_(src) {}
+    Ch Peek() const { return s_.Peek(); }
+    Ch Take() { return s_.Take(); }
+    size_t Tell() const { return s_.Tell(); }
+    Ch* PutBegin() { RAPIDJSON_ASSERT(false); return 0; }
+    void Put(Ch) { RAPIDJSON_ASSERT(false); }
+    void Flush() { RAPIDJSON_ASSERT(false); }
+    size_t PutEnd(Ch*) { RAPIDJSON_ASSERT(false); return 0; }
+    StringStream s_;
+};
+
+struct ParseNumberDigits8Handler : BaseReaderHandler<UTF8<>, ParseNumberDigits8Handler> {
+    bool Default() { ADD_FAILURE(); return false; }
+    bool Int(int i) { return Int64(i); }
+    bool Uint(unsigned u) { return Uint64(u); }
+    bool Int64(int64_t i) { char buffer[32]; *internal::i64toa(i, buffer) = '\0'; actual_ = std::string("i:") + buffer; return true; }
+    bool Uint64(uint64_t u) { char buffer[32]; *internal::u64toa(u, buffer) = '\0'; actual_ = std::string("u:") + buffer; return true; }
+    bool Double(double d) { char buffer[32]; sprintf(buffer, "d:%.17g", d); actual_ = buffer; return true; }
+    bool RawNumber(const char* str, SizeType length, bool) { actual_ = "n:" + std::string(str, length); return true; }
+
+    std::string actual_;
+};
+
+template<unsigned parseFlags>
+static void TestParseNumberDigits8(const char* json, const char* expected) {
+    Reader reader;
+    {
+        // Exactly sized with the terminator, so that reading past it would be noticed by sanitizers
+        ParseNumberDigits8Handler h;
+        std::vector<char> buffer(json, json + strlen(json) + 1);
+        StringStream s(buffer.data());
+        EXPECT_TRUE(reader.Parse<parseFlags | kParseStopWhenDoneFlag>(s, h));
+        EXPECT_EQ(std::string(expected), h.actual_) << json;
+    }
+    {
+        ParseNumberDigits8Handler h;
+        std::string buffer(json);
+        InsituStringStream s(&buffer[0]);
+        EXPECT_TRUE(reader.Parse<parseFlags | kParseInsituFlag | kParseStopWhenDoneFlag>(s, h));
+        EXPECT_EQ(std::string(expected), h.actual_) << json;
+    }
+    {
+        // Exactly sized, so that reading past the end would be noticed by sanitizers
+        ParseNumberDigits8Handler h;
+        std::vector<char> buffer(json, json + strlen(json));
+        MemoryStream s(buffer.data(), buffer.size());
+        EXPECT_TRUE(reader.Parse<parseFlags | kParseStopWhenDoneFlag>(s, h));
+        EXPECT_EQ(std::string(expected), h.actual_) << json;
+    }
+    {
+        ParseNumberDigits8Handler h;
+        CharByCharStream s(json);
+        EXPECT_TRUE(reader.Parse<parseFlags | kParseStopWhenDoneFlag>(s, h));
+        EXPECT_EQ(std::string(expected), h.actual_) << json;
+    }
+}
+
+TEST(Reader, ParseNumber_Digits8) {
+    TestParseNumberDigits8<0>("1234567", "u:1234567");
+    TestParseNumberDigits8<0>("123456789", "u:123456789");
+    TestParseNumberDigits8<0>("1234567890", "u:1234567890");
+    TestParseNumberDigits8<0>("4294967295", "u:4294967295");
+    TestParseNumberDigits8<0>("4294967296", "u:4294967296");
+    TestParseNumberDigits8<0>("-2147483648", "i:-2147483648");
+    TestParseNumberDigits8<0>("-2147483649", "i:-2147483649");
+    TestParseNumberDigits8<0>("1234567890123456789", "u:1234567890123456789");
+    TestParseNumberDigits8<0>("18446744073709551615", "u:18446744073709551615");
+    TestParseNumberDigits8<0>("18446744073699999999", "u:18446744073699999999");    // largest SWAR step that fits
+    TestParseNumberDigits8<0>("18446744073709551616", "d:1.8446744073709552e+19");
+    TestParseNumberDigits8<0>("-9223372036854775808", "i:-9223372036854775808");
+    TestParseNumberDigits8<0>("-9223372036799999999", "i:-9223372036799999999");
+    TestParseNumberDigits8<0>("-9223372036854775809", "d:-9.2233720368547758e+18");
+    TestParseNumberDigits8<0>("12345678:", "u:12345678");                          // ':' is the digit after '9'
+    TestParseNumberDigits8<0>("12345678/", "u:12345678");                          // '/' is the digit before '0'
+    TestParseNumberDigits8<0>("12345678901 ", "u:12345678901");
+    TestParseNumberDigits8<0>("1234.5678901", "d:1234.5678901000001");
+    TestParseNumberDigits8<0>("3.14159265358979", "d:3.14159265358979");
+    TestParseNumberDigits8<0>("90071991.99999999", "d:90071991.999999985");
+    TestParseNumberDigits8<0>("90071992.99999999", "d:90071993");
+    TestParseNumberDigits8<0>("0.0000000012345678901", "d:1.2345678901000001e-09");
+    TestParseNumberDigits8<0>("123456781.25e-3", "d:123456.78125");                // exact, whatever the contraction to FMA
+    TestParseNumberDigits8<kParseFullPrecisionFlag>("1234567890.123456789012", "d:1234567890.1234567");
+    TestParseNumberDigits8<kParseFullPrecisionFlag>("-12345678901234567890123", "d:-1.2345678901234568e+22");
+    TestParseNumberDigits8<kParseNumbersAsStringsFlag>("-12345678901234567890.12345678901e+10", "n:-12345678901234567890.12345678901e+10");
+    TestParseNumberDigits8<kParseNumbersAsStringsFlag>("123456789", "n:123456789");
+
+    // Every split of the digits against the 8-digit steps, and every length
+    for (int length = 1; length <= 20; length++) {
+        char json[32];
+        uint64_t u = 0;
+        for (int i = 0; i < length; i++) {
+            json[i] = static_cast<char>('1' + (i * 7) % 9);
+            u = u * 10 + static_cast<unsigned>(json[i] - '0');
+        }
+        json[length] = '\0';
+        if (length < 20) {
+            char expected[32] = "u:";
+            *internal::u64toa(u, expected + 2) = '\0';
+            TestParseNumberDigits8<0>(json, expected);
+        }
+        TestParseNumberDigits8<kParseNumbersAsStringsFlag>(json, (std::string("n:") + json).c_str());
+    }
+}
+
 template<bool fullPrecision>
 static void TestParseDouble() {
 #define TEST_DOUBLE(fullPrecision, str, x) \
@@ -2198,4 +2305,179 @@ TEST(Reader, ParseNanAndInfinity) {
 #undef TEST_NAN_INF
 }
 
+template <typename InputStream>
+static void TestSkipValue(InputStream& is, const char* rest) {
+    Reader reader;
+    ParseResult r = reader.SkipValue(is);
+    EXPECT_FALSE(r.IsError()) << r.Code() << " at " << r.Offset();
+    std::string s;
+    while (is.Peek() != '\0')
+        s += is.Take();
+    EXPECT_STREQ(rest, s.c_str());
+}
+
+static void TestSkipValue(const char* json, const char* rest) {
+    StringStream s(json);
+    TestSkipValue(s, rest);
+    MemoryStream ms(json, strlen(json));
+    EncodedInputStream<UTF8<>, MemoryStream> es(ms);
+    TestSkipValue(es, rest);
+}
+
+TEST(Reader, SkipValue) {
+    TestSkipValue("null", "");
+    TestSkipValue(" 123.5e-3 ,1", " ,1");
+    TestSkipValue("-Infinity]", "]");
+    TestSkipValue("\"abc\\\"def\\\\\" , 1", " , 1");
+    TestSkipValue("\"\\u0000\"x", "x");
+    TestSkipValue("[]]", "]");
+    TestSkipValue("{}}", "}");
+    TestSkipValue("{\"a\":[1,{\"b\":\"]}\"},[[]],\"}\"],\"c\":{}} {}", " {}");
+    TestSkipValue("[ 1 , 2 ,\n3 ]\t,", "\t,");
+
+    // Strings long enough for the SIMD scan
+    std::string json = "[\"";
+    for (int i = 0; i < 100; i++)
+        json += i % 10 == 9 ? "\\\"" : "abcdefghij";
+    json += "\", true], 1";
+    TestSkipValue(json.c_str(), ", 1");
+
+    // Only the structure is checked
+    TestSkipValue("[nul, 1.2.3, \"\\x\", {\"a\" 1}]", "");
+}
+
+static void TestSkipValueError(const char* json, ParseErrorCode code, size_t offset) {
+    Reader reader;
+    StringStream s(json);
+    ParseResult r = reader.SkipValue(s);
+    EXPECT_EQ(code, r.Code()) << json;
+    EXPECT_EQ(offset, r.Offset()) << json;
+}
+
+TEST(Reader, SkipValue_Error) {
+    TestSkipValueError("", kParseErrorValueInvalid, 0);
+    TestSkipValueError("  ]", kParseErrorValueInvalid, 2);
+    TestSkipValueError(",", kParseErrorValueInvalid, 0);
+    TestSkipValueError("\"abc", kParseErrorStringMissQuotationMark, 4);
+    TestSkipValueError("\"abc\\", kParseErrorStringMissQuotationMark, 5);
+    TestSkipValueError("[1, 2", kParseErrorArrayMissCommaOrSquareBracket, 5);
+    TestSkipValueError("{\"a\": [1}", kParseErrorArrayMissCommaOrSquareBracket, 8);
+    TestSkipValueError("[{\"a\": 1]", kParseErrorObjectMissCommaOrCurlyBracket, 8);
+    TestSkipValueError("{\"a\": {", kParseErrorObjectMissCommaOrCurlyBracket, 7);
+}
+
+// Skips the values of keys starting with "skip", and the objects and arrays at skipDepth.
+struct SkipValueHandler : BaseReaderHandler<UTF8<>, SkipValueHandler> {
+    explicit SkipValueHandler(unsigned skipDepth = 0) : log(), depth(0), skipDepth(skipDepth) {}
+
+    bool Null() { log << 'n'; return true; }
+    bool Bool(bool b) { log << (b ? 't' : 'f'); return true; }
+    bool Int(int i) { log << 'i' << i; return true; }
+    bool Uint(unsigned u) { log << 'u' << u; return true; }
+    bool String(const char* str, SizeType length, bool) { log << 's' << std::string(str, length) << '|'; return true; }
+    HandlerResult StartObject() { log << '{'; return Start(); }
+    HandlerResult Key(const char* str, SizeType length, bool) {
+        log << 'k' << std::string(str, length) << '|';
+        return std::string(str, length).compare(0, 4, "skip") == 0 ? kHandlerSkipValue : kHandlerContinue;
+    }
+    bool EndObject(SizeType c) { log << '}' << c; depth--; return true; }
+    HandlerResult StartArray() { log << '['; return Start(); }
+    bool EndArray(SizeType c) { log << ']' << c; depth--; return true; }
+
+    HandlerResult Start() {
+        if (++depth != skipDepth)
+            return kHandlerContinue;
+        log << '~';
+        depth--;
+        return kHandlerSkipValue;
+    }
+
+    std::ostringstream log;
+    unsigned depth;
+    unsigned skipDepth;
+};
+
+template <unsigned parseFlags>
+static std::string TestHandlerSkip(const char* json, unsigned skipDepth = 0) {
+    SkipValueHandler h(skipDepth);
+    Reader reader;
+    ParseResult r;
+    if (parseFlags & kParseInsituFlag) {
+        std::string buffer(json);
+        InsituStringStream s(&buffer[0]);
+        r = reader.Parse<parseFlags>(s, h);
+    }
+    else {
+        StringStream s(json);
+        r = reader.Parse<parseFlags>(s, h);
+    }
+    EXPECT_FALSE(r.IsError()) << json << ": " << r.Code() << " at " << r.Offset();
+    return h.log.str();
+}
+
+template <unsigned parseFlags>
+static void TestHandlerSkipFlags() {
+    const char* json = "{\"a\": 1, \"skip1\": {\"x\": [1, \"]\", {}]}, \"b\": [\"c\", {\"skip2\": \"d\\\"\", \"e\": null}],"
+                       " \"skip3\": -1.5e3, \"f\": {\"g\": [true, [2]]}}";
+    EXPECT_EQ("{ka|u1kskip1|kb|[sc|{kskip2|ke|n}2]2kskip3|kf|{kg|[t[u2]1]2}1}5", TestHandlerSkip<parseFlags>(json));
+    EXPECT_EQ("{ka|u1kskip1|kb|[~kskip3|kf|{~}5", TestHandlerSkip<parseFlags>(json, 2));
+    EXPECT_EQ("{ka|u1kskip1|kb|[sc|{~]2kskip3|kf|{kg|[~}1}5", TestHandlerSkip<parseFlags>(json, 3));
+    EXPECT_EQ("{~", TestHandlerSkip<parseFlags>(json, 1));
+    EXPECT_EQ("[~", TestHandlerSkip<parseFlags>("[[1, {\"a\": 2}], 3]", 1));
+    EXPECT_EQ("[[~{~]2", TestHandlerSkip<parseFlags>("[[1, {\"a\": 2}], {}]", 2));
+    EXPECT_EQ("{kskip|}1", TestHandlerSkip<parseFlags>("{\"skip\":\"\\u0041\"}"));
+}
+
+TEST(Reader, HandlerSkip) {
+    TestHandlerSkipFlags<kParseDefaultFlags>();
+    TestHandlerSkipFlags<kParseInsituFlag>();
+    TestHandlerSkipFlags<kParseIterativeFlag>();
+    TestHandlerSkipFlags<kParseValidateEncodingFlag | kParseFullPrecisionFlag>();
+}
+
+TEST(Reader, HandlerSkip_Comments) {
+    const char* json = "{\"skip\": /* ] */ [1 /* } */, // ]\n {\"a\":\"/*\"}] /* { */ , \"b\": [ /* , */ 2, 3 ]}";
+    EXPECT_EQ("{kskip|kb|[~}2", TestHandlerSkip<kParseCommentsFlag>(json, 2));
+    EXPECT_EQ("{kskip|kb|[~}2", TestHandlerSkip<kParseCommentsFlag | kParseIterativeFlag>(json, 2));
+}
+
+TEST(Reader, HandlerSkip_StopWhenDone) {
+    SkipValueHandler h(1);
+    Reader reader;
+    StringStream s("[1, [2]] [3]");
+    EXPECT_FALSE(reader.Parse<kParseStopWhenDoneFlag>(s, h).IsError());
+    EXPECT_EQ(8u, s.Tell());
+    StringStream s2("[1, [2]] [3]");
+    EXPECT_FALSE(reader.Parse<kParseStopWhenDoneFlag | kParseIterativeFlag>(s2, h).IsError());
+    EXPECT_EQ(8u, s2.Tell());
+    EXPECT_EQ("[~[~", h.log.str());
+}
+
+template <unsigned parseFlags>
+static void TestHandlerSkipError(const char* json, unsigned skipDepth, ParseErrorCode code, size_t offset) {
+    SkipValueHandler h(skipDepth);
+    Reader reader;
+    StringStream s(json);
+    ParseResult r = reader.Parse<parseFlags>(s, h);
+    EXPECT_EQ(code, r.Code()) << json;
+    EXPECT_EQ(offset, r.Offset()) << json;
+}
+
+TEST(Reader, HandlerSkip_Error) {
+#define TEST_SKIP_ERROR(json, skipDepth, code, offset) \
+    TestHandlerSkipError<kParseDefaultFlags>(json, skipDepth, code, offset); \
+    TestHandlerSkipError<kParseIterativeFlag>(json, skipDepth, code, offset)
+
+    TEST_SKIP_ERROR("{\"skip\" 1}", 0, kParseErrorObjectMissColon, 8u);
+    TEST_SKIP_ERROR("{\"skip\": }", 0, kParseErrorValueInvalid, 9u);
+    TEST_SKIP_ERROR("{\"skip\": [1}", 0, kParseErrorArrayMissCommaOrSquareBracket, 11u);
+    TEST_SKIP_ERROR("{\"skip\": \"abc", 0, kParseErrorStringMissQuotationMark, 13u);
+    TEST_SKIP_ERROR("{\"skip\": 1 2}", 0, kParseErrorObjectMissCommaOrCurlyBracket, 11u);
+    TEST_SKIP_ERROR("[{\"a\": [}]", 2, kParseErrorArrayMissCommaOrSquareBracket, 8u);
+    TEST_SKIP_ERROR("[[1, 2]", 2, kParseErrorArrayMissCommaOrSquareBracket, 7u);
+    TEST_SKIP_ERROR("[1] 2", 1, kParseErrorDocumentRootNotSingular, 4u);
+
+#undef TEST_SKIP_ERROR
+}
+
 RAPIDJSON_DIAG_POP
@@ -0,0 +1,338 @@
+// Tencent is pleased to support the open source community by making RapidJSON available.
+//
+// Copyright (C) 2015 THL A29 Limited, a Tencent company, and Milo Yip. All rights reserved.
+//
+// Licensed under the MIT License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// http://opensource.org/licenses/MIT
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+// Run time kernel selection. Every kernel family supported by the host is
+// forced in turn and checked against the portable kernels.
+
+#define RAPIDJSON_SIMD_DISPATCH
+#define RAPIDJSON_NAMESPACE rapidjson_dispatch
+
+#include "unittest.h"
+
+#include "rapidjson/reader.h"
+#include "rapidjson/writer.h"
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+#include <thread>
+#include <vector>
+#endif
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_PUSH
+RAPIDJSON_DIAG_OFF(effc++)
+#endif
+
+using namespace rapidjson_dispatch;
+
+#ifdef RAPIDJSON_SIMD_DISPATCH
+
+using namespace rapidjson_dispatch::internal;
+
+namespace {
+
+// Restores the detected kernel family when a test ends.
+class SimdLevelScope {
+public:
+    SimdLevelScope() {}
+    ~SimdLevelScope() { SetSimdLevel(DetectSimdLevel()); }
+};
+
+void FillKernelInput(char* buffer, size_t length, size_t step, bool whitespace) {
+    for (size_t i = 0; i < length; i++)
+        buffer[i] = whitespace ? " \t\r\n"[i % 4] : "ABCD\x80\xFF"[i % 6];
+    for (size_t i = step; i < length; i += step + 1)
+        buffer[i] = whitespace ? 'X' : "\"\\\n"[i % 3];
+    buffer[length] = '\0';
+}
+
+// Well-formed one- to four-byte sequences, with an ill-formed or special one at every step + 1 bytes.
+void FillUtf8Input(char* buffer, size_t length, size_t step) {
+    static const char* const valid[] = { "a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xEF\xBF\xBF", "\xF4\x8F\xBF\xBF" };
+    static const char* const invalid[] = { "\xFF", "\xC0\xAF", "\x80", "\xED\xA0\x80", "\xE0\x9F\xBF", "\xF4\x90\x80\x80", "\xE2\x82", "\xF0\x9F\x98", "\"", "\\", "\n" };
+    size_t i = 0, n = 0;
+    while (i < length) {
+        const char* s = (step != 0 && n % step == step - 1) ? invalid[(n / step) % 11] : valid[n % 6];
+        for (; *s && i < length; s++)
+            buffer[i++] = *s;
+        n++;
+    }
+    buffer[length] = '\0';
+}
+
+// UTF-16 or UTF-32 units, with '"', '\\', a control character or a non-ASCII unit at every step + 1 units.
+template <typename T>
+void FillWideInput(T* buffer, size_t length, size_t step) {
+    static const uint32_t special[] = { '\"', '\\', '\n', 0x1F, 0x80, 0xE9, 0x4E2D, 0xD800, 0xFFFF };
+    for (size_t i = 0; i < length; i++)
+        buffer[i] = static_cast<T>('A' + i % 26);
+    for (size_t i = step; i < length; i += step + 1)
+        buffer[i] = static_cast<T>(special[i % 9]);
+}
+
+// The kernel scans whole vectors, then the units left are scanned one by one.
+template <typename T>
+const T* ScanWide(size_t (*kernel)(const void*, size_t, uint32_t), const T* p, const T* end, uint32_t highMask) {
+    p += kernel(p, static_cast<size_t>(end - p), highMask);
+    while (p != end && *p != '\"' && *p != '\\' && *p >= 0x20 && (*p & highMask) == 0)
+        ++p;
+    return p;
+}
+
+} // namespace
+
+TEST(SIMD, Dispatch_Level) {
+    SimdLevelScope scope;
+    const SimdLevel detected = DetectSimdLevel();
+    EXPECT_EQ(detected, GetSimdLevel());
+    EXPECT_TRUE(SetSimdLevel(kSimdScalar));
+    EXPECT_EQ(kSimdScalar, GetSimdLevel());
+    EXPECT_TRUE(SetSimdLevel(detected));
+    EXPECT_EQ(detected, GetSimdLevel());
+    EXPECT_STREQ("Scalar", GetSimdLevelName(kSimdScalar));
+    EXPECT_STREQ("SSE2", GetSimdLevelName(kSimdSSE2));
+    EXPECT_STREQ("AVX-512BW", GetSimdLevelName(kSimdAVX512BW));
+}
+
+TEST(SIMD, Dispatch_Kernels) {
+    SimdLevelScope scope;
+    char buffer[256 + 64 + 1];
+    for (int level = kSimdScalar; level <= DetectSimdLevel(); level++) {
+        ASSERT_TRUE(SetSimdLevel(static_cast<SimdLevel>(level)));
+        const SimdKernels& k = SimdDispatch<>::Kernels();
+        for (size_t offset = 0; offset < 64; offset++) {
+            for (size_t step = 0; step < 80; step += 3) {
+                char* p = buffer + offset;
+                const size_t length = 256 - offset % 7;
+                const char* end = p + length;
+
+                FillKernelInput(p, length, step, true);
+                EXPECT_EQ(SkipWhitespace_Scalar(p), k.skipWhitespace(p));
+                EXPECT_EQ(SkipWhitespace_Scalar(p, end), k.skipWhitespaceRange(p, end));
+                EXPECT_EQ(SkipWhitespace_Scalar(p, p + step / 2), k.skipWhitespaceRange(p, p + step / 2));
+
+                FillKernelInput(p, length, step, false);
+                EXPECT_EQ(ScanUnescaped_Scalar(p), k.scanUnescaped(p));
+                EXPECT_EQ(ScanUnescaped_Scalar(p, end), k.scanUnescapedRange(p, end));
+                EXPECT_EQ(ScanUnescaped_Scalar(p, p + step / 2), k.scanUnescapedRange(p, p + step / 2));
+            }
+        }
+    }
+}
+
+TEST(SIMD, Dispatch_WideKernels) {
+    SimdLevelScope scope;
+    uint16_t buffer16[256 + 64];
+    uint32_t buffer32[256 + 64];
+    for (int level = kSimdScalar; level <= DetectSimdLevel(); level++) {
+        ASSERT_TRUE(SetSimdLevel(static_cast<SimdLevel>(level)));
+        const SimdKernels& k = SimdDispatch<>::Kernels();
+        for (size_t offset = 0; offset < 8; offset++) {
+            for (size_t step = 0; step < 80; step += 3) {
+                for (uint32_t highMask = 0; highMask <= 1; highMask++) {
+                    const size_t length = 256 - offset % 7;
+                    uint16_t* p16 = buffer16 + offset;
+                    FillWideInput(p16, length, step);
+                    EXPECT_EQ(ScanWide(&ScanUnescapedWide_Scalar, p16, p16 + length, highMask ? 0xFF80u : 0u), ScanWide(k.scanUnescaped16, p16, p16 + length, highMask ? 0xFF80u : 0u));
+                    EXPECT_EQ(ScanWide(&ScanUnescapedWide_Scalar, p16, p16 + step / 2, 0u), ScanWide(k.scanUnescaped16, p16, p16 + step / 2, 0u));
+
+                    uint32_t* p32 = buffer32 + offset;
+                    FillWideInput(p32, length, step);
+                    EXPECT_EQ(ScanWide(&ScanUnescapedWide_Scalar, p32, p32 + length, highMask ? 0xFFFFFF80u : 0u), ScanWide(k.scanUnescaped32, p32, p32 + length, highMask ? 0xFFFFFF80u : 0u));
+                    EXPECT_EQ(ScanWide(&ScanUnescapedWide_Scalar, p32, p32 + step / 2, 0u), ScanWide(k.scanUnescaped32, p32, p32 + step / 2, 0u));
+                }
+            }
+        }
+    }
+}
+
+TEST(SIMD, Dispatch_ValidateKernel) {
+    SimdLevelScope scope;
+    char buffer[256 + 64 + 1];
+    for (int level = kSimdScalar; level <= DetectSimdLevel(); level++) {
+        ASSERT_TRUE(SetSimdLevel(static_cast<SimdLevel>(level)));
+        const SimdKernels& k = SimdDispatch<>::Kernels();
+        for (size_t offset = 0; offset < 64; offset++) {
+            for (size_t step = 0; step < 120; step++) {
+                char* p = buffer + offset;
+                FillUtf8Input(p, 256 - offset % 5, step);
+                EXPECT_EQ(ScanValidUnescaped_Scalar(p), k.scanValidUnescaped(p));
+                EXPECT_EQ(ScanValidUnescaped_Scalar(p + 1), k.scanValidUnescaped(p + 1));
+                for (size_t length = 0; length < 200; length += 1 + length / 8)
+                    EXPECT_EQ(ScanValidUnescaped_Scalar(p, p + length), k.scanValidUnescapedRange(p, p + length));
+            }
+        }
+    }
+}
+
+TEST(SIMD, Dispatch_ValidateEncoding) {
+    SimdLevelScope scope;
+    char buffer[256 + 1];
+    for (size_t step = 0; step < 120; step++) {
+        FillUtf8Input(buffer, 256, step);
+        std::string json = "[\"";
+        json.append(buffer, 200 - step % 7);
+        json += "\"]";
+
+        // Reference: per code point validation by Transcoder
+        Reader reader;
+        BaseReaderHandler<> h;
+        MemoryStream ms(json.c_str(), json.size());
+        EncodedInputStream<UTF8<>, MemoryStream> es(ms);
+        reader.Parse<kParseValidateEncodingFlag>(es, h);
+        const ParseErrorCode expectedCode = reader.GetParseErrorCode();
+        const size_t expectedOffset = reader.GetErrorOffset();
+
+        for (int level = kSimdScalar; level <= DetectSimdLevel(); level++) {
+            ASSERT_TRUE(SetSimdLevel(static_cast<SimdLevel>(level)));
+
+            StringStream s(json.c_str());
+            reader.Parse<kParseValidateEncodingFlag>(s, h);
+            EXPECT_EQ(expectedCode, reader.GetParseErrorCode());
+            EXPECT_EQ(expectedOffset, reader.GetErrorOffset());
+
+            std::string copy = json;
+            InsituStringStream is(&copy[0]);
+            reader.Parse<kParseValidateEncodingFlag | kParseInsituFlag>(is, h);
+            EXPECT_EQ(expectedCode, reader.GetParseErrorCode());
+            EXPECT_EQ(expectedOffset, reader.GetErrorOffset());
+        }
+    }
+}
+
+TEST(SIMD, Dispatch_ReaderWriter) {
+    SimdLevelScope scope;
+    std::string json = "[";
+    for (size_t i = 0; i < 100; i++) {
+        if (i != 0)
+            json += ",\n\t";
+        json.append(i, ' ');
+        json += "{\"key\": \"";
+        json.append(i, 'a' + static_cast<char>(i % 26));
+        json += (i % 2) ? "\\n\\\"" : "\\u00e9";
+        json.append(i * 3, 'Z');
+        json += "\"}";
+    }
+    json += "\r\n]";
+
+    std::string expected;
+    for (int level = kSimdScalar; level <= DetectSimdLevel(); level++) {
+        ASSERT_TRUE(SetSimdLevel(static_cast<SimdLevel>(level)));
+
+        Reader reader;
+        StringBuffer sb;
+        Writer<StringBuffer> writer(sb);
+        StringStream s(json.c_str());
+        EXPECT_TRUE(reader.Parse(s, writer));
+        if (level == kSimdScalar)
+            expected = sb.GetString();
+        EXPECT_EQ(expected, sb.GetString());
+
+        std::string copy = json;
+        StringBuffer sb2;
+        Writer<StringBuffer> writer2(sb2);
+        InsituStringStream is(&copy[0]);
+        EXPECT_TRUE(reader.Parse<kParseInsituFlag>(is, writer2));
+        EXPECT_EQ(expected, sb2.GetString());
+
+        MemoryStream ms(json.c_str(), json.size());
+        EncodedInputStream<UTF8<>, MemoryStream> es(ms);
+        StringBuffer sb3;
+        Writer<StringBuffer> writer3(sb3);
+        EXPECT_TRUE(reader.Parse(es, writer3));
+        EXPECT_EQ(expected, sb3.GetString());
+    }
+}
+
+TEST(SIMD, Dispatch_WriterEncodings) {
+    SimdLevelScope scope;
+    char utf8[256 + 1];
+    uint16_t utf16[256];
+    uint32_t utf32[256];
+    for (size_t step = 0; step < 120; step += 7) {
+        FillUtf8Input(utf8, 256, step);
+        FillWideInput(utf16, 256, step);
+        FillWideInput(utf32, 256, step);
+
+        std::string expected, expectedValid;
+        std::basic_string<uint16_t> expected16, expected16Valid;
+        std::basic_string<uint32_t> expected32;
+        for (int level = kSimdScalar; level <= DetectSimdLevel(); level++) {
+            ASSERT_TRUE(SetSimdLevel(static_cast<SimdLevel>(level)));
+
+            StringBuffer sb;
+            Writer<StringBuffer> writer(sb);
+            writer.String(utf8, 256);
+            StringBuffer sb2;
+            Writer<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteValidateEncodingFlag> writer2(sb2);
+            const bool valid = writer2.String(utf8, 256);
+
+            GenericStringBuffer<UTF16<uint16_t> > sb3;
+            Writer<GenericStringBuffer<UTF16<uint16_t> >, UTF16<uint16_t>, UTF16<uint16_t> > writer3(sb3);
+            writer3.String(utf16, 256);
+            GenericStringBuffer<UTF16<uint16_t> > sb4;
+            Writer<GenericStringBuffer<UTF16<uint16_t> >, UTF16<uint16_t>, UTF16<uint16_t>, CrtAllocator, kWriteValidateEncodingFlag> writer4(sb4);
+            const bool valid16 = writer4.String(utf16, 256);
+
+            GenericStringBuffer<UTF32<uint32_t> > sb5;
+            Writer<GenericStringBuffer<UTF32<uint32_t> >, UTF32<uint32_t>, UTF32<uint32_t> > writer5(sb5);
+            writer5.String(utf32, 256);
+
+            if (level == kSimdScalar) {
+                expected = sb.GetString();
+                expectedValid = valid ? sb2.GetString() : "";
+                expected16 = sb3.GetString();
+                expected16Valid = valid16 ? sb4.GetString() : std::basic_string<uint16_t>();
+                expected32 = sb5.GetString();
+            }
+            EXPECT_EQ(expected, sb.GetString());
+            EXPECT_EQ(expectedValid, valid ? sb2.GetString() : "");
+            EXPECT_TRUE(expected16 == sb3.GetString());
+            EXPECT_TRUE(expected16Valid == (valid16 ? sb4.GetString() : std::basic_string<uint16_t>()));
+            EXPECT_TRUE(expected32 == sb5.GetString());
+        }
+    }
+}
+
+#if RAPIDJSON_HAS_CXX11_THREADS
+TEST(SIMD, Dispatch_ConcurrentFirstCall) {
+    SimdLevelScope scope;
+    std::string json = "[";
+    for (size_t i = 0; i < 200; i++)
+        json += "  \"\xE4\xB8\xAD\xE6\x96\x87 text\",\n\t";
+    json += "0]";
+
+    // Several threads parse while the table is still the resolver's, as before the first call.
+    SimdDispatch<>::current.store(&SimdDispatch<>::resolver);
+    std::vector<std::thread> threads;
+    bool parsed[4] = {};
+    for (size_t i = 0; i < 4; i++)
+        threads.push_back(std::thread([&json, &parsed, i]() {
+            Reader reader;
+            BaseReaderHandler<> h;
+            StringStream s(json.c_str());
+            parsed[i] = !reader.Parse<kParseValidateEncodingFlag>(s, h).IsError();
+        }));
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    for (size_t i = 0; i < 4; i++)
+        EXPECT_TRUE(parsed[i]);
+    EXPECT_EQ(DetectSimdLevel(), GetSimdLevel());
+}
+#endif
+
+#endif // RAPIDJSON_SIMD_DISPATCH
+
+#ifdef __GNUC__
+RAPIDJSON_DIAG_POP
+#endif
@@ -15,9 +15,13 @@
 // Since Travis CI installs old Valgrind 3.7.0, which fails with some SSE4.2
 // The unit tests prefix with SIMD should be skipped by Valgrind test
 
-// __SSE2__ and __SSE4_2__ are recognized by gcc, clang, and the Intel compiler.
-// We use -march=native with gmake to enable -msse2 and -msse4.2, if supported.
-#if defined(__SSE4_2__)
+// __SSE2__, __SSE4_2__, __AVX2__ and __AVX512BW__ are recognized by gcc, clang, and the Intel compiler.
+// We use -march=native with gmake to enable -msse2, -msse4.2, -mavx2 and -mavx512bw, if supported.
+#if defined(__AVX512BW__)
+#  define RAPIDJSON_AVX512
+#elif defined(__AVX2__)
+#  define RAPIDJSON_AVX2
+#elif defined(__SSE4_2__)
 #  define RAPIDJSON_SSE42
 #elif defined(__SSE2__)
 #  define RAPIDJSON_SSE2
@@ -31,6 +35,14 @@
 
 #include "rapidjson/reader.h"
 #include "rapidjson/writer.h"
+#include "rapidjson/encodedstream.h"
+#include "rapidjson/memorystream.h"
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #ifdef __GNUC__
 RAPIDJSON_DIAG_PUSH
@@ -39,7 +51,11 @@ RAPIDJSON_DIAG_OFF(effc++)
 
 using namespace rapidjson_simd;
 
-#ifdef RAPIDJSON_SSE2
+#ifdef RAPIDJSON_AVX512
+#define SIMD_SUFFIX(name) name##_AVX512
+#elif defined(RAPIDJSON_AVX2)
+#define SIMD_SUFFIX(name) name##_AVX2
+#elif defined(RAPIDJSON_SSE2)
 #define SIMD_SUFFIX(name) name##_SSE2
 #elif defined(RAPIDJSON_SSE42)
 #define SIMD_SUFFIX(name) name##_SSE42
@@ -109,11 +125,11 @@ struct ScanCopyUnescapedStringHandler : BaseReaderHandler<UTF8<>, ScanCopyUnesca
 
 template <unsigned parseFlags, typename StreamType>
 void TestScanCopyUnescapedString() {
-    char buffer[1024u + 5 + 32];
-    char backup[1024u + 5 + 32];
+    char buffer[1024u + 5 + 64];
+    char backup[1024u + 5 + 64];
 
     // Test "ABCDABCD...\\"
-    for (size_t offset = 0; offset < 32; offset++) {
+    for (size_t offset = 0; offset < 64; offset++) {
         for (size_t step = 0; step < 1024; step++) {
             char* json = buffer + offset;
             char *p = json;
@@ -137,7 +153,7 @@ void TestScanCopyUnescapedString() {
     }
 
     // Test "\\ABCDABCD..."
-    for (size_t offset = 0; offset < 32; offset++) {
+    for (size_t offset = 0; offset < 64; offset++) {
         for (size_t step = 0; step < 1024; step++) {
             char* json = buffer + offset;
             char *p = json;
@@ -167,8 +183,8 @@ TEST(SIMD, SIMD_SUFFIX(ScanCopyUnescapedString)) {
 }
 
 TEST(SIMD, SIMD_SUFFIX(ScanWriteUnescapedString)) {
-    char buffer[2048 + 1 + 32];
-    for (size_t offset = 0; offset < 32; offset++) {
+    char buffer[2048 + 1 + 64];
+    for (size_t offset = 0; offset < 64; offset++) {
         for (size_t step = 0; step < 1024; step++) {
             char* s = buffer + offset;
             char* p = s;
@@ -214,6 +230,184 @@ TEST(SIMD, SIMD_SUFFIX(ScanWriteUnescapedString)) {
     }
 }
 
+// Well-formed one- to four-byte sequences, with an ill-formed, truncated or special one every step sequences.
+static void FillUtf8Text(char* buffer, size_t length, size_t step) {
+    static const char* const valid[] = { "a", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xEF\xBF\xBF", "\xF4\x8F\xBF\xBF" };
+    static const char* const invalid[] = { "\xFF", "\xC0\xAF", "\x80", "\xED\xA0\x80", "\xE0\x9F\xBF", "\xF4\x90\x80\x80", "\xE2\x82", "\xF0\x9F\x98", "\"", "\\", "\n" };
+    size_t i = 0, n = 0;
+    while (i < length) {
+        const char* s = (step != 0 && n % step == step - 1) ? invalid[(n / step) % 11] : valid[n % 6];
+        for (; *s && i < length; s++)
+            buffer[i++] = *s;
+        n++;
+    }
+    buffer[length] = '\0';
+}
+
+struct ScanCopyValidUnescapedStringHandler : BaseReaderHandler<UTF8<>, ScanCopyValidUnescapedStringHandler> {
+    bool String(const char* str, SizeType length, bool) {
+        s.assign(str, length);
+        return true;
+    }
+    std::string s;
+};
+
+TEST(SIMD, SIMD_SUFFIX(ScanCopyValidUnescapedString)) {
+    char text[256 + 1];
+    char buffer[256 + 8 + 64];
+    for (size_t step = 0; step < 120; step++) {
+        FillUtf8Text(text, 200 - step % 7, step);
+        for (int truncated = 0; truncated < 2; truncated++) {
+            const std::string json = std::string("[\"") + text + (truncated ? "" : "\"]");
+
+            // Reference: per code point validation by Transcoder
+            Reader reader;
+            ScanCopyValidUnescapedStringHandler expected;
+            MemoryStream ms(json.c_str(), json.size());
+            EncodedInputStream<UTF8<>, MemoryStream> es(ms);
+            reader.Parse<kParseValidateEncodingFlag>(es, expected);
+            const ParseErrorCode expectedCode = reader.GetParseErrorCode();
+            const size_t expectedOffset = reader.GetErrorOffset();
+
+            for (size_t offset = 0; offset < 64; offset += 1 + offset / 8) {
+                char* p = buffer + offset;
+                memcpy(p, json.c_str(), json.size() + 1);
+                StringStream s(p);
+                ScanCopyValidUnescapedStringHandler h;
+                reader.Parse<kParseValidateEncodingFlag>(s, h);
+                EXPECT_EQ(expectedCode, reader.GetParseErrorCode());
+                EXPECT_EQ(expectedOffset, reader.GetErrorOffset());
+                EXPECT_EQ(expected.s, h.s);
+
+                InsituStringStream is(p);
+                ScanCopyValidUnescapedStringHandler h2;
+                reader.Parse<kParseValidateEncodingFlag | kParseInsituFlag>(is, h2);
+                EXPECT_EQ(expectedCode, reader.GetParseErrorCode());
+                EXPECT_EQ(expectedOffset, reader.GetErrorOffset());
+                EXPECT_EQ(expected.s, h2.s);
+            }
+        }
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Text that ends at the last byte of a page followed by an inaccessible page:
+// any read past the terminator or the end of a range faults.
+class GuardedPage {
+public:
+    GuardedPage() : size_(static_cast<size_t>(sysconf(_SC_PAGESIZE))), base_() {
+        void* p = mmap(0, size_ * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        EXPECT_NE(MAP_FAILED, p);
+        base_ = static_cast<char*>(p);
+        EXPECT_EQ(0, mprotect(base_ + size_, size_, PROT_NONE));
+    }
+    ~GuardedPage() { munmap(base_, size_ * 2); }
+
+    //! Copy a text of length bytes so that it ends right before the guard page.
+    char* Place(const char* text, size_t length) {
+        char* p = base_ + size_ - length;
+        memcpy(p, text, length);
+        return p;
+    }
+
+private:
+    GuardedPage(const GuardedPage&);
+    GuardedPage& operator=(const GuardedPage&);
+
+    size_t size_;
+    char* base_;
+};
+
+TEST(SIMD, SIMD_SUFFIX(SkipWhitespace_PageBoundary)) {
+    GuardedPage page;
+    for (size_t length = 1; length < 200; length++) {
+        std::string text(length, ' ');
+        for (size_t i = 0; i < length; i++)
+            text[i] = " \t\r\n"[i % 4];
+        text[length - 1] = '\0';
+
+        StringStream s(page.Place(text.c_str(), length));
+        SkipWhitespace(s);
+        EXPECT_EQ('\0', s.Peek());
+        EXPECT_EQ(length - 1, s.Tell());
+
+        InsituStringStream is(page.Place(text.c_str(), length));
+        SkipWhitespace(is);
+        EXPECT_EQ('\0', is.Peek());
+
+        if (length >= 2) {
+            text[length - 2] = 'X';
+            StringStream s2(page.Place(text.c_str(), length));
+            SkipWhitespace(s2);
+            EXPECT_EQ('X', s2.Peek());
+        }
+
+        // Range without terminator
+        text[length - 1] = ' ';
+        if (length >= 2)
+            text[length - 2] = ' ';
+        MemoryStream ms(page.Place(text.c_str(), length), length);
+        EncodedInputStream<UTF8<>, MemoryStream> es(ms);
+        SkipWhitespace(es);
+        EXPECT_EQ('\0', es.Peek());    // MemoryStream returns '\0' at the end
+    }
+}
+
+TEST(SIMD, SIMD_SUFFIX(ScanCopyUnescapedString_PageBoundary)) {
+    GuardedPage page;
+    for (size_t length = 0; length < 200; length++) {
+        for (int escape = 0; escape < 2; escape++) {
+            // "ABCD...\n" or "ABCD...", followed by the terminator at the page end
+            std::string text = "\"";
+            for (size_t i = 0; i < length; i++)
+                text += "ABCD"[i % 4];
+            if (escape && length > 0)
+                text.insert(1 + length / 2, "\\n");
+            text += '\"';
+            std::string expected = text.substr(1, text.size() - 2);
+            if (escape && length > 0)
+                expected.replace(length / 2, 2, "\n");
+
+            StringStream s(page.Place(text.c_str(), text.size() + 1));
+            Reader reader;
+            ScanCopyUnescapedStringHandler h;
+            EXPECT_TRUE(reader.Parse(s, h));
+            EXPECT_EQ(expected, std::string(h.buffer));
+
+            InsituStringStream is(page.Place(text.c_str(), text.size() + 1));
+            ScanCopyUnescapedStringHandler h2;
+            EXPECT_TRUE(reader.Parse<kParseInsituFlag>(is, h2));
+            EXPECT_EQ(expected, std::string(h2.buffer));
+        }
+    }
+}
+
+TEST(SIMD, SIMD_SUFFIX(ScanWriteUnescapedString_PageBoundary)) {
+    GuardedPage page;
+    for (size_t length = 1; length < 200; length++) {
+        std::string text;
+        for (size_t i = 0; i < length; i++)
+            text += "ABCD"[i % 4];
+        for (int escape = 0; escape < 2; escape++) {
+            std::string expected = "\"" + text + "\"";
+            if (escape) {
+                text[length - 1] = '\"';
+                expected = "\"" + text.substr(0, length - 1) + "\\\"\"";
+            }
+
+            // Not null-terminated: the string ends at the guard page
+            const char* str = page.Place(text.c_str(), length);
+            StringBuffer sb;
+            Writer<StringBuffer> writer(sb);
+            EXPECT_TRUE(writer.String(str, SizeType(length)));
+            EXPECT_EQ(expected, std::string(sb.GetString()));
+        }
+    }
+}
+
+#endif // __unix__ || __APPLE__
+
 #ifdef __GNUC__
 RAPIDJSON_DIAG_POP
 #endif
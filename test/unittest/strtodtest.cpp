@@ -127,6 +127,59 @@ TEST(Strtod, CheckApproximationCase) {
     EXPECT_EQ(-1, delta.Compare(hS));
 }
 
+TEST(Strtod, EiselLemire) {
+    double d = 0.0;
+    EXPECT_TRUE(StrtodEiselLemire(1, 0, &d));
+    EXPECT_EQ(1.0, d);
+    EXPECT_TRUE(StrtodEiselLemire(17976931348623157u, 292, &d));
+    EXPECT_EQ(1.7976931348623157e308, d);   // Max double
+    EXPECT_TRUE(StrtodEiselLemire(22250738585072014u, -324, &d));
+    EXPECT_EQ(2.2250738585072014e-308, d);  // Min normal positive double
+    EXPECT_TRUE(StrtodEiselLemire(RAPIDJSON_UINT64_C2(0xFFFFFFFF, 0xFFFFFFFF), 0, &d));
+    EXPECT_EQ(18446744073709551616.0, d);
+
+    EXPECT_FALSE(StrtodEiselLemire(9007199254740993u, 0, &d));   // Halfway between 2^53 and 2^53 + 2
+    EXPECT_FALSE(StrtodEiselLemire(49406564584124654u, -340, &d)); // Subnormal
+    EXPECT_FALSE(StrtodEiselLemire(1, 309, &d));                    // Infinity
+    EXPECT_FALSE(StrtodEiselLemire(1, -349, &d));                   // Beyond the table
+
+    // More than 19 digits
+    EXPECT_TRUE(StrtodEiselLemire("12345678901234567890123", 23, -10, &d));
+    EXPECT_EQ(1234567890123.4567890123, d);
+    EXPECT_FALSE(StrtodEiselLemire("90071992547409930000001", 23, -7, &d)); // Just above halfway
+}
+
+TEST(Strtod, EiselLemireRandom) {
+    uint64_t x = RAPIDJSON_UINT64_C2(0x12345678, 0x9ABCDEF0);
+    unsigned decided = 0;
+    const unsigned kCount = 100000;
+    for (unsigned i = 0; i < kCount; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;   // xorshift64
+        const double expected = Double(x & RAPIDJSON_UINT64_C2(0x7FFFFFFF, 0xFFFFFFFF)).Value();
+        if (!(expected >= 2.2250738585072014e-308 && expected <= 1.7976931348623157e308))
+            continue;
+
+        // Print 1 to 25 significant digits, then parse the digits back
+        char buffer[64];
+        sprintf(buffer, "%.*e", static_cast<int>(i % 25), expected);
+        char decimals[32];
+        int dLen = 0;
+        const char* p = buffer;
+        for (; *p != 'e'; p++)
+            if (*p != '.')
+                decimals[dLen++] = *p;
+        const int dExp = atoi(p + 1) - (dLen - 1);
+        const double value = strtod(buffer, 0);
+
+        double d;
+        if (StrtodEiselLemire(decimals, dLen, dExp, &d)) {
+            EXPECT_EQ(Double(value).Uint64Value(), Double(d).Uint64Value()) << buffer;
+            decided++;
+        }
+    }
+    EXPECT_GT(decided, kCount / 4);
+}
+
 #ifdef __clang__
 RAPIDJSON_DIAG_POP
 #endif
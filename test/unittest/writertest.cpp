@@ -19,6 +19,7 @@
 #include "rapidjson/writer.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/memorybuffer.h"
+#include "rapidjson/filewritestream.h"
 
 #ifdef __clang__
 RAPIDJSON_DIAG_PUSH
@@ -126,6 +127,106 @@ TEST(Writer, ScanWriteUnescapedString) {
     }
 }
 
+// A long string with a character to escape or a non-ASCII one every step characters,
+// written through a writer and escaped by hand.
+template <typename Encoding, typename OutputStream>
+static void TestWriteLongString(OutputStream& os, GenericStringBuffer<Encoding>& expected, size_t step) {
+    static const unsigned special[] = { '\"', '\\', '\n', 0x01, 0xE9, 0x20AC, 0x1F600 };
+    GenericStringBuffer<Encoding> source;
+    expected.Put('\"');
+    for (size_t i = 0; i < 300; i++) {
+        const unsigned c = i % step == step - 1 ? special[(i / step) % 7] : 'a' + static_cast<unsigned>(i % 26);
+        Encoding::Encode(source, c);
+        if (c == '\"' || c == '\\') {
+            expected.Put('\\');
+            expected.Put(static_cast<typename Encoding::Ch>(c));
+        }
+        else if (c == '\n') {
+            expected.Put('\\');
+            expected.Put('n');
+        }
+        else if (c == 0x01) {
+            const char* e = "\\u0001";
+            for (size_t j = 0; e[j]; j++)
+                expected.Put(static_cast<typename Encoding::Ch>(e[j]));
+        }
+        else
+            Encoding::Encode(expected, c);
+    }
+    expected.Put('\"');
+
+    EXPECT_TRUE(os.String(source.GetString(), static_cast<SizeType>(source.GetLength())));
+}
+
+template <typename Encoding, unsigned writeFlags>
+static void TestWriteLongString() {
+    for (size_t step = 1; step < 40; step++) {
+        GenericStringBuffer<Encoding> buffer, expected;
+        Writer<GenericStringBuffer<Encoding>, Encoding, Encoding, CrtAllocator, writeFlags> writer(buffer);
+        TestWriteLongString(writer, expected, step);
+        ASSERT_EQ(expected.GetLength(), buffer.GetLength());
+        EXPECT_EQ(0, memcmp(expected.GetString(), buffer.GetString(), buffer.GetSize()));
+    }
+}
+
+TEST(Writer, ScanWriteUnescapedString_LongString) {
+    TestWriteLongString<UTF8<>, kWriteNoFlags>();
+    TestWriteLongString<UTF8<>, kWriteValidateEncodingFlag>();
+    TestWriteLongString<UTF16<>, kWriteNoFlags>();
+    TestWriteLongString<UTF16<>, kWriteValidateEncodingFlag>();
+    TestWriteLongString<UTF16<uint16_t>, kWriteNoFlags>();
+    TestWriteLongString<UTF16<uint16_t>, kWriteValidateEncodingFlag>();
+    TestWriteLongString<UTF32<>, kWriteNoFlags>();
+    TestWriteLongString<UTF32<>, kWriteValidateEncodingFlag>();
+}
+
+TEST(Writer, ScanWriteUnescapedString_OutputStreams) {
+    for (size_t step = 1; step < 40; step += 3) {
+        MemoryBuffer buffer;
+        Writer<MemoryBuffer> writer(buffer);
+        StringBuffer expected;
+        TestWriteLongString(writer, expected, step);
+        EXPECT_EQ(std::string(expected.GetString(), expected.GetSize()), std::string(buffer.GetBuffer(), buffer.GetSize()));
+
+        // A small buffer is flushed in the middle of a block.
+        FILE* fp = tmpfile();
+        ASSERT_TRUE(fp != 0);
+        char fileBuffer[7];
+        FileWriteStream os(fp, fileBuffer, sizeof(fileBuffer));
+        Writer<FileWriteStream> writer2(os);
+        StringBuffer expected2;
+        TestWriteLongString(writer2, expected2, step);
+        os.Flush();
+        std::string written(expected2.GetSize() + 1, '\0');
+        rewind(fp);
+        written.resize(fread(&written[0], 1, written.size(), fp));
+        fclose(fp);
+        EXPECT_EQ(std::string(expected2.GetString(), expected2.GetSize()), written);
+    }
+}
+
+TEST(Writer, ScanWriteUnescapedString_ValidateEncoding) {
+    for (size_t length = 16; length < 100; length++) {
+        std::string s(length, 'a');
+        s[length - 1] = '\xff';
+        StringBuffer buffer;
+        Writer<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteValidateEncodingFlag> writer(buffer);
+        EXPECT_FALSE(writer.String(s.c_str(), static_cast<SizeType>(length)));
+
+        // A sequence cut by the end of the string.
+        s[length - 1] = '\xC3';
+        StringBuffer buffer2;
+        Writer<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteValidateEncodingFlag> writer2(buffer2);
+        EXPECT_FALSE(writer2.String(s.c_str(), static_cast<SizeType>(length)));
+
+        std::basic_string<UTF16<>::Ch> w(length, 'a');
+        w[length / 2] = 0xD800;     // lone surrogate
+        GenericStringBuffer<UTF16<> > buffer3;
+        Writer<GenericStringBuffer<UTF16<> >, UTF16<>, UTF16<>, CrtAllocator, kWriteValidateEncodingFlag> writer3(buffer3);
+        EXPECT_FALSE(writer3.String(w.c_str(), static_cast<SizeType>(length)));
+    }
+}
+
 TEST(Writer, Double) {
     TEST_ROUNDTRIP("[1.2345,1.2345678,0.123456789012,1234567.8]");
     TEST_ROUNDTRIP("0.0");
@@ -139,6 +240,30 @@ TEST(Writer, Double) {
 
 }
 
+TEST(Writer, ShortestDouble) {
+    StringBuffer buffer;
+    Writer<StringBuffer, UTF8<>, UTF8<>, CrtAllocator, kWriteShortestDoubleFlag> writer(buffer);
+    writer.StartArray();
+    writer.Double(1.830525276903402e208);   // Grisu2: 1.8305252769034022e208
+    writer.Double(2.8662131333270925e162);  // Grisu2: 2.8662131333270926e162
+    writer.Double(-0.0);
+    writer.Double(1234567.8);
+    writer.Double(1e-7);
+    writer.Double(5e-324);
+    writer.EndArray();
+    EXPECT_STREQ("[1.830525276903402e208,2.8662131333270925e162,-0.0,1234567.8,1e-7,5e-324]", buffer.GetString());
+
+    buffer.Clear();
+    writer.Reset(buffer);
+    writer.SetMaxDecimalPlaces(3);
+    writer.StartArray();
+    writer.Double(0.12345);
+    writer.Double(1.23e-4);
+    writer.Double(1.234567890123456e30);
+    writer.EndArray();
+    EXPECT_STREQ("[0.123,0.0,1.234567890123456e30]", buffer.GetString());
+}
+
 // UTF8 -> TargetEncoding -> UTF8
 template <typename TargetEncoding>
 void TestTranscode(const char* json) {